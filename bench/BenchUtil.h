@@ -0,0 +1,104 @@
+// BenchUtil.h - Timing and allocation counting for the core benchmarks
+// Copyright (c) 2025
+//
+// Benchmarks are plain executables (see bench/CMakeLists.txt) that print
+// their results; they are not run by ctest. Build them in Release for
+// meaningful numbers:
+//   cmake -S . -B build-release -DCMAKE_BUILD_TYPE=Release
+//
+// Defining BENCH_COUNT_ALLOCATIONS before including this header replaces
+// the global operator new/delete with counting versions, so do that in
+// exactly one source file of an executable. Counts are per thread: a
+// stand-in server thread doesn't add to the caller's count.
+
+#pragma once
+
+#ifndef BENCHUTIL_H
+#define BENCHUTIL_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+//=============================================================================
+// Allocation counting
+//=============================================================================
+
+inline uint64_t& ThreadAllocations()
+{
+    static thread_local uint64_t count = 0;
+    return count;
+}
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+
+void* operator new(std::size_t size)
+{
+    ThreadAllocations()++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    ThreadAllocations()++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+#endif // BENCH_COUNT_ALLOCATIONS
+
+//=============================================================================
+// Timing
+//=============================================================================
+
+struct BenchResult {
+    double nsPerOp = 0;
+    double allocationsPerOp = 0;
+};
+
+// Run 'op' 'iterations' times after a short warm-up; 'op' gets the
+// iteration index
+template <typename Op>
+BenchResult Measure(uint64_t iterations, Op op)
+{
+    uint64_t warmup = iterations / 10 + 1;
+    for (uint64_t i = 0; i < warmup; i++) {
+        op(i);
+    }
+
+    uint64_t allocations = ThreadAllocations();
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        op(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    BenchResult result;
+    result.nsPerOp = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    result.allocationsPerOp = (double)(ThreadAllocations() - allocations) / iterations;
+    return result;
+}
+
+inline void Report(const char* name, const BenchResult& result)
+{
+    std::printf("  %-40s %12.1f ns/op %10.2f allocs/op\n", name, result.nsPerOp, result.allocationsPerOp);
+}
+
+// Keep the optimizer from dropping a computed value
+template <typename T>
+inline void KeepAlive(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+#endif // BENCHUTIL_H
@@ -0,0 +1,168 @@
+// CodecBench.cpp - Reply decoding: TextCodec vs BinaryCodec
+// Copyright (c) 2025
+//
+// Decode cost and bytes on the wire for each reply type, in both codecs.
+// The replies are built here the way the AddOn writes them: text with the
+// default number formatting of .NET Framework (15 significant digits),
+// binary as the fixed little-endian records of BinaryCodec. History is a
+// 10,000-bar reply of one-minute bars.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+
+#include "WireCodec.h"
+
+#include <cstdarg>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//=============================================================================
+// Replies as the AddOn sends them
+//=============================================================================
+
+static std::string Text(const char* format, ...)
+{
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return std::string(buffer, (size_t)length);
+}
+
+template <typename T>
+static void Put(std::string& record, T value)
+{
+    char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));   // Little-endian host, like BinaryWriter
+    record.append(bytes, sizeof(T));
+}
+
+static std::string Record(BinaryCodec::Tag tag)
+{
+    return std::string(1, (char)tag);
+}
+
+static const int HISTORY_BARS = 10000;
+static const double FIRST_BAR = 46000.0;        // OLE date, days
+static const double ONE_MINUTE = 1.0 / 1440.0;
+
+static double BarOpen(int i) { return 5000.0 + (i % 400) * 0.25; }
+
+static std::string TextHistory()
+{
+    std::string reply = "HISTORY:" + std::to_string(HISTORY_BARS);
+    for (int i = 0; i < HISTORY_BARS; i++) {
+        double open = BarOpen(i);
+        reply += Text("|%.15g,%.15g,%.15g,%.15g,%.15g,%d", FIRST_BAR + i * ONE_MINUTE,
+                      open, open + 1.5, open - 0.75, open + 0.5, 100 + i % 900);
+    }
+    return reply;
+}
+
+static std::string BinaryHistory()
+{
+    std::string reply = Record(BinaryCodec::TAG_HISTORY);
+    Put<int32_t>(reply, HISTORY_BARS);
+    for (int i = 0; i < HISTORY_BARS; i++) {
+        double open = BarOpen(i);
+        Put<double>(reply, FIRST_BAR + i * ONE_MINUTE);
+        Put<float>(reply, (float)open);
+        Put<float>(reply, (float)(open + 1.5));
+        Put<float>(reply, (float)(open - 0.75));
+        Put<float>(reply, (float)(open + 0.5));
+        Put<float>(reply, (float)(100 + i % 900));
+    }
+    return reply;
+}
+
+//=============================================================================
+// Benchmarks
+//=============================================================================
+
+static bool s_ok = true;
+
+template <typename Value, typename Decode>
+static void Compare(const char* type, const std::string& text, const std::string& binary,
+                    Decode textDecode, Decode binaryDecode, uint64_t iterations)
+{
+    char name[64];
+    Value record;
+
+    std::printf("%s: %zu bytes text, %zu bytes binary\n", type, text.size(), binary.size());
+    snprintf(name, sizeof(name), "  %s text", type);
+    Report(name, Measure(iterations, [&](uint64_t) {
+        s_ok &= textDecode(text, record);
+        KeepAlive(record);
+    }));
+    snprintf(name, sizeof(name), "  %s binary", type);
+    Report(name, Measure(iterations, [&](uint64_t) {
+        s_ok &= binaryDecode(binary, record);
+        KeepAlive(record);
+    }));
+}
+
+int main()
+{
+    const uint64_t iterations = 2000000;
+
+    std::string quoteText = Text("PRICE:%.15g:%.15g:%.15g:%.15g", 5012.25, 5012.0, 5012.5, 123456.0);
+    std::string quoteBinary = Record(BinaryCodec::TAG_QUOTE);
+    for (double value : { 5012.25, 5012.0, 5012.5, 123456.0 }) {
+        Put<double>(quoteBinary, value);
+    }
+    Compare<Quote, bool (*)(std::string_view, Quote&)>("quote", quoteText, quoteBinary,
+        TextCodec::DecodeQuote, BinaryCodec::DecodeQuote, iterations);
+
+    std::string accountText = Text("ACCOUNT:%.15g:%.15g:%.15g:%.15g", 100234.56, 400938.24, -1250.5, 312.75);
+    std::string accountBinary = Record(BinaryCodec::TAG_ACCOUNT);
+    for (double value : { 100234.56, 400938.24, -1250.5, 312.75 }) {
+        Put<double>(accountBinary, value);
+    }
+    Compare<AccountRecord, bool (*)(std::string_view, AccountRecord&)>("account", accountText, accountBinary,
+        TextCodec::DecodeAccount, BinaryCodec::DecodeAccount, iterations);
+
+    std::string statusText = Text("ORDERSTATUS:%s:%s:%d:%.15g",
+                                  "8f2c1e9a4b7d4f0e9c3a5b6d7e8f9a0b", "PartFilled", 3, 5012.25);
+    std::string statusBinary = Record(BinaryCodec::TAG_ORDERSTATUS);
+    char state[16] = "PartFilled";
+    statusBinary.append(state, sizeof(state));
+    Put<int32_t>(statusBinary, 3);
+    Put<double>(statusBinary, 5012.25);
+    Compare<OrderStatusRecord, bool (*)(std::string_view, OrderStatusRecord&)>("order status",
+        statusText, statusBinary, TextCodec::DecodeOrderStatus, BinaryCodec::DecodeOrderStatus, iterations);
+
+    std::string positionText = Text("POSITION:%d:%.15g", -2, 5011.875);
+    std::string positionBinary = Record(BinaryCodec::TAG_POSITION);
+    Put<int32_t>(positionBinary, -2);
+    Put<double>(positionBinary, 5011.875);
+    Compare<PositionRecord, bool (*)(std::string_view, PositionRecord&)>("position", positionText, positionBinary,
+        TextCodec::DecodePosition, BinaryCodec::DecodePosition, iterations);
+
+    // History: the whole reply per operation, all bars in range
+    std::string historyText = TextHistory();
+    std::string historyBinary = BinaryHistory();
+    std::vector<T6> ticks(HISTORY_BARS);
+    double tEnd = FIRST_BAR + HISTORY_BARS * ONE_MINUTE;
+    std::printf("history (%d bars): %zu bytes text, %zu bytes binary\n",
+                HISTORY_BARS, historyText.size(), historyBinary.size());
+    Report("  history text", Measure(200, [&](uint64_t) {
+        HistoryResult result;
+        s_ok &= TextCodec::DecodeHistory(historyText, FIRST_BAR, tEnd, ticks.data(), HISTORY_BARS, result) &&
+                result.loaded == HISTORY_BARS;
+        KeepAlive(ticks[HISTORY_BARS - 1]);
+    }));
+    Report("  history binary", Measure(200, [&](uint64_t) {
+        HistoryResult result;
+        s_ok &= BinaryCodec::DecodeHistory(historyBinary, FIRST_BAR, tEnd, ticks.data(), HISTORY_BARS, result) &&
+                result.loaded == HISTORY_BARS;
+        KeepAlive(ticks[HISTORY_BARS - 1]);
+    }));
+
+    if (!s_ok) {
+        std::printf("decode failed\n");
+        return 1;
+    }
+    return 0;
+}
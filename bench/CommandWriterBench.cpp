@@ -0,0 +1,61 @@
+// CommandWriterBench.cpp - Building a PLACEORDER command
+// Copyright (c) 2025
+//
+// The order command as BasicTcpBridge::Command used to build it (an
+// std::ostringstream per order) against CommandWriter, once writing the
+// verb and instrument each time and once starting from the per-asset
+// prefix CommandPrefixes keeps. Only the command is built; nothing is sent.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+
+#include "CommandWriter.h"
+
+#include <sstream>
+#include <string>
+
+static const char* const INSTRUMENT = "MES 03-26";
+
+// Limit price moves per order, like a strategy stepping its entry
+static double LimitPrice(uint64_t i) { return 6047.25 + (double)(i % 64) * 0.25; }
+
+int main()
+{
+    size_t length = 0;
+
+    Report("PLACEORDER ostringstream", Measure(1000000, [&](uint64_t i) {
+        std::ostringstream cmd;
+        cmd << "PLACEORDER:" << "BUY" << ":" << INSTRUMENT << ":" << 2
+            << ":" << "LIMIT" << ":" << LimitPrice(i) << ":" << 0.0;
+        std::string command = cmd.str();
+        length += command.size();
+        KeepAlive(command);
+    }));
+
+    CommandWriter cmd;
+    Report("PLACEORDER CommandWriter", Measure(1000000, [&](uint64_t i) {
+        cmd.Begin("PLACEORDER").Arg("BUY").Arg(INSTRUMENT)
+           .Arg(2).Arg("LIMIT").Arg(LimitPrice(i)).Arg(0.0);
+        length += cmd.View().size();
+        KeepAlive(cmd);
+    }));
+
+    CommandPrefixes prefixes;
+    Report("PLACEORDER CommandWriter + prefix", Measure(1000000, [&](uint64_t i) {
+        cmd.Begin(prefixes.Get(CommandPrefixes::Buy, INSTRUMENT))
+           .Arg(2).Arg("LIMIT").Arg(LimitPrice(i)).Arg(0.0);
+        length += cmd.View().size();
+        KeepAlive(cmd);
+    }));
+
+    // Same command text either way (these prices need no rounding)
+    std::ostringstream old;
+    old << "PLACEORDER:BUY:" << INSTRUMENT << ":2:LIMIT:" << LimitPrice(5) << ":" << 0.0;
+    cmd.Begin(prefixes.Get(CommandPrefixes::Buy, INSTRUMENT)).Arg(2).Arg("LIMIT").Arg(LimitPrice(5)).Arg(0.0);
+    std::printf("  %s\n", std::string(cmd.View()).c_str());
+    if (old.str() != cmd.View() || length == 0) {
+        std::printf("commands differ: %s\n", old.str().c_str());
+        return 1;
+    }
+    return 0;
+}
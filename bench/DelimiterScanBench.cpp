@@ -0,0 +1,131 @@
+// DelimiterScanBench.cpp - Text HISTORY decoding with ScanDelimiters
+// Copyright (c) 2025
+//
+// Multi-megabyte HISTORY replies (100k and 500k one-minute bars). First the
+// delimiter search alone: a loop that tests one character at a time
+// against ScanDelimiters at the level this CPU runs. Then the whole decode:
+// the Tokenizer walk with HistoryBarSchema per bar that BrokerHistory2 used
+// before, against TextCodec::DecodeHistory. Both decoders must produce the
+// same bars.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+#include "HistoryPayload.h"
+
+#include "DelimiterScan.h"
+#include "Tokenizer.h"
+#include "WireCodec.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const size_t BATCH = 1024;   // Offsets per call, as DecodeHistory takes them
+
+// One character at a time, same contract as ScanDelimiters
+static size_t ScanByByte(std::string_view text, size_t from, char first, char second,
+                         uint32_t* positions, size_t capacity, size_t& next)
+{
+    size_t count = 0;
+    size_t i = from;
+    for (; i < text.size() && count < capacity; i++) {
+        if (text[i] == first || text[i] == second) {
+            positions[count++] = (uint32_t)i;
+        }
+    }
+    next = i;
+    return count;
+}
+
+template <typename Scan>
+static size_t CountDelimiters(std::string_view text, Scan scan)
+{
+    uint32_t positions[BATCH];
+    size_t total = 0, from = 0, next = 0;
+    while (from < text.size()) {
+        total += scan(text, from, '|', ',', positions, BATCH, next);
+        KeepAlive(positions[0]);
+        from = next;
+    }
+    return total;
+}
+
+// BrokerHistory2 before ScanDelimiters: bars split on '|', each parsed by
+// the schema, range checks as in TextCodec::DecodeHistory
+static bool TokenizerHistory(std::string_view response, DATE tStart, DATE tEnd,
+                             T6* ticks, int nTicks, HistoryResult& result)
+{
+    result = HistoryResult();
+    Tokenizer bars(response, '|');
+    std::string_view header;
+    bars.Next(header);
+    if (header.compare(0, 8, "HISTORY:") != 0 || ParseInt(header.substr(8), result.barCount) != ParseStatus::Ok) {
+        return false;
+    }
+
+    std::string_view bar;
+    while (result.loaded < nTicks && bars.Next(bar)) {
+        if (bar.empty()) continue;
+        T6& tick = ticks[result.loaded];
+        if (!HistoryBarSchema::Parse(bar, tick)) continue;
+        if (tick.time < tStart) {
+            result.skipped++;
+            continue;
+        }
+        if (tick.time > tEnd) {
+            result.endReached = true;
+            break;
+        }
+        result.loaded++;
+    }
+    return true;
+}
+
+static bool s_ok = true;
+
+static void Run(int bars)
+{
+    std::string reply = HistoryPayload(bars);
+    double mb = reply.size() / 1e6;
+    std::printf("%d bars, %.1f MB\n", bars, mb);
+
+    size_t expected = CountDelimiters(reply, ScanByByte);
+    char name[64];
+    Report("  scan byte by byte", Measure(20, [&](uint64_t) {
+        s_ok &= CountDelimiters(reply, ScanByByte) == expected;
+    }));
+    snprintf(name, sizeof(name), "  scan ScanDelimiters (%s)", DelimiterScanLevel());
+    Report(name, Measure(20, [&](uint64_t) {
+        s_ok &= CountDelimiters(reply, ScanDelimiters) == expected;
+    }));
+
+    // Skip the first tenth, as a backtest starting later would
+    DATE tStart = HISTORY_FIRST_BAR + bars / 10 * HISTORY_BAR_LENGTH;
+    DATE tEnd = HistoryEnd(bars);
+    std::vector<T6> before(bars), after(bars);
+    HistoryResult resultBefore, resultAfter;
+    Report("  decode Tokenizer + HistoryBarSchema", Measure(10, [&](uint64_t) {
+        s_ok &= TokenizerHistory(reply, tStart, tEnd, before.data(), bars, resultBefore);
+        KeepAlive(before[0]);
+    }));
+    Report("  decode TextCodec::DecodeHistory", Measure(10, [&](uint64_t) {
+        s_ok &= TextCodec::DecodeHistory(reply, tStart, tEnd, after.data(), bars, resultAfter);
+        KeepAlive(after[0]);
+    }));
+
+    s_ok &= resultBefore.loaded == resultAfter.loaded && resultBefore.skipped == resultAfter.skipped &&
+            resultBefore.barCount == resultAfter.barCount && resultAfter.loaded > 0;
+    s_ok &= memcmp(before.data(), after.data(), sizeof(T6) * (size_t)resultAfter.loaded) == 0;
+}
+
+int main()
+{
+    Run(100000);
+    Run(500000);
+
+    if (!s_ok) {
+        std::printf("decoders disagree\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+// DepthBookBench.cpp - Order book updates and GET_BOOK copies
+// Copyright (c) 2025
+//
+// Cost per DEPTH line from the DepthGenerator feed (decode plus apply),
+// the row operations alone and a 10-level GET_BOOK copy. Then the rate
+// the plugin has to sustain: a writer paced at 100k updates per second
+// while the Zorro thread copies the book - once on a DepthBook directly,
+// once through QuoteStream's push channel from a stand-in AddOn.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+
+#include "DepthBook.h"
+#include "DepthGenerator.h"
+#include "QuoteStream.h"
+#include "WireCodec.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Stream = BasicQuoteStream<LoopbackTransport>;
+using Clock = std::chrono::steady_clock;
+
+static const char SYMBOL[] = "MES 03-26";
+static const int LEVELS = 10;
+static const int RATE = 100000;              // Updates per second
+static const int PACED_SECONDS = 2;
+
+static bool s_ok = true;
+
+static bool ApplyLine(DepthBook& book, std::string_view line)
+{
+    DepthUpdate update;
+    return DepthUpdateSchema::Parse(line, update) &&
+           book.Apply((BookSide)update.side, (DepthOperation)update.operation, update.position,
+                      (float)update.price, (float)update.volume, update.time);
+}
+
+static std::vector<std::string> FeedLines(int count)
+{
+    DepthGenerator generator(SYMBOL, 5000.0, 0.25, LEVELS);
+    std::vector<std::string> lines;
+    lines.reserve(count);
+    for (int i = 0; i < count; i++) {
+        lines.emplace_back(generator.Next(46000.0 + i * 1e-8));
+    }
+    return lines;
+}
+
+// Best ask above best bid, both sides sorted
+static bool Ordered(const T2* quotes, int count)
+{
+    int asks = 0;
+    while (asks < count && quotes[asks].fVal > 0) asks++;
+    for (int i = 1; i < count; i++) {
+        if (i != asks && quotes[i].fVal <= quotes[i - 1].fVal) return false;
+    }
+    return asks == 0 || asks == count || quotes[0].fVal > -quotes[asks].fVal;
+}
+
+struct PacedResult {
+    double seconds = 0;        // Until the last update was applied
+    long copies = 0;
+    long torn = 0;
+};
+
+// Copy the book until 'done', counting copies that aren't ordered
+template <typename Copy>
+static void CopyUntil(const std::atomic<bool>& done, Copy copy, PacedResult& result)
+{
+    T2 quotes[2 * LEVELS];
+    while (!done) {
+        int count = copy(quotes);
+        result.copies++;
+        if (!Ordered(quotes, count)) result.torn++;
+    }
+}
+
+static void Print(const char* name, const PacedResult& result, size_t updates)
+{
+    std::printf("  %-40s %8.0f updates/s, %ld copies, %ld torn\n", name,
+                updates / result.seconds, result.copies, result.torn);
+}
+
+int main()
+{
+    std::vector<std::string> lines = FeedLines(RATE * PACED_SECONDS);
+
+    // Decode and apply, as the quote stream reader does per line
+    DepthBook book;
+    Report("DEPTH line decode + apply", Measure(lines.size() - 1, [&](uint64_t i) {
+        s_ok &= ApplyLine(book, lines[i % lines.size()]);
+    }));
+
+    book.Clear();
+    for (int i = 0; i < LEVELS; i++) {
+        book.Apply(BookSide::Ask, DepthOperation::Add, i, 5000.25f + i * 0.25f, 10, 0);
+        book.Apply(BookSide::Bid, DepthOperation::Add, i, 5000.0f - i * 0.25f, 10, 0);
+    }
+    Report("update (volume change)", Measure(10000000, [&](uint64_t i) {
+        book.Apply(BookSide::Bid, DepthOperation::Update, (int)(i % LEVELS), 5000.0f - (i % LEVELS) * 0.25f,
+                   (float)(i & 255), 46000.0);
+    }));
+    Report("add + remove at the best level", Measure(10000000, [&](uint64_t) {
+        book.Apply(BookSide::Ask, DepthOperation::Add, 0, 5000.0f, 1, 46000.0);
+        book.Apply(BookSide::Ask, DepthOperation::Remove, 0, 0, 0, 46000.0);
+    }));
+    T2 quotes[2 * LEVELS];
+    Report("GET_BOOK copy, 10 levels per side", Measure(10000000, [&](uint64_t) {
+        s_ok &= book.Top(LEVELS, quotes, 2 * LEVELS) == 2 * LEVELS;
+        KeepAlive(quotes);
+    }));
+
+    std::printf("paced at %d updates/s for %d s, %u core(s)\n", RATE, PACED_SECONDS,
+                std::thread::hardware_concurrency());
+
+    // Writer thread straight into a DepthBook
+    {
+        DepthBook paced;
+        PacedResult result;
+        std::atomic<bool> done(false);
+        std::thread writer([&] {
+            auto start = Clock::now();
+            for (size_t i = 0; i < lines.size(); i++) {
+                std::this_thread::sleep_until(start + std::chrono::nanoseconds(1000000000LL / RATE * i));
+                s_ok &= ApplyLine(paced, lines[i]);
+            }
+            result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            done = true;
+        });
+        CopyUntil(done, [&](T2* copy) { return paced.Top(LEVELS, copy, 2 * LEVELS); }, result);
+        writer.join();
+        Print("DepthBook", result, lines.size());
+        s_ok &= result.torn == 0;
+    }
+
+    // Stand-in AddOn publishing on the push channel; done once the last
+    // update's time shows in the book
+    {
+        LoopbackServer server(9702, [](std::string_view request) {
+            return std::string(request == "STREAM" ? "OK:Streaming" : "ERROR:Unknown command");
+        });
+        Stream stream;
+        s_ok &= stream.Start("127.0.0.1", 9702) && stream.Watch(SYMBOL);
+
+        DepthBook expected;
+        for (const std::string& line : lines) {
+            ApplyLine(expected, line);
+        }
+        T2 last[2 * LEVELS];
+        expected.Top(LEVELS, last, 2 * LEVELS);
+
+        PacedResult result;
+        std::atomic<bool> done(false);
+        auto start = Clock::now();
+        std::thread publisher([&] {
+            for (size_t i = 0; i < lines.size(); i++) {
+                std::this_thread::sleep_until(start + std::chrono::nanoseconds(1000000000LL / RATE * i));
+                server.Publish(lines[i]);
+            }
+        });
+        CopyUntil(done, [&](T2* copy) {
+            int count = stream.Book(SYMBOL, LEVELS, copy, 2 * LEVELS);
+            if (count > 0 && copy[0].time == last[0].time) {
+                result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                done = true;
+            }
+            return count;
+        }, result);
+        publisher.join();
+        Print("QuoteStream push channel", result, lines.size());
+        s_ok &= result.torn == 0;
+        stream.Stop();
+    }
+
+    if (!s_ok) {
+        std::printf("book check failed\n");
+        return 1;
+    }
+    return 0;
+}
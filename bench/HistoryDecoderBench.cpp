@@ -0,0 +1,58 @@
+// HistoryDecoderBench.cpp - Text history decoding, serial vs worker pool
+// Copyright (c) 2025
+//
+// TextCodec::DecodeHistory against HistoryDecoder with one to MAX_WORKERS
+// workers on 100k- and 500k-bar replies. The pool can only help with as
+// many cores as threads; the core count is printed with the results.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+#include "HistoryPayload.h"
+
+#include "HistoryDecoder.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+static bool s_ok = true;
+
+static void Run(int bars)
+{
+    std::string reply = HistoryPayload(bars);
+    DATE tEnd = HistoryEnd(bars);
+    std::vector<T6> serial(bars), pooled(bars);
+    HistoryResult expected;
+
+    std::printf("%d bars, %.1f MB\n", bars, reply.size() / 1e6);
+    Report("  serial DecodeHistory", Measure(10, [&](uint64_t) {
+        s_ok &= TextCodec::DecodeHistory(reply, HISTORY_FIRST_BAR, tEnd, serial.data(), bars, expected);
+        KeepAlive(serial[0]);
+    }));
+
+    for (int workers = 1; workers <= (int)HistoryDecoder::MAX_WORKERS; workers++) {
+        HistoryDecoder decoder(workers);
+        HistoryResult result;
+        char name[64];
+        snprintf(name, sizeof(name), "  HistoryDecoder, %d worker(s)", workers);
+        Report(name, Measure(10, [&](uint64_t) {
+            s_ok &= decoder.Decode(reply, HISTORY_FIRST_BAR, tEnd, pooled.data(), bars, result);
+            KeepAlive(pooled[0]);
+        }));
+        s_ok &= result.loaded == expected.loaded &&
+                memcmp(pooled.data(), serial.data(), sizeof(T6) * (size_t)result.loaded) == 0;
+    }
+}
+
+int main()
+{
+    std::printf("%u core(s)\n", std::thread::hardware_concurrency());
+    Run(100000);
+    Run(500000);
+
+    if (!s_ok) {
+        std::printf("decoders disagree\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+// HistoryPayload.h - Synthetic HISTORY replies for the decode benchmarks
+// Copyright (c) 2025
+//
+// HISTORY:{n}|time,open,high,low,close,volume|... as the AddOn sends it:
+// one-minute bars with OLE dates and prices printed with the 15
+// significant digits of .NET Framework's default double formatting.
+
+#pragma once
+
+#ifndef HISTORYPAYLOAD_H
+#define HISTORYPAYLOAD_H
+
+#include <cstdio>
+#include <string>
+
+static constexpr double HISTORY_FIRST_BAR = 46000.0;          // OLE date, days
+static constexpr double HISTORY_BAR_LENGTH = 1.0 / 1440.0;    // One minute
+
+inline std::string HistoryPayload(int bars)
+{
+    std::string reply = "HISTORY:" + std::to_string(bars);
+    reply.reserve((size_t)bars * 56);
+    char bar[128];
+    for (int i = 0; i < bars; i++) {
+        double open = 5000.0 + (i % 400) * 0.25;
+        int length = snprintf(bar, sizeof(bar), "|%.15g,%.15g,%.15g,%.15g,%.15g,%d",
+                              HISTORY_FIRST_BAR + i * HISTORY_BAR_LENGTH,
+                              open, open + 1.5, open - 0.75, open + 0.5, 100 + i % 900);
+        reply.append(bar, (size_t)length);
+    }
+    return reply;
+}
+
+// Time just past the last bar, for a tEnd that takes every bar
+inline double HistoryEnd(int bars)
+{
+    return HISTORY_FIRST_BAR + bars * HISTORY_BAR_LENGTH;
+}
+
+#endif // HISTORYPAYLOAD_H
@@ -0,0 +1,119 @@
+// NumberParseBench.cpp - Reply numbers: std::stod vs ParseDouble
+// Copyright (c) 2025
+//
+// The history decode loop as it was after the tokenizer change (fields as
+// views, each number copied into a std::string for std::stod, one
+// try/catch per bar) against the same loop with ParseDouble/ParseInt from
+// NumberParser.h, on a 100k-bar reply. Also single fields, including a
+// malformed one, where std::stod throws.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+#include "HistoryPayload.h"
+
+#include "NumberParser.h"
+#include "Tokenizer.h"
+#include "trading.h"
+
+#include <string>
+#include <vector>
+
+static const int BARS = 100000;
+
+static int DecodeWithStod(std::string_view history, T6* ticks)
+{
+    Tokenizer barList(history, '|');
+    std::string_view bar;
+    barList.Next(bar);   // HISTORY:{n}
+    int loaded = 0;
+    while (barList.Next(bar) && loaded < BARS) {
+        Fields<6> fields(bar, ',');
+        if (fields.Size() < 6) continue;
+        try {
+            T6& tick = ticks[loaded];
+            tick.time = std::stod(std::string(fields[0]));
+            tick.fOpen = (float)std::stod(std::string(fields[1]));
+            tick.fHigh = (float)std::stod(std::string(fields[2]));
+            tick.fLow = (float)std::stod(std::string(fields[3]));
+            tick.fClose = (float)std::stod(std::string(fields[4]));
+            tick.fVol = (float)std::stod(std::string(fields[5]));
+            loaded++;
+        }
+        catch (...) {
+            continue;
+        }
+    }
+    return loaded;
+}
+
+static int DecodeWithParseDouble(std::string_view history, T6* ticks)
+{
+    Tokenizer barList(history, '|');
+    std::string_view bar;
+    barList.Next(bar);
+    int loaded = 0;
+    while (barList.Next(bar) && loaded < BARS) {
+        Fields<6> fields(bar, ',');
+        if (fields.Size() < 6) continue;
+        double values[6];
+        bool ok = true;
+        for (size_t i = 0; i < 6 && ok; i++) {
+            ok = ParseDouble(fields[i], values[i]) == ParseStatus::Ok;
+        }
+        if (!ok) continue;
+        T6& tick = ticks[loaded++];
+        tick.time = values[0];
+        tick.fOpen = (float)values[1];
+        tick.fHigh = (float)values[2];
+        tick.fLow = (float)values[3];
+        tick.fClose = (float)values[4];
+        tick.fVol = (float)values[5];
+    }
+    return loaded;
+}
+
+int main()
+{
+    std::string history = HistoryPayload(BARS);
+    std::vector<T6> before(BARS), after(BARS);
+    bool ok = true;
+
+    std::printf("HISTORY reply, %d bars (%.1f MB)\n", BARS, history.size() / 1048576.0);
+    Report("  std::stod", Measure(10, [&](uint64_t) {
+        ok &= DecodeWithStod(history, before.data()) == BARS;
+    }));
+    Report("  ParseDouble", Measure(10, [&](uint64_t) {
+        ok &= DecodeWithParseDouble(history, after.data()) == BARS;
+    }));
+    for (int i = 0; i < BARS && ok; i++) {
+        ok = before[i].time == after[i].time && before[i].fClose == after[i].fClose &&
+             before[i].fVol == after[i].fVol;
+    }
+    if (!ok) {
+        std::printf("results differ\n");
+        return 1;
+    }
+
+    for (std::string field : { "5012.25", "46000.0006944444", "5.01225E+03", "n/a" }) {
+        std::printf("field \"%s\"\n", field.c_str());
+        double value = 0;
+        Report("  std::stod", Measure(1000000, [&](uint64_t) {
+            KeepAlive(field);
+            try {
+                value = std::stod(field);
+            }
+            catch (...) {
+                value = 0;
+            }
+            KeepAlive(value);
+        }));
+        Report("  ParseDouble", Measure(1000000, [&](uint64_t) {
+            KeepAlive(field);
+            if (ParseDouble(field, value) != ParseStatus::Ok) {
+                value = 0;
+            }
+            KeepAlive(value);
+        }));
+    }
+    return 0;
+}
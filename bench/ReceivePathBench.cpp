@@ -0,0 +1,144 @@
+// ReceivePathBench.cpp - Command round trips: per-call buffers vs RecvBuffer
+// Copyright (c) 2025
+//
+// GETPRICE round trips against a stand-in AddOn on loopback TCP. The
+// "per-call" variant is the original SendCommand receive path (1 MB heap
+// buffer and string concatenation per call); the channel variants use the
+// connection-owned RecvBuffer, in newline and in length-prefixed mode.
+// Allocations are counted on the calling thread only.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+#include "TcpStandIn.h"
+
+#include "BridgeChannel.h"
+
+#include <string>
+
+static const char PRICE_REPLY[] = "PRICE:5012.25:5012.00:5012.50:123456";
+
+static std::string Answer(std::string_view request)
+{
+    if (request == "PING") return "PONG";
+    if (request.compare(0, 9, "GETPRICE:") == 0) return PRICE_REPLY;
+    return "ERROR:Unknown command";
+}
+
+// The receive path SendCommand had before RecvBuffer
+class PerCallClient
+{
+public:
+    bool Connect(int port)
+    {
+        m_fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        return connect(m_fd, (sockaddr*)&address, sizeof(address)) == 0;
+    }
+
+    ~PerCallClient() { if (m_fd >= 0) close(m_fd); }
+
+    std::string SendCommand(const std::string& command)
+    {
+        std::string fullCommand = command + "\n";
+        if (send(m_fd, fullCommand.c_str(), fullCommand.length(), MSG_NOSIGNAL) <= 0) {
+            return "ERROR:Send failed";
+        }
+
+        const int BUFFER_SIZE = 1048576;
+        std::string response;
+        char* buffer = new char[BUFFER_SIZE];
+        bool hasMoreData = true;
+        while (hasMoreData) {
+            int received = (int)recv(m_fd, buffer, BUFFER_SIZE - 1, 0);
+            if (received <= 0) {
+                delete[] buffer;
+                return "ERROR:Receive failed";
+            }
+            buffer[received] = '\0';
+            response += std::string(buffer);
+            if (received < (BUFFER_SIZE - 1) || response.back() == '\n') {
+                hasMoreData = false;
+            }
+        }
+        delete[] buffer;
+
+        m_lastResponse = response;
+        if (!m_lastResponse.empty() && m_lastResponse.back() == '\n') {
+            m_lastResponse.pop_back();
+        }
+        return m_lastResponse;
+    }
+
+private:
+    int m_fd = -1;
+    std::string m_lastResponse;
+};
+
+int main()
+{
+    const uint64_t iterations = 50000;
+    std::printf("GETPRICE round trips over loopback TCP (%llu each)\n", (unsigned long long)iterations);
+
+    {
+        TcpStandIn server(Answer);
+        PerCallClient client;
+        if (!client.Connect(server.Port())) {
+            std::printf("connect failed\n");
+            return 1;
+        }
+        std::string command = "GETPRICE:ES 03-26";
+        Report("per-call 1 MB buffer", Measure(iterations, [&](uint64_t) {
+            std::string reply = client.SendCommand(command);
+            KeepAlive(reply);
+        }));
+    }
+
+    for (bool framing : { false, true }) {
+        TcpStandIn server(Answer, framing);
+        BasicBridgeChannel<DefaultTransport> channel;
+        if (!channel.Open("127.0.0.1", server.Port(), Codec::Text, false) || channel.IsFramed() != framing) {
+            std::printf("channel open failed\n");
+            return 1;
+        }
+        bool ok = true;
+        Report(framing ? "RecvBuffer, length-prefixed" : "RecvBuffer, newline", Measure(iterations, [&](uint64_t) {
+            std::string_view reply = channel.SendCommand("GETPRICE:ES 03-26");
+            ok &= reply == PRICE_REPLY;
+        }));
+        if (!ok) {
+            std::printf("unexpected reply\n");
+            return 1;
+        }
+    }
+
+    // The receive step alone, without the socket: a reply already read
+    {
+        std::string wire = std::string(PRICE_REPLY) + "\n";
+        Report("receive step: per-call buffer + copies", Measure(1000000, [&](uint64_t) {
+            char* buffer = new char[1048576];
+            memcpy(buffer, wire.data(), wire.size());
+            buffer[wire.size()] = '\0';
+            std::string response;
+            response += std::string(buffer);
+            delete[] buffer;
+            std::string last = response;
+            last.pop_back();
+            KeepAlive(last);
+        }));
+
+        RecvBuffer buffer;
+        Report("receive step: RecvBuffer", Measure(1000000, [&](uint64_t) {
+            buffer.Compact();
+            memcpy(buffer.WritePtr(), wire.data(), wire.size());
+            buffer.Commit(wire.size());
+            std::string_view line;
+            buffer.NextLine(line);
+            KeepAlive(line);
+        }));
+    }
+
+    return 0;
+}
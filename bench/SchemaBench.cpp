@@ -0,0 +1,165 @@
+// SchemaBench.cpp - Text reply parsers: hand-written vs ReplySchema
+// Copyright (c) 2025
+//
+// The hand-written parsers are the ones TextCodec had before ReplySchema.h
+// (Fields<N> split, index and size checks, NumberParser conversions);
+// the schema versions are today's TextCodec::Decode*. Both see the same
+// replies. The dispatch case decodes a mix of tagged replies: an if-chain
+// on the tag against ReplyDispatcher's perfect hash.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+
+#include "NumberParser.h"
+#include "Tokenizer.h"
+#include "WireCodec.h"
+
+#include <cstdio>
+#include <string>
+
+//=============================================================================
+// Hand-written parsers (before ReplySchema)
+//=============================================================================
+
+static bool HandQuote(std::string_view response, Quote& quote)
+{
+    Fields<5> parts(response, ':');
+    if (parts.Size() < 5 || parts[0] != "PRICE") {
+        return false;
+    }
+    return ParseDouble(parts[1], quote.last) == ParseStatus::Ok &&
+           ParseDouble(parts[2], quote.bid) == ParseStatus::Ok &&
+           ParseDouble(parts[3], quote.ask) == ParseStatus::Ok &&
+           ParseDouble(parts[4], quote.volume) == ParseStatus::Ok;
+}
+
+static bool HandAccount(std::string_view response, AccountRecord& account)
+{
+    Fields<5> parts(response, ':');
+    if (parts.Size() < 4 || parts[0] != "ACCOUNT") {
+        return false;
+    }
+    account.unrealizedPnL = 0.0;
+    return ParseDouble(parts[1], account.cashValue) == ParseStatus::Ok &&
+           ParseDouble(parts[2], account.buyingPower) == ParseStatus::Ok &&
+           ParseDouble(parts[3], account.realizedPnL) == ParseStatus::Ok &&
+           (parts.Size() < 5 || ParseDouble(parts[4], account.unrealizedPnL) == ParseStatus::Ok);
+}
+
+static bool HandOrderStatus(std::string_view response, OrderStatusRecord& status)
+{
+    Fields<5> parts(response, ':');
+    if (parts.Size() < 3 || parts[0] != "ORDERSTATUS") {
+        return false;
+    }
+    snprintf(status.state, sizeof(status.state), "%.*s", (int)parts[2].size(), parts[2].data());
+    status.filled = 0;
+    status.avgFillPrice = 0.0;
+    return (parts.Size() < 4 || ParseInt(parts[3], status.filled) == ParseStatus::Ok) &&
+           (parts.Size() < 5 || ParseDouble(parts[4], status.avgFillPrice) == ParseStatus::Ok);
+}
+
+static bool HandPosition(std::string_view response, PositionRecord& position)
+{
+    Fields<3> parts(response, ':');
+    if (parts.Size() < 3 || parts[0] != "POSITION") {
+        return false;
+    }
+    return ParseInt(parts[1], position.quantity) == ParseStatus::Ok &&
+           ParseDouble(parts[2], position.avgPrice) == ParseStatus::Ok;
+}
+
+// Tag picked by comparing prefixes one after the other
+static bool HandDispatch(std::string_view response, double& sum)
+{
+    auto starts = [response](std::string_view tag) { return response.compare(0, tag.size(), tag) == 0; };
+    if (starts("PRICE:")) {
+        Quote quote;
+        if (!HandQuote(response, quote)) return false;
+        sum += quote.last;
+    } else if (starts("ACCOUNT:")) {
+        AccountRecord account;
+        if (!HandAccount(response, account)) return false;
+        sum += account.cashValue;
+    } else if (starts("ORDERSTATUS:")) {
+        OrderStatusRecord status;
+        if (!HandOrderStatus(response, status)) return false;
+        sum += status.filled;
+    } else if (starts("POSITION:")) {
+        PositionRecord position;
+        if (!HandPosition(response, position)) return false;
+        sum += position.quantity;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+struct Sum
+{
+    double& sum;
+    void operator()(const Quote& quote) const { sum += quote.last; }
+    void operator()(const AccountRecord& account) const { sum += account.cashValue; }
+    void operator()(const OrderStatusRecord& status) const { sum += status.filled; }
+    void operator()(const PositionRecord& position) const { sum += position.quantity; }
+};
+
+//=============================================================================
+// Benchmarks
+//=============================================================================
+
+static bool s_ok = true;
+
+template <typename Record>
+static void Compare(const char* type, std::string reply,
+                    bool (*hand)(std::string_view, Record&), bool (*schema)(std::string_view, Record&))
+{
+    char name[64];
+    Record record;
+
+    std::printf("%s\n", reply.c_str());
+    snprintf(name, sizeof(name), "  hand-written %s", type);
+    Report(name, Measure(2000000, [&](uint64_t) {
+        KeepAlive(reply);
+        s_ok &= hand(reply, record);
+        KeepAlive(record);
+    }));
+    snprintf(name, sizeof(name), "  schema %s", type);
+    Report(name, Measure(2000000, [&](uint64_t) {
+        KeepAlive(reply);
+        s_ok &= schema(reply, record);
+        KeepAlive(record);
+    }));
+}
+
+int main()
+{
+    Compare<Quote>("quote", "PRICE:5012.25:5012:5012.5:123456", HandQuote, TextCodec::DecodeQuote);
+    Compare<AccountRecord>("account", "ACCOUNT:100234.56:400938.24:-1250.5:312.75",
+                           HandAccount, TextCodec::DecodeAccount);
+    Compare<OrderStatusRecord>("order status", "ORDERSTATUS:8f2c1e9a4b7d:PartFilled:3:5012.25",
+                               HandOrderStatus, TextCodec::DecodeOrderStatus);
+    Compare<PositionRecord>("position", "POSITION:-2:5011.875", HandPosition, TextCodec::DecodePosition);
+
+    // Mixed replies, tag unknown to the caller
+    const std::string mix[] = {
+        "PRICE:5012.25:5012:5012.5:123456",
+        "ACCOUNT:100234.56:400938.24:-1250.5:312.75",
+        "ORDERSTATUS:8f2c1e9a4b7d:PartFilled:3:5012.25",
+        "POSITION:-2:5011.875"
+    };
+    double handSum = 0, schemaSum = 0;
+    std::printf("mixed tagged replies\n");
+    Report("  if-chain on tag", Measure(4000000, [&](uint64_t i) {
+        s_ok &= HandDispatch(mix[i % 4], handSum);
+    }));
+    Report("  ReplyDispatcher", Measure(4000000, [&](uint64_t i) {
+        s_ok &= TextCodec::Decode(mix[i % 4], Sum{ schemaSum });
+    }));
+
+    if (!s_ok || handSum != schemaSum) {
+        std::printf("parsers disagree\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// SharedMemoryBench.cpp - Round trips over shared memory vs loopback TCP
+// Copyright (c) 2025
+//
+// The same channel against the same stand-in AddOn, once on loopback TCP
+// (length-prefixed) and once with requests and replies moved into the
+// shared-memory rings (the TCP connection stays open for the handshake
+// and liveness checks). Small GETPRICE round trips and a 10,000-bar-sized
+// (500 KB) reply.
+
+#include "BenchUtil.h"
+#include "ShmStandIn.h"
+#include "TcpStandIn.h"
+
+#include "BridgeChannel.h"
+
+#include <string>
+
+static const char PRICE_REPLY[] = "PRICE:5012.25:5012.00:5012.50:123456";
+static const size_t HISTORY_SIZE = 500 * 1024;
+
+static std::string Answer(std::string_view request)
+{
+    if (request == "PING") return "PONG";
+    if (request.compare(0, 9, "GETPRICE:") == 0) return PRICE_REPLY;
+    if (request.compare(0, 11, "GETHISTORY:") == 0) return std::string(HISTORY_SIZE, '1');
+    return "ERROR:Unknown command";
+}
+
+static bool Run(const char* transport, BasicBridgeChannel<DefaultTransport>& channel)
+{
+    char name[64];
+    bool ok = true;
+
+    snprintf(name, sizeof(name), "GETPRICE, %s", transport);
+    Report(name, Measure(100000, [&](uint64_t) {
+        ok &= channel.SendCommand("GETPRICE:ES 03-26") == PRICE_REPLY;
+    }));
+
+    snprintf(name, sizeof(name), "500 KB reply, %s", transport);
+    Report(name, Measure(2000, [&](uint64_t) {
+        ok &= channel.SendCommand("GETHISTORY:ES 03-26:0:0:1:10000").size() == HISTORY_SIZE;
+    }));
+    return ok;
+}
+
+int main()
+{
+    ShmStandIn peer(Answer);
+    TcpStandIn server([&](std::string_view request) -> std::string {
+        if (request == "SHM:OPEN") return std::string("OK:SHM:") + peer.Name();
+        return Answer(request);
+    });
+
+    BasicBridgeChannel<DefaultTransport> tcp, shm;
+    if (!peer.IsOpen() ||
+        !tcp.Open("127.0.0.1", server.Port(), Codec::Text, false) ||
+        !shm.Open("127.0.0.1", server.Port(), Codec::Text, true) || !shm.IsSharedMemory()) {
+        std::printf("setup failed\n");
+        return 1;
+    }
+
+    if (!Run("loopback TCP", tcp) || !Run("shared memory", shm)) {
+        std::printf("unexpected reply\n");
+        return 1;
+    }
+    return 0;
+}
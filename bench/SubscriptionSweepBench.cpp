@@ -0,0 +1,142 @@
+// SubscriptionSweepBench.cpp - One BrokerAsset price sweep over 50 assets
+// Copyright (c) 2025
+//
+// The per-asset steps of BrokerAsset, against a stand-in AddOn on loopback
+// TCP with a push channel. The old logic re-sent SUBSCRIBE and slept
+// 100 ms whenever the asset changed, which in a portfolio is every call.
+// With the registry an asset is subscribed once; later sweeps read the
+// streamed quote (or poll GETPRICE without a stream). With an asset limit
+// below the portfolio size every asset is evicted before its next turn,
+// so each call pays UNSUBSCRIBE, SUBSCRIBE and a re-watched quote slot.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+
+#include "SubscriptionRegistry.h"
+#include "TcpBridge.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Bridge = BasicTcpBridge<LoopbackTransport, TextCodec>;
+using Clock = std::chrono::steady_clock;
+
+static const int ASSETS = 50;
+
+static std::string Answer(std::string_view request)
+{
+    if (request == "PING") return "PONG";
+    if (request == "STREAM") return "OK:Streaming";
+    if (request == "CONNECTED") return "CONNECTED:1";
+    if (request.compare(0, 10, "SUBSCRIBE:") == 0) return "OK:Subscribed:" + std::string(request.substr(10)) + ":0.25:5";
+    if (request.compare(0, 12, "UNSUBSCRIBE:") == 0) return "OK:Unsubscribed";
+    if (request.compare(0, 9, "GETPRICE:") == 0) return "PRICE:5012.25:5012:5012.5:123456";
+    return "ERROR:Unknown command";
+}
+
+static std::vector<std::string> Symbols()
+{
+    std::vector<std::string> symbols;
+    for (int i = 0; i < ASSETS; i++) {
+        symbols.push_back("SYM" + std::to_string(i) + " 03-26");
+    }
+    return symbols;
+}
+
+static bool s_ok = true;
+
+// BrokerAsset before the registry: subscribe and wait on every switch
+static void OldSweep(Bridge& bridge, const std::vector<std::string>& symbols)
+{
+    for (const std::string& symbol : symbols) {
+        s_ok &= bridge.SubscribeMarketData(symbol.c_str()) == 0;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        Quote quote;
+        s_ok &= bridge.GetQuote(symbol.c_str(), quote);
+    }
+}
+
+// BrokerAsset with the registry (see NT8Plugin.cpp): SUBSCRIBE only for
+// unknown assets, evicted ones released
+static void Sweep(Bridge& bridge, SubscriptionRegistry& registry, const std::vector<std::string>& symbols)
+{
+    for (const std::string& symbol : symbols) {
+        if (!registry.Use(symbol)) {
+            s_ok &= bridge.SubscribeMarketData(symbol.c_str()) == 0;
+            bridge.WatchQuotes(symbol.c_str());
+            std::vector<std::string> evicted;
+            registry.Add(symbol, AssetSpec(), evicted);
+            for (const std::string& old : evicted) {
+                bridge.UnSubscribeMarketData(old.c_str());
+                bridge.UnwatchQuotes(old.c_str());
+            }
+        }
+        Quote quote;
+        s_ok &= bridge.GetQuote(symbol.c_str(), quote);
+    }
+}
+
+static double ElapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main()
+{
+    LoopbackServer server(9701, Answer);
+    std::vector<std::string> symbols = Symbols();
+
+    Bridge bridge;
+    if (!bridge.Connect("127.0.0.1", 9701) || !bridge.IsStreaming()) {
+        std::printf("no connection\n");
+        return 1;
+    }
+
+    std::printf("%d assets per sweep\n", ASSETS);
+    auto start = Clock::now();
+    OldSweep(bridge, symbols);
+    std::printf("  %-40s %12.1f ms/sweep\n", "old: SUBSCRIBE + Sleep(100) per asset", ElapsedMs(start));
+
+    SubscriptionRegistry registry;
+    start = Clock::now();
+    Sweep(bridge, registry, symbols);
+    std::printf("  %-40s %12.2f ms/sweep\n", "registry, first sweep", ElapsedMs(start));
+
+    // No quote pushed yet: every asset is polled
+    Report("registry, later sweeps, GETPRICE", Measure(200, [&](uint64_t) {
+        Sweep(bridge, registry, symbols);
+    }));
+
+    // One pushed quote per asset: no I/O at all
+    for (const std::string& symbol : symbols) {
+        server.Publish("QUOTE:" + symbol + ":5012.25:5012:5012.5:123456:46000");
+    }
+    Quote quote;
+    while (!bridge.StreamedQuote(symbols.back().c_str(), quote)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    Report("registry, later sweeps, streamed", Measure(2000, [&](uint64_t) {
+        Sweep(bridge, registry, symbols);
+    }));
+
+    // Asset limit 40: the sweep order is least recently used first, so
+    // every call evicts the asset needed ten calls later
+    std::vector<std::string> evicted;
+    registry.SetCapacity(40, evicted);
+    for (const std::string& old : evicted) {
+        bridge.UnSubscribeMarketData(old.c_str());
+        bridge.UnwatchQuotes(old.c_str());
+    }
+    Report("registry, limit 40 (every asset evicted)", Measure(100, [&](uint64_t) {
+        Sweep(bridge, registry, symbols);
+    }));
+
+    bridge.Disconnect();
+    if (!s_ok) {
+        std::printf("sweep failed\n");
+        return 1;
+    }
+    return 0;
+}
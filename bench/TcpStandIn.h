@@ -0,0 +1,193 @@
+// TcpStandIn.h - Stand-in AddOn on a loopback TCP socket
+// Copyright (c) 2025
+//
+// Serves the bridge protocol on 127.0.0.1 (ephemeral port) the way the
+// AddOn does: one thread per connection, newline-terminated requests,
+// replies newline-terminated or - after VERSION:FRAMED, answered here -
+// length-prefixed. Every other request line goes to the handler, which
+// runs on the connection's thread. For benchmarks that need the real
+// socket path (LoopbackServer answers in-process, without syscalls).
+
+#pragma once
+
+#ifndef TCPSTANDIN_H
+#define TCPSTANDIN_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+//=============================================================================
+// TcpStandIn class - Threaded loopback server with a request handler
+//=============================================================================
+
+class TcpStandIn
+{
+public:
+    using Handler = std::function<std::string(std::string_view request)>;
+
+    // 'framing': acknowledge VERSION:FRAMED (else answer VERSION:1.0)
+    explicit TcpStandIn(Handler handler, bool framing = true)
+        : m_handler(std::move(handler))
+        , m_framing(framing)
+        , m_listen(-1)
+        , m_port(0)
+        , m_stopping(false)
+    {
+        m_listen = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(m_listen, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+        if (bind(m_listen, (sockaddr*)&address, sizeof(address)) != 0 || listen(m_listen, 16) != 0 ||
+            getsockname(m_listen, (sockaddr*)&address, &length) != 0) {
+            close(m_listen);
+            m_listen = -1;
+            return;
+        }
+        m_port = ntohs(address.sin_port);
+        m_acceptor = std::thread(&TcpStandIn::AcceptLoop, this);
+    }
+
+    ~TcpStandIn()
+    {
+        m_stopping = true;
+        if (m_listen >= 0) {
+            shutdown(m_listen, SHUT_RDWR);
+        }
+        if (m_acceptor.joinable()) {
+            m_acceptor.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (int fd : m_clients) {
+                shutdown(fd, SHUT_RDWR);
+            }
+        }
+        for (std::thread& connection : m_connections) {
+            connection.join();
+        }
+        if (m_listen >= 0) {
+            close(m_listen);
+        }
+    }
+
+    TcpStandIn(const TcpStandIn&) = delete;
+    TcpStandIn& operator=(const TcpStandIn&) = delete;
+
+    int Port() const { return m_port; }   // 0 if the socket couldn't be set up
+
+private:
+    Handler m_handler;
+    bool m_framing;
+    int m_listen;
+    int m_port;
+    std::atomic<bool> m_stopping;
+    std::thread m_acceptor;
+    std::mutex m_mutex;
+    std::vector<int> m_clients;
+    std::vector<std::thread> m_connections;   // Acceptor thread only, joined in the destructor
+
+    void AcceptLoop()
+    {
+        while (!m_stopping) {
+            int fd = accept(m_listen, nullptr, nullptr);
+            if (fd < 0) {
+                break;
+            }
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_clients.push_back(fd);
+            m_connections.emplace_back(&TcpStandIn::Serve, this, fd);
+        }
+    }
+
+    static bool WriteAll(int fd, const char* data, size_t length)
+    {
+        while (length > 0) {
+            ssize_t sent = send(fd, data, length, MSG_NOSIGNAL);
+            if (sent <= 0) {
+                return false;
+            }
+            data += sent;
+            length -= (size_t)sent;
+        }
+        return true;
+    }
+
+    void Serve(int fd)
+    {
+        std::string input, output;
+        char buffer[64 * 1024];
+        bool framed = false;
+
+        for (;;) {
+            ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                break;
+            }
+            input.append(buffer, (size_t)received);
+
+            // Answer every complete line; pipelined replies go out together
+            output.clear();
+            size_t start = 0, newline;
+            while ((newline = input.find('\n', start)) != std::string::npos) {
+                std::string_view request(input.data() + start, newline - start);
+                if (!request.empty() && request.back() == '\r') {
+                    request.remove_suffix(1);
+                }
+                start = newline + 1;
+
+                if (request == "VERSION:FRAMED") {
+                    output += m_framing ? "VERSION:1.1:FRAMED\n" : "VERSION:1.0\n";
+                    framed = m_framing;
+                    continue;
+                }
+
+                std::string reply = m_handler(request);
+                if (framed) {
+                    uint32_t length = (uint32_t)reply.size();
+                    char header[4] = { (char)length, (char)(length >> 8), (char)(length >> 16), (char)(length >> 24) };
+                    output.append(header, sizeof(header));
+                    output += reply;
+                } else {
+                    output += reply;
+                    output += '\n';
+                }
+            }
+            input.erase(0, start);
+
+            if (!output.empty() && !WriteAll(fd, output.data(), output.size())) {
+                break;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i = 0; i < m_clients.size(); i++) {
+            if (m_clients[i] == fd) {
+                m_clients.erase(m_clients.begin() + i);
+                break;
+            }
+        }
+        close(fd);
+    }
+};
+
+#endif // TCPSTANDIN_H
@@ -0,0 +1,81 @@
+// TokenizerBench.cpp - Reply splitting: SplitResponse vs Tokenizer/Fields
+// Copyright (c) 2025
+//
+// Field splitting alone (numbers are not converted - see NumberParseBench),
+// with the allocations it costs. "SplitResponse" is the helper the parsers
+// used before Tokenizer.h: a std::stringstream copy of the reply and a
+// std::vector<std::string> of its fields, called once for the reply and
+// again for every history bar.
+
+#define BENCH_COUNT_ALLOCATIONS
+#include "BenchUtil.h"
+#include "HistoryPayload.h"
+
+#include "Tokenizer.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> SplitResponse(std::string_view response, char delimiter)
+{
+    std::vector<std::string> parts;
+    std::stringstream ss{std::string(response)};
+    std::string item;
+
+    while (std::getline(ss, item, delimiter)) {
+        parts.push_back(item);
+    }
+
+    return parts;
+}
+
+static const char PRICE_REPLY[] = "PRICE:5012.25:5012:5012.5:123456";
+
+int main()
+{
+    size_t fields = 0;
+    std::string price = PRICE_REPLY;
+
+    std::printf("PRICE reply (%zu bytes)\n", price.size());
+    Report("  SplitResponse", Measure(1000000, [&](uint64_t) {
+        KeepAlive(price);   // Don't let the split of a constant be hoisted
+        auto parts = SplitResponse(price, ':');
+        fields += parts.size() >= 5 && parts[0] == "PRICE" ? parts.size() : 0;
+    }));
+    Report("  Fields<5>", Measure(1000000, [&](uint64_t) {
+        KeepAlive(price);
+        Fields<5> parts(price, ':');
+        fields += parts.Size() >= 5 && parts[0] == "PRICE" ? parts.Size() : 0;
+    }));
+
+    for (int bars : { 10000, 100000 }) {
+        std::string history = HistoryPayload(bars);
+        std::printf("HISTORY reply, %d bars (%.1f MB)\n", bars, history.size() / 1048576.0);
+
+        size_t before = 0, after = 0;
+        Report("  SplitResponse per reply and bar", Measure(20, [&](uint64_t) {
+            auto parts = SplitResponse(history, '|');
+            for (size_t i = 1; i < parts.size(); i++) {
+                auto barFields = SplitResponse(parts[i], ',');
+                before += barFields.size();
+            }
+        }));
+        Report("  Tokenizer + Fields<6>", Measure(20, [&](uint64_t) {
+            Tokenizer barList(history, '|');
+            std::string_view bar;
+            barList.Next(bar);   // HISTORY:{n}
+            while (barList.Next(bar)) {
+                Fields<6> barFields(bar, ',');
+                after += barFields.Size();
+            }
+        }));
+        if (before != after) {
+            std::printf("field counts differ\n");
+            return 1;
+        }
+    }
+
+    KeepAlive(fields);
+    return 0;
+}
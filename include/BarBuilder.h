@@ -0,0 +1,94 @@
+// BarBuilder.h - Real-time OHLCV bars from the observed quote stream
+// Copyright (c) 2025
+//
+// Aggregates every quote pushed by the AddOn (QuoteStream.h) into bars of
+// the configured periods (SET_BARPERIOD), per asset. Polled quotes are only
+// samples that miss the highs and lows between polls, so they are not fed
+// here and BrokerHistory2 uses the bars only while the push channel runs.
+// Bars are aligned to multiples of the period since midnight UTC and
+// stamped with their end time, like the bars of GETHISTORY.
+//
+// The first bar of a series is only partly seen and is discarded; from
+// the bar after it on, the series is complete ("covered") for as long as
+// quotes keep arriving. A gap of more than MAX_GAP_SECONDS between quotes
+// (disconnect, Zorro stopped) restarts the series; the plugin Clear()s all
+// series where pushed updates were lost. BrokerHistory2 serves
+// requests inside the covered window from here, and fetches only the part
+// before it from the AddOn.
+
+#pragma once
+
+#ifndef BARBUILDER_H
+#define BARBUILDER_H
+
+#include <deque>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "trading.h"        // DATE, T6
+
+//=============================================================================
+// BarBuilder class - Incremental OHLCV aggregation per asset and period
+//=============================================================================
+
+class BarBuilder
+{
+public:
+    static constexpr int MAX_PERIODS = 8;
+    static constexpr size_t MAX_BARS = 10000;       // Per series; ~1 week of M1 bars
+    static constexpr int MAX_GAP_SECONDS = 60;
+
+    BarBuilder();
+
+    // Build bars of 'minutes' length (1..1440). Returns false if the
+    // period is invalid or MAX_PERIODS are configured.
+    bool AddPeriod(int minutes);
+    void ClearPeriods();
+    bool HasPeriod(int minutes) const;
+
+    // One observed quote: 'price' is the bar price (last trade, or ask),
+    // 'volume' the cumulative daily volume. Quotes older than the series'
+    // current bar are ignored.
+    void Update(std::string_view symbol, DATE time, double price, double volume);
+
+    // End time of the first complete bar of the series, 0 if the series
+    // holds no complete bar or has seen no quote for MAX_GAP_SECONDS
+    DATE CoveredFrom(std::string_view symbol, int minutes, DATE now) const;
+
+    // Complete bars with tStart <= time <= tEnd, oldest first, at most
+    // nTicks. The current bar counts as complete once 'now' is past its end.
+    int Copy(std::string_view symbol, int minutes, DATE tStart, DATE tEnd, DATE now,
+             T6* ticks, int nTicks) const;
+
+    // Append the complete bars behind 'loaded' bars fetched from the AddOn
+    // (oldest first), up to nTicks in all. Returns the new count. A bar
+    // both have - same timestamp - is kept from the AddOn.
+    int Merge(std::string_view symbol, int minutes, DATE tStart, DATE tEnd, DATE now,
+              T6* ticks, int loaded, int nTicks) const;
+
+    // Drop all bars; the configured periods stay
+    void Clear() { m_assets.clear(); }
+
+private:
+    struct Series {
+        int minutes = 0;
+        std::deque<T6> bars;          // Complete bars, oldest first
+        T6 current = T6();            // Bar being built
+        long long bucket = -1;        // Its index (end time = (bucket + 1) * period)
+        bool partial = true;          // Current bar started mid-period
+        DATE coveredFrom = 0;
+        DATE lastUpdate = 0;
+        double lastVolume = 0;
+    };
+
+    std::vector<int> m_periods;
+    std::map<std::string, std::vector<Series>, std::less<>> m_assets;   // Symbol -> one series per period
+
+    static void Update(Series& series, DATE time, float price, double volume);
+    const Series* Find(std::string_view symbol, int minutes) const;
+    static bool CurrentComplete(const Series& series, DATE now);
+};
+
+#endif // BARBUILDER_H
@@ -0,0 +1,123 @@
+// BridgeChannel.h - One request/reply connection to the NinjaTrader AddOn
+// Copyright (c) 2025
+//
+// TcpBridge opens several of these, one per traffic class, so that a large
+// GETHISTORY transfer never sits in front of a PLACEORDER or CANCELORDER.
+// Each channel owns its connection (a Transport policy, see Transport.h),
+// send/receive buffers and negotiated framing/codec; the AddOn serves
+// every connection on its own thread.
+//
+// Every request has a deadline. The connection is non-blocking and waits
+// for replies with poll/select, so a stalled AddOn costs the caller at
+// most the timeout instead of hanging the Zorro thread. A command that
+// times out gets TIMEOUT_REPLY; its reply is still owed by the AddOn and
+// is dropped when it arrives, ahead of the replies to later commands.
+//
+// Tagged requests (TAGS:ON, needs framing): each request line is sent as
+// "#<tag> command" and its reply frame carries the tag after the length.
+// Replies are matched to requests through the pending table instead of
+// by order, so the AddOn may answer a slow GETHISTORY after the quick
+// commands queued behind it, and late replies are recognized by tag.
+
+#pragma once
+
+#ifndef BRIDGECHANNEL_H
+#define BRIDGECHANNEL_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "RecvBuffer.h"
+#include "SharedMemoryLink.h"
+#include "Transport.h"
+#include "WireCodec.h"      // Codec
+
+//=============================================================================
+// BasicBridgeChannel class - Connection with its own buffers and protocol state
+//=============================================================================
+//
+// Instantiated in BridgeChannel.cpp for DefaultTransport and LoopbackTransport.
+
+template <typename Transport>
+class BasicBridgeChannel
+{
+public:
+    static constexpr int DEFAULT_TIMEOUT_MS = 5000;
+    static constexpr std::string_view TIMEOUT_REPLY = "ERROR:Timeout";
+
+    explicit BasicBridgeChannel(size_t bufferCapacity = RecvBuffer::DEFAULT_CAPACITY);
+    ~BasicBridgeChannel();
+
+    // Connect, verify with PING and negotiate framing, codec and (if
+    // 'sharedMemory') the shared-memory transport. The transport stays in
+    // use when the AddOn doesn't offer shared memory.
+    // Transport::Startup() must have been called (done by TcpBridge).
+    bool Open(const char* host, int port, Codec preferredCodec, bool sharedMemory);
+    void Close();
+
+    bool IsOpen() const { return m_connected; }
+    bool IsFramed() const { return m_framed; }  // Length-prefixed replies negotiated
+    Codec GetCodec() const { return m_codec; }  // Codec negotiated for this connection
+    bool IsSharedMemory() const { return m_shm.IsOpen(); }
+    bool IsTagged() const { return m_tagged; }     // Replies matched by request tag
+
+    // The returned view points into this channel's receive buffer and stays
+    // valid until the next SendCommand()/SendBatch() on the same channel.
+    // Returns TIMEOUT_REPLY if no reply arrived within timeoutMs.
+    std::string_view SendCommand(std::string_view command, int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+    // Pipelined commands, see TcpBridge::SendBatch. The deadline covers
+    // the whole batch; replies still missing at the deadline are set to
+    // TIMEOUT_REPLY.
+    size_t SendBatch(const std::string_view* commands, size_t count, std::string_view* replies,
+                     int timeoutMs = DEFAULT_TIMEOUT_MS);
+
+private:
+    static constexpr int LIVENESS_CHECK_MS = 250;  // Socket check interval while waiting on shared memory
+
+    enum class ReceiveStatus { Ok, Timeout, Failed };
+
+    // Pending-request table entry of a tagged batch
+    struct PendingReply {
+        size_t offset = 0;        // Reply position in the receive buffer
+        size_t length = 0;
+        bool done = false;
+    };
+
+    Transport m_transport;
+    bool m_connected;
+    bool m_framed;                // Replies are length-prefixed (see NegotiateFraming)
+    bool m_tagged;                // Requests and replies carry tags (see NegotiateTags)
+    uint32_t m_nextTag;
+    Codec m_codec;
+    RecvBuffer m_recvBuffer;      // Persistent receive buffer (no per-call allocation)
+    std::string m_sendBuffer;     // Reused for outgoing "command\n"
+    std::vector<size_t> m_batchOffsets;  // Reply positions while a batch is being read
+    std::vector<PendingReply> m_pending; // Same, indexed by tag, in tagged mode
+    SharedMemoryLink m_shm;       // Replaces the socket for data when negotiated
+    std::chrono::steady_clock::time_point m_deadline;  // Of the request being answered
+    size_t m_abandoned;           // Replies to timed-out commands still to be dropped (untagged)
+
+    int SendAll(const char* data, size_t length);
+    void FillReplies(std::string_view* replies, size_t from, size_t to, std::string_view error);
+    bool NegotiateFraming();
+    bool NegotiateCodec();
+    bool NegotiateTags();
+    bool NegotiateSharedMemory();
+    int RemainingMs() const;
+    int Receive(char* buffer, int length);
+    ReceiveStatus ReceiveReply(std::string_view& reply);
+    ReceiveStatus ReceiveLine(std::string_view& line);
+    ReceiveStatus ReceiveFrame(std::string_view& frame, uint32_t& tag);
+    size_t ReceiveTagged(uint32_t firstTag, size_t count, std::string_view* replies);
+};
+
+extern template class BasicBridgeChannel<DefaultTransport>;
+extern template class BasicBridgeChannel<LoopbackTransport>;
+
+using BridgeChannel = BasicBridgeChannel<DefaultTransport>;
+
+#endif // BRIDGECHANNEL_H
@@ -0,0 +1,172 @@
+// CommandWriter.h - Allocation-free command serialization
+// Copyright (c) 2025
+//
+// Commands are "VERB:arg:arg..." lines. CommandWriter composes them in a
+// fixed buffer with std::to_chars - no heap, no iostream locale - so
+// building a PLACEORDER costs nanoseconds:
+//
+//     CommandWriter cmd;
+//     cmd.Begin(prefixes.Get(CommandPrefixes::Buy, "MES 03-26"))
+//        .Arg(2).Arg("LIMIT").Arg(6047.25).Arg(0.0);
+//     bridge.SendCommand(cmd.View());
+//
+// Doubles are written in the shortest form that reads back to the same
+// value (6047.25, not 6047.250000 or 6.04725e+03). Where the standard
+// library lacks floating-point to_chars, "%.17g" is used instead - longer
+// but equally exact.
+//
+// CommandPrefixes keeps the pre-built "PLACEORDER:BUY:instrument" and
+// "PLACEORDER:SELL:instrument" prefixes per asset, so an order in steady
+// state is one lookup, one copy and the numeric arguments.
+
+#pragma once
+
+#ifndef COMMANDWRITER_H
+#define COMMANDWRITER_H
+
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+//=============================================================================
+// CommandWriter - One command in a fixed buffer
+//=============================================================================
+
+class CommandWriter
+{
+public:
+    static constexpr size_t CAPACITY = 512;   // Longest command is a PLACEORDER (~100 bytes)
+
+    CommandWriter() : m_length(0), m_overflow(false) {}
+
+    // Start a new command with its verb (or a pre-built prefix)
+    CommandWriter& Begin(std::string_view verbOrPrefix)
+    {
+        m_length = 0;
+        m_overflow = false;
+        Write(verbOrPrefix);
+        return *this;
+    }
+
+    // Append ':' and one argument
+    CommandWriter& Arg(std::string_view text)
+    {
+        Write(':');
+        Write(text);
+        return *this;
+    }
+
+    CommandWriter& Arg(const char* text) { return Arg(std::string_view(text ? text : "")); }
+
+    CommandWriter& Arg(int value)
+    {
+        Write(':');
+        auto result = std::to_chars(m_buffer + m_length, m_buffer + CAPACITY, value);
+        Advance(result.ec, result.ptr);
+        return *this;
+    }
+
+    CommandWriter& Arg(double value)
+    {
+        Write(':');
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        auto result = std::to_chars(m_buffer + m_length, m_buffer + CAPACITY, value);
+        Advance(result.ec, result.ptr);
+#else
+        int written = snprintf(m_buffer + m_length, CAPACITY - m_length, "%.17g", value);
+        if (written < 0 || (size_t)written >= CAPACITY - m_length) {
+            m_overflow = true;
+        } else {
+            m_length += (size_t)written;
+        }
+#endif
+        return *this;
+    }
+
+    // The command so far; valid until the next Begin()
+    std::string_view View() const { return std::string_view(m_buffer, m_length); }
+
+    // An argument didn't fit; the command is truncated and must not be sent
+    bool Overflow() const { return m_overflow; }
+
+private:
+    char m_buffer[CAPACITY];
+    size_t m_length;
+    bool m_overflow;
+
+    void Write(char c)
+    {
+        if (m_length < CAPACITY) {
+            m_buffer[m_length++] = c;
+        } else {
+            m_overflow = true;
+        }
+    }
+
+    void Write(std::string_view text)
+    {
+        size_t room = CAPACITY - m_length;
+        size_t count = text.size() <= room ? text.size() : room;
+        memcpy(m_buffer + m_length, text.data(), count);
+        m_length += count;
+        m_overflow |= (count < text.size());
+    }
+
+    void Advance(std::errc ec, char* end)
+    {
+        if (ec == std::errc()) {
+            m_length = (size_t)(end - m_buffer);
+        } else {
+            m_overflow = true;
+        }
+    }
+};
+
+//=============================================================================
+// CommandPrefixes - Pre-built per-asset command prefixes
+//=============================================================================
+
+class CommandPrefixes
+{
+public:
+    enum Kind { Buy, Sell, KIND_COUNT };
+
+    // Prefix of a command for 'instrument', e.g. "PLACEORDER:BUY:MES 03-26".
+    // Built on first use per asset; later calls only look it up.
+    std::string_view Get(Kind kind, std::string_view instrument)
+    {
+        auto it = m_assets.find(instrument);
+        if (it == m_assets.end()) {
+            it = m_assets.emplace(std::string(instrument), Build(instrument)).first;
+        }
+        return it->second.prefixes[kind];
+    }
+
+    void Clear() { m_assets.clear(); }
+
+private:
+    struct AssetPrefixes {
+        std::string prefixes[KIND_COUNT];
+    };
+
+    std::map<std::string, AssetPrefixes, std::less<>> m_assets;
+
+    static AssetPrefixes Build(std::string_view instrument)
+    {
+        static const char* const verbs[KIND_COUNT] = { "PLACEORDER:BUY:", "PLACEORDER:SELL:" };
+
+        AssetPrefixes asset;
+        for (int kind = 0; kind < KIND_COUNT; kind++) {
+            asset.prefixes[kind] = verbs[kind];
+            asset.prefixes[kind] += instrument;
+        }
+        return asset;
+    }
+};
+
+#endif // COMMANDWRITER_H
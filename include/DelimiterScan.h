@@ -0,0 +1,36 @@
+// DelimiterScan.h - Vectorized delimiter search for bulk text replies
+// Copyright (c) 2025
+//
+// A HISTORY reply of 100k bars is several megabytes of "t,o,h,l,c,v|"
+// records. Instead of looking for the next delimiter one character at a
+// time, ScanDelimiters() compares 32 (AVX2) or 16 (SSE2) bytes per step
+// and writes the offsets of all matches into an array, which the field
+// decoder (TextCodec::DecodeHistory) then walks without looking at the
+// text between delimiters again.
+//
+// The instruction set is picked once at run time: AVX2 when the CPU and
+// OS support it, SSE2 on any other x86 CPU, a scalar loop elsewhere. All
+// three return the same offsets.
+
+#pragma once
+
+#ifndef DELIMITERSCAN_H
+#define DELIMITERSCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Offsets (from text.data()) of every 'first' or 'second' character in
+// text[from..], in ascending order. Stops when 'positions' could overflow -
+// call again from 'next' until next == text.size(). 'capacity' must be at
+// least DELIMITER_SCAN_MIN_CAPACITY; text must be shorter than 4 GB.
+static constexpr size_t DELIMITER_SCAN_MIN_CAPACITY = 64;
+
+size_t ScanDelimiters(std::string_view text, size_t from, char first, char second,
+                      uint32_t* positions, size_t capacity, size_t& next);
+
+// "AVX2", "SSE2" or "scalar" - the implementation ScanDelimiters() uses
+const char* DelimiterScanLevel();
+
+#endif // DELIMITERSCAN_H
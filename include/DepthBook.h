@@ -0,0 +1,72 @@
+// DepthBook.h - Level-2 order book of one asset
+// Copyright (c) 2025
+//
+// NinjaTrader reports market depth as position-based row operations per
+// side: add a row at a position, update the row at a position, remove the
+// row at a position. The AddOn forwards them on the push channel as
+//
+//     DEPTH:{instrument}:{side}:{operation}:{position}:{price}:{volume}[:{time}]
+//
+// side 0 = ask, 1 = bid; operation 0 = add, 1 = update, 2 = remove.
+//
+// Each side is a fixed-capacity ladder stored as a structure of arrays
+// (prices, volumes), best level first. An update - by far the most common
+// operation - is a single index write; add and remove shift the rows
+// behind the position, at most MAX_LEVELS floats. The reader thread of the
+// quote stream is the only writer; GET_BOOK reads a consistent copy through
+// a seqlock without ever blocking the writer.
+
+#pragma once
+
+#ifndef DEPTHBOOK_H
+#define DEPTHBOOK_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "trading.h"        // DATE, T2
+
+enum class BookSide { Ask = 0, Bid = 1 };
+enum class DepthOperation { Add = 0, Update = 1, Remove = 2 };
+
+//=============================================================================
+// DepthBook class - Structure-of-arrays price ladder per side
+//=============================================================================
+
+class DepthBook
+{
+public:
+    static constexpr int MAX_LEVELS = 64;     // Rows per side; deeper rows are dropped
+
+    DepthBook();
+
+    // Apply one row operation (single writer). Operations on positions
+    // outside the ladder are ignored. Returns false if ignored.
+    bool Apply(BookSide side, DepthOperation operation, int position,
+               float price, float volume, DATE time);
+
+    // Empty both sides (writer)
+    void Clear();
+
+    // Copy the best 'levels' rows of each side into 'quotes' - asks with a
+    // positive price, then bids with a negative price, each best first,
+    // stamped with the time of the latest update. At most 'maxQuotes'
+    // entries; returns the number written. Lock-free, never allocates.
+    int Top(int levels, T2* quotes, int maxQuotes) const;
+
+private:
+    struct Ladder {
+        std::atomic<float> price[MAX_LEVELS];
+        std::atomic<float> volume[MAX_LEVELS];
+        std::atomic<int> count;
+    };
+
+    Ladder m_sides[2];
+    std::atomic<uint32_t> m_seq;    // Odd while the writer is inside an operation
+    std::atomic<double> m_time;
+
+    static void Move(Ladder& ladder, int to, int from);
+    static int CopySide(const Ladder& ladder, float sign, int levels, DATE time, T2* quotes, int space);
+};
+
+#endif // DEPTHBOOK_H
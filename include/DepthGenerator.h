@@ -0,0 +1,67 @@
+// DepthGenerator.h - Stand-in source of DEPTH push lines
+// Copyright (c) 2025
+//
+// Produces the DEPTH row operations a NinjaTrader depth feed would send
+// for one instrument, without NinjaTrader: a ladder of contiguous price
+// levels around a random-walking mid price. Most operations update the
+// volume of a row; a price move removes the touched level on one side,
+// inserts a new best level on the other and refills/trims the tails, as
+// an exchange feed does. The lines run through the same decoding as real
+// ones (QuoteStream, DepthBook), for exercising and measuring the order
+// book path on any machine.
+
+#pragma once
+
+#ifndef DEPTHGENERATOR_H
+#define DEPTHGENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "CommandWriter.h"
+#include "DepthBook.h"
+
+//=============================================================================
+// DepthGenerator class - Deterministic synthetic depth feed
+//=============================================================================
+
+class DepthGenerator
+{
+public:
+    static constexpr int MOVE_PERCENT = 10;     // Operations that start a price move
+
+    DepthGenerator(std::string instrument, double mid, double tickSize, int levels = 10, uint32_t seed = 1);
+
+    // Next operation as a DEPTH line without newline. The view stays valid
+    // until the next call. The first 2 * levels lines build the book.
+    std::string_view Next(DATE time);
+
+private:
+    struct Operation {
+        BookSide side;
+        DepthOperation operation;
+        int position;
+        double price;
+        double volume;
+    };
+
+    std::string m_instrument;
+    double m_tickSize;
+    int m_levels;
+    uint32_t m_random;
+    double m_bestAsk;
+    double m_bestBid;
+    int m_built;                  // Rows added while building the book
+
+    Operation m_pending[4];       // Rest of a price move
+    int m_pendingCount;
+    int m_pendingNext;
+    CommandWriter m_line;
+
+    uint32_t Random();
+    double RandomVolume() { return 1 + Random() % 200; }
+    void Move(bool up);
+};
+
+#endif // DEPTHGENERATOR_H
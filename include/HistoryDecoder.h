@@ -0,0 +1,91 @@
+// HistoryDecoder.h - Parallel decoding of large text HISTORY replies
+// Copyright (c) 2025
+//
+// Bars of a HISTORY:{n}|bar|bar|... reply are independent once their
+// boundaries are known. HistoryDecoder cuts the bar list at '|' into one
+// chunk per thread; the calling thread decodes the first chunk straight
+// into the caller's T6 buffer while a small pool of worker threads
+// decodes the others into scratch buffers. The chunks are then appended
+// in order, each at the offset given by the bars loaded before it.
+//
+// The result is identical to TextCodec::DecodeHistory - same bars, same
+// loaded/skipped counts, same tStart/tEnd filtering - because a chunk in
+// which the serial decoder would have stopped (buffer full) is decoded
+// again in place, serially, from its own start. Replies smaller than
+// PARALLEL_THRESHOLD, and machines with a single core, are decoded
+// serially on the calling thread.
+
+#pragma once
+
+#ifndef HISTORYDECODER_H
+#define HISTORYDECODER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "WireCodec.h"
+
+//=============================================================================
+// HistoryDecoder class - Text history decoding with a worker pool
+//=============================================================================
+
+class HistoryDecoder
+{
+public:
+    static constexpr size_t PARALLEL_THRESHOLD = 1 << 20;  // Bytes; ~20k bars
+    static constexpr unsigned MAX_WORKERS = 3;             // Besides the calling thread
+
+    // 'workers' < 0: one per core besides the calling thread, up to
+    // MAX_WORKERS; otherwise exactly that many (tests, benchmarks)
+    explicit HistoryDecoder(int workers = -1);
+    ~HistoryDecoder();
+
+    HistoryDecoder(const HistoryDecoder&) = delete;
+    HistoryDecoder& operator=(const HistoryDecoder&) = delete;
+
+    // Same contract as TextCodec::DecodeHistory. Workers are started on
+    // the first reply large enough to need them. Not reentrant: one
+    // decode at a time (Zorro's thread).
+    bool Decode(std::string_view response, DATE tStart, DATE tEnd,
+                T6* ticks, int nTicks, HistoryResult& result);
+
+    unsigned Workers() const { return (unsigned)m_workers.size(); }
+
+private:
+    // A run of whole bars and, for the worker chunks, where it was decoded to
+    struct Chunk {
+        std::string_view bars;
+        std::unique_ptr<T6[]> scratch;
+        size_t capacity = 0;
+        HistoryResult result;
+        bool decoded = false;     // False if the scratch buffer couldn't be allocated
+    };
+
+    std::vector<std::thread> m_workers;
+    int m_workerCount;                 // As requested; < 0 for the default
+    std::mutex m_mutex;
+    std::condition_variable m_start;   // New generation of chunks to decode
+    std::condition_variable m_done;    // m_pending reached zero
+    uint64_t m_generation;
+    unsigned m_pending;                // Worker chunks not yet decoded
+    bool m_stopping;
+    bool m_poolTried;                  // Workers started (or found not worth starting)
+
+    Chunk m_chunks[MAX_WORKERS + 1];   // [0] is decoded by the calling thread
+    DATE m_tStart;
+    DATE m_tEnd;
+    int m_nTicks;
+
+    bool StartWorkers();
+    void WorkerLoop(unsigned chunk);
+    void DecodeChunk(Chunk& chunk);
+    void Split(std::string_view bars, size_t count);
+};
+
+#endif // HISTORYDECODER_H
@@ -8,11 +8,14 @@
 
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#include <chrono>
 #include <string>
 #include <map>
 #include <memory>
 
 #include "trading.h"
+#include "BarBuilder.h"
+#include "SubscriptionRegistry.h"
 #include "TcpBridge.h"  // Changed from NtDirect.h
 
 // DLL export macro
@@ -67,14 +70,23 @@ struct OrderInfo {
 };
 
 //=============================================================================
-// Asset specification structure
+// Quote cache entry
 //=============================================================================
 
-struct AssetSpec {
-    double tickSize;      // Minimum price increment (pip size)
-    double pointValue;    // Dollar value per point (pip cost)
-    
-    AssetSpec() : tickSize(0), pointValue(0) {}
+struct CachedQuote {
+    Quote quote;
+    std::chrono::steady_clock::time_point fetched;  // When the quote was received
+    uint64_t sweep = 0;       // GETPRICES sweep that delivered it, 0 if fetched alone
+    bool served = false;      // Already handed to BrokerAsset in that sweep
+};
+
+//=============================================================================
+// Account cache entry
+//=============================================================================
+
+struct CachedAccount {
+    AccountRecord values;
+    std::chrono::steady_clock::time_point fetched;
 };
 
 //=============================================================================
@@ -91,19 +103,55 @@ struct PluginState {
     
     // Account state
     std::string account;            // Current account name
-    std::string currentSymbol;      // Last subscribed symbol
     
-    // Position cache - CRITICAL: Updated immediately on fills
-    std::map<std::string, int> positions;  // symbol -> signed position (negative for short)
+    // Account snapshot cache - dropped whenever the plugin sees a fill
+    std::map<std::string, CachedAccount> accounts;  // account name -> last GETACCOUNT
+    int accountTtlMs = 500;                         // Max age of a reused snapshot
     
-    // Asset specifications cache
-    std::map<std::string, AssetSpec> assetSpecs;  // symbol -> contract specs
+    // Position book - CRITICAL: Updated immediately on fills
+    // Reloaded with one GETPOSITIONS when older than positionTtlMs; symbols
+    // missing from the book are flat
+    std::map<std::string, PositionRecord> positions;  // symbol -> signed quantity (negative for short), avg price
+    std::chrono::steady_clock::time_point positionsFetched;
+    std::chrono::steady_clock::time_point positionsRetry;  // No reload before (after a timeout)
+    int positionTtlMs = 1000;                          // Max age of the book
+    bool bulkPositions = true;                         // Cleared if the AddOn lacks GETPOSITIONS
+    
+    // Subscribed assets with their contract specs, capped by SET_MAXASSETS.
+    // Only the session's first subscription waits for its first price.
+    SubscriptionRegistry subscriptions;
+    bool dataWaited = false;                      // First subscription has waited
+    std::string bookSymbol;                       // Asset selected by SET_SYMBOL (GET_BOOK)
+    
+    // Quote cache - BrokerAsset refreshes it, BrokerBuy2/BrokerTrade reuse
+    // a quote younger than quoteTtlMs instead of sending another GETPRICE
+    std::map<std::string, CachedQuote> quotes;    // symbol -> last quote
+    int quoteTtlMs = 200;                         // Max age of a reused quote (SET_QUOTETTL)
+    
+    // Portfolio price sweep - the first BrokerAsset of a cycle fetches every
+    // subscribed asset with one GETPRICES, the rest of the cycle is served
+    // from that snapshot
+    uint64_t priceSweep = 0;                      // Number of the latest sweep
+    std::chrono::steady_clock::time_point pricesRetry;  // No sweep before (after a timeout)
+    bool bulkPrices = true;                       // Cleared if the AddOn lacks GETPRICES
+    
+    // Bars built from every pushed quote; BrokerHistory2 serves the window
+    // they cover without asking the AddOn (SET_BARPERIOD)
+    BarBuilder bars;
     
     // Order tracking
     std::map<int, OrderInfo> orders;            // Track orders by numeric ID
     std::map<std::string, int> orderIdMap;      // Map NT order ID to numeric ID
     int nextOrderNum = 1000;                    // Next numeric order ID to assign
     
+    // Order status table - one GETORDERSTATUSES refreshes every tracked
+    // order; BrokerTrade reads it locally for the rest of the cycle
+    std::map<std::string, OrderStatusRecord> orderStatus;  // NT order ID -> status
+    std::chrono::steady_clock::time_point orderStatusFetched;
+    std::chrono::steady_clock::time_point orderStatusRetry;  // No refresh before (after a timeout)
+    int orderStatusTtlMs = 250;                 // Max age of the table
+    bool bulkOrderStatus = true;                // Cleared if the AddOn lacks GETORDERSTATUSES
+    
     // Order cleanup settings
     int maxOrderHistory = 100;                  // Keep last N completed orders for debugging
     int orderCleanupCount = 0;                  // Track cleanup operations
@@ -114,11 +162,25 @@ struct PluginState {
         orderType = ORDER_GTC;
         connected = false;
         account.clear();
-        currentSymbol.clear();
-        positions.clear();  // Clear position cache
-        assetSpecs.clear(); // Clear asset specs
+        accounts.clear();
+        positions.clear();  // Clear position book
+        positionsFetched = {};
+        positionsRetry = {};
+        bulkPositions = true;
+        subscriptions = SubscriptionRegistry();  // Subscriptions, asset specs and SET_MAXASSETS
+        dataWaited = false;
+        bookSymbol.clear();
+        quotes.clear();
+        quoteTtlMs = 200;
+        priceSweep = 0;
+        pricesRetry = {};
+        bulkPrices = true;
+        bars = BarBuilder();
         orders.clear();
         orderIdMap.clear();
+        orderStatus.clear();
+        orderStatusRetry = {};
+        bulkOrderStatus = true;
         nextOrderNum = 1000;
         orderCleanupCount = 0;
     }
@@ -0,0 +1,237 @@
+// NumberParser.h - Non-throwing, locale-independent number parsing
+// Copyright (c) 2025
+//
+// Every number in a text reply goes through ParseDouble()/ParseInt(). They
+// take a std::string_view field (see Tokenizer.h), never allocate, never
+// throw, ignore the C locale (a German Windows doesn't turn "6047.25" into
+// 6047) and report why a field was rejected. The whole field must be the
+// number; on any status other than Ok the output value is unspecified.
+//
+// ParseInt() uses std::from_chars. ParseDouble() reads plain decimals of up
+// to 15 digits itself, exactly, and hands everything else to from_chars
+// when the standard library implements floating-point from_chars
+// (__cpp_lib_to_chars: MSVC 2019 16.4+, libstdc++ 11+). Otherwise a bundled
+// parser takes over: exact for up to 15 significant digits and |exponent|
+// <= 22 - every price, volume and OLE date the AddOn sends - and within an
+// ulp beyond that.
+
+#pragma once
+
+#ifndef NUMBERPARSER_H
+#define NUMBERPARSER_H
+
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+
+enum class ParseStatus {
+    Ok,
+    Empty,          // Zero-length field
+    Invalid,        // Not a number, or characters after it
+    OutOfRange      // Too large for the target type
+};
+
+//=============================================================================
+// Integers
+//=============================================================================
+
+inline ParseStatus ParseInt(std::string_view text, int& value)
+{
+    if (text.empty()) {
+        return ParseStatus::Empty;
+    }
+
+    const char* end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        return ParseStatus::OutOfRange;
+    }
+    if (result.ec != std::errc() || result.ptr != end) {
+        return ParseStatus::Invalid;
+    }
+    return ParseStatus::Ok;
+}
+
+//=============================================================================
+// Floating point
+//=============================================================================
+
+// Fast path for plain decimals of at most 15 digits ("6047.25", "-0.5",
+// "45000.00069444" - nearly every field the AddOn sends). Mantissa and
+// power of ten are both exact, so the one division is correctly rounded:
+// the result is bit-identical to the full parser's. Returns false for
+// anything else (exponents, more digits, malformed), which the full
+// parser then handles.
+inline bool ParseShortDecimal(std::string_view text, double& value)
+{
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15
+    };
+
+    const char* p = text.data();
+    const char* end = p + text.size();
+    bool negative = (p < end && *p == '-');
+    if (negative) p++;
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    for (; p < end && (unsigned)(*p - '0') <= 9; p++, digits++) {
+        mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+    }
+    int fraction = 0;
+    if (p < end && *p == '.') {
+        const char* first = ++p;
+        for (; p < end && (unsigned)(*p - '0') <= 9; p++, digits++) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        }
+        fraction = (int)(p - first);
+    }
+    if (p != end || digits == 0 || digits > 15) {
+        return false;
+    }
+
+    double result = fraction ? (double)mantissa / powers[fraction] : (double)mantissa;
+    value = negative ? -result : result;
+    return true;
+}
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+
+inline ParseStatus ParseDouble(std::string_view text, double& value)
+{
+    if (text.empty()) {
+        return ParseStatus::Empty;
+    }
+    if (ParseShortDecimal(text, value)) {
+        return ParseStatus::Ok;
+    }
+
+    const char* end = text.data() + text.size();
+    auto result = std::from_chars(text.data(), end, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        return ParseStatus::OutOfRange;
+    }
+    if (result.ec != std::errc() || result.ptr != end) {
+        return ParseStatus::Invalid;
+    }
+    return ParseStatus::Ok;
+}
+
+#else
+
+// [-]digits[.digits][(e|E)[+|-]digits], as written by .NET and printf
+inline ParseStatus ParseDouble(std::string_view text, double& value)
+{
+    if (text.empty()) {
+        return ParseStatus::Empty;
+    }
+    if (ParseShortDecimal(text, value)) {
+        return ParseStatus::Ok;
+    }
+
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    bool negative = (*p == '-');
+    if (negative) p++;
+
+    // Mantissa: keep the first 19 significant digits, count the rest
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        any = true;
+        if (digits < 19) {
+            if (mantissa || *p != '0') {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                digits += (mantissa != 0);
+            }
+        } else {
+            exponent++;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+            any = true;
+            if (digits < 19) {
+                if (mantissa || *p != '0') {
+                    mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                    digits += (mantissa != 0);
+                }
+                exponent--;
+            }
+        }
+    }
+    if (!any) {
+        return ParseStatus::Invalid;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExponent = (p < end && *p == '-');
+        if (p < end && (*p == '-' || *p == '+')) p++;
+        if (p == end) {
+            return ParseStatus::Invalid;
+        }
+
+        int e = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (e < 10000) e = e * 10 + (*p - '0');
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+    if (p != end) {
+        return ParseStatus::Invalid;
+    }
+
+    static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    double result;
+    if (mantissa == 0) {
+        result = 0.0;
+    } else if (mantissa < (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        // Both operands exact - one correctly rounded operation
+        result = exponent < 0 ? (double)mantissa / powers[-exponent]
+                              : (double)mantissa * powers[exponent];
+    } else {
+        long double scaled = (long double)mantissa;
+        long double ten = 10.0L;
+        int e = exponent < 0 ? -exponent : exponent;
+        long double factor = 1.0L;
+        while (e) {
+            if (e & 1) factor *= ten;
+            ten *= ten;
+            e >>= 1;
+        }
+        scaled = exponent < 0 ? scaled / factor : scaled * factor;
+        if (scaled > (long double)std::numeric_limits<double>::max()) {
+            return ParseStatus::OutOfRange;
+        }
+        result = (double)scaled;
+    }
+
+    value = negative ? -result : result;
+    return ParseStatus::Ok;
+}
+
+#endif
+
+// Float fields (T6 prices/volume) parse as double, like the AddOn writes them
+inline ParseStatus ParseFloat(std::string_view text, float& value)
+{
+    double parsed;
+    ParseStatus status = ParseDouble(text, parsed);
+    if (status == ParseStatus::Ok) {
+        value = (float)parsed;
+    }
+    return status;
+}
+
+#endif // NUMBERPARSER_H
@@ -0,0 +1,147 @@
+// QuoteStream.h - Server-push quote channel from the NinjaTrader AddOn
+// Copyright (c) 2025
+//
+// Opens a second connection to the AddOn and turns it into a push channel
+// with the STREAM command. From then on the AddOn writes one line per
+// market data update for every subscribed instrument:
+//
+//     QUOTE:{instrument}:{last}:{bid}:{ask}:{volume}:{time}
+//
+// and, for instruments with SUBSCRIBEDEPTH, one line per order book row
+// operation (DEPTH:..., see DepthBook.h).
+//
+// A background reader thread decodes these lines into a fixed, lock-free
+// per-asset quote table and order books. BrokerAsset reads the latest
+// quote, and GET_BOOK the book, without any network I/O. Every applied
+// quote is also queued, so the local bars see the highs and lows between
+// two BrokerAsset calls and not just the latest quote.
+//
+// Quotes are only served while the push channel runs. When its connection
+// drops, the reader thread ends and empties the table, so callers fall
+// back to GETPRICE instead of reading the last pushed quote forever.
+
+#pragma once
+
+#ifndef QUOTESTREAM_H
+#define QUOTESTREAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#include "DepthBook.h"
+#include "RecvBuffer.h"
+#include "Transport.h"
+#include "WireCodec.h"      // Quote
+
+// One queued quote update. An empty instrument marks lost updates: the
+// queue overflowed or the push channel restarted before this entry.
+struct PushedQuote {
+    char instrument[48];
+    Quote quote;
+};
+
+//=============================================================================
+// BasicQuoteStream class - Push subscription with background reader thread
+//=============================================================================
+//
+// Instantiated in QuoteStream.cpp for DefaultTransport and LoopbackTransport.
+
+template <typename Transport>
+class BasicQuoteStream
+{
+public:
+    static constexpr int MAX_ASSETS = 128;          // Quote table capacity
+    static constexpr int MAX_SYMBOL_LENGTH = 48;
+    static constexpr int DEFAULT_TIMEOUT_MS = 5000; // For the STREAM acknowledgement
+    static constexpr size_t UPDATE_QUEUE_CAPACITY = 1 << 15;  // Quotes not yet taken; power of 2
+
+    BasicQuoteStream();
+    ~BasicQuoteStream();
+
+    // Connect the push channel and start the reader thread. Fails (returns
+    // false) against AddOns without STREAM support, and if the AddOn
+    // doesn't acknowledge STREAM within timeoutMs.
+    bool Start(const char* host, int port, int timeoutMs = DEFAULT_TIMEOUT_MS);
+    void Stop();
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    // Reserve a table slot for an instrument (Zorro thread only).
+    // Returns false if the table is full.
+    bool Watch(const char* instrument);
+
+    // Release an instrument's slot and forget its quote and book (Zorro
+    // thread only). Watching it again starts from no quote, as for a new
+    // instrument.
+    void Unwatch(const char* instrument);
+
+    // Latest streamed quote for an instrument. Returns false if the push
+    // channel is not running, the instrument is not watched or no update
+    // has arrived since the channel started.
+    // Lock-free: never blocks on the reader thread.
+    bool Latest(const char* instrument, Quote& quote) const;
+    
+    // Best 'levels' rows per side of the instrument's order book into
+    // 'quotes' (see DepthBook::Top). Returns the number of entries, 0 if
+    // the push channel is not running, the instrument is not watched or no
+    // depth has arrived. Lock-free.
+    int Book(const char* instrument, int levels, T2* quotes, int maxQuotes) const;
+    
+    // Next queued quote update, oldest first (Zorro thread only). Returns
+    // false if none is pending. While the queue is full, updates are left
+    // out and a lost-updates entry follows once there is room again.
+    bool NextUpdate(PushedQuote& update);
+
+private:
+    // One table entry; an empty symbol marks a free slot. Symbols are
+    // changed by Watch()/Unwatch() under m_tableMutex, which the reader
+    // thread holds while it applies lines, so a slot never changes owner
+    // mid-update. The Zorro thread reads them without the lock. Prices
+    // are guarded by a seqlock: the single writer (reader thread) makes
+    // 'seq' odd while updating.
+    struct Slot {
+        char symbol[MAX_SYMBOL_LENGTH];
+        std::atomic<uint32_t> seq;
+        std::atomic<double> last;
+        std::atomic<double> bid;
+        std::atomic<double> ask;
+        std::atomic<double> volume;
+        std::atomic<double> time;
+    };
+
+    Transport m_transport;
+    std::thread m_reader;
+    std::atomic<bool> m_running;
+    RecvBuffer m_recvBuffer;          // Owned by the reader thread
+
+    Slot m_slots[MAX_ASSETS];
+    DepthBook m_books[MAX_ASSETS];    // Same index as the slot
+    std::atomic<int> m_count;         // Slots ever used (free ones included)
+    std::mutex m_tableMutex;          // Slot owners vs the reader's writes
+
+    // Single-producer/single-consumer queue of applied quotes: the reader
+    // thread pushes, the Zorro thread takes
+    std::unique_ptr<PushedQuote[]> m_updates;
+    alignas(64) std::atomic<size_t> m_updateHead;   // Written by the reader thread
+    alignas(64) std::atomic<size_t> m_updateTail;   // Written by the Zorro thread
+    bool m_updatesLost;               // Reader side: mark a gap before the next update
+
+    void ReaderLoop();
+    void ResetTable();
+    void Apply(std::string_view line);
+    void Apply(const StreamedQuote& quote);
+    void Apply(const DepthUpdate& update);
+    bool Enqueue(const char* instrument, const Quote& quote);
+    int Find(std::string_view instrument) const;
+};
+
+extern template class BasicQuoteStream<DefaultTransport>;
+extern template class BasicQuoteStream<LoopbackTransport>;
+
+using QuoteStream = BasicQuoteStream<DefaultTransport>;
+
+#endif // QUOTESTREAM_H
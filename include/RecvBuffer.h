@@ -0,0 +1,173 @@
+// RecvBuffer.h - Connection-owned receive buffer for bridge replies
+// Copyright (c) 2025
+//
+// Replaces the per-call 1MB heap buffer in TcpBridge::SendCommand.
+// Bytes from recv() are appended in place and complete replies (newline-
+// or length-framed) are handed back as std::string_view into the buffer,
+// so a steady-state round trip performs no heap allocation. The storage only
+// grows when a reply is larger than anything seen before (large history).
+
+#pragma once
+
+#ifndef RECVBUFFER_H
+#define RECVBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+//=============================================================================
+// RecvBuffer class - Reusable, compacting receive buffer
+//=============================================================================
+//
+// Layout:   [ consumed | unread frames ...... | free space ]
+//           0          m_head                 m_tail        capacity
+//
+// Frames returned by NextLine() stay valid until the next Compact() or
+// Reserve(); callers compact at the start of each new request. Leftover
+// bytes (a partial frame) are moved to the front so every frame is
+// contiguous in memory.
+
+class RecvBuffer
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64 * 1024;  // Typical replies are < 100 bytes
+    static constexpr size_t FRAME_HEADER_SIZE = 4;         // uint32 little-endian payload length
+    static constexpr size_t TAGGED_HEADER_SIZE = 8;        // Payload length, then uint32 request tag
+    static constexpr size_t MAX_FRAME_SIZE = 256u << 20;   // Larger length headers are corrupt
+
+    explicit RecvBuffer(size_t capacity = DEFAULT_CAPACITY)
+        : m_data(capacity)
+        , m_head(0)
+        , m_tail(0)
+        , m_scan(0)
+    {
+    }
+
+    // Free space available for the next recv()
+    char* WritePtr()          { return m_data.data() + m_tail; }
+    size_t WriteSpace() const { return m_data.size() - m_tail; }
+
+    // Mark n bytes written at WritePtr() as received
+    void Commit(size_t n)     { m_tail += n; }
+
+    // Unread bytes currently buffered
+    size_t Pending() const    { return m_tail - m_head; }
+
+    // Frames as offsets, for callers that must survive a Reserve()
+    size_t Offset(std::string_view frame) const { return frame.data() - m_data.data(); }
+    std::string_view View(size_t offset, size_t length) const
+    {
+        return std::string_view(m_data.data() + offset, length);
+    }
+
+    // Ensure at least 'extra' bytes of free space (grows geometrically).
+    // Growing moves the storage, so it also invalidates returned frames.
+    void Reserve(size_t extra)
+    {
+        if (WriteSpace() >= extra) return;
+
+        size_t newSize = m_data.size() * 2;
+        while (newSize - m_tail < extra) {
+            newSize *= 2;
+        }
+        m_data.resize(newSize);
+    }
+
+    // Extract the next complete '\n'-terminated frame (newline stripped).
+    // Returns false if no complete frame is buffered yet.
+    bool NextLine(std::string_view& line)
+    {
+        const char* base = m_data.data();
+        const void* nl = memchr(base + m_scan, '\n', m_tail - m_scan);
+        if (!nl) {
+            m_scan = m_tail;  // Don't rescan these bytes on the next call
+            return false;
+        }
+
+        size_t end = (const char*)nl - base;
+        line = std::string_view(base + m_head, end - m_head);
+        m_head = end + 1;
+        m_scan = m_head;
+        return true;
+    }
+
+    // Extract the next complete length-prefixed frame (header stripped).
+    // Returns false if it is not fully buffered yet; 'missing' then holds
+    // the number of bytes still needed to complete the header or payload.
+    bool NextFrame(std::string_view& frame, size_t& missing)
+    {
+        return NextFrame(frame, FRAME_HEADER_SIZE, missing);
+    }
+
+    // Payload length announced by the frame header at the read position.
+    // The header must be buffered (Pending() >= FRAME_HEADER_SIZE).
+    size_t FrameLength() const { return ReadUint32(m_data.data() + m_head); }
+
+    // Same for tagged frames, whose header also carries the request tag
+    bool NextTaggedFrame(std::string_view& frame, uint32_t& tag, size_t& missing)
+    {
+        if (!NextFrame(frame, TAGGED_HEADER_SIZE, missing)) {
+            return false;
+        }
+        tag = ReadUint32(frame.data() - TAGGED_HEADER_SIZE + FRAME_HEADER_SIZE);
+        return true;
+    }
+
+    // Drop consumed bytes. Invalidates previously returned frames.
+    void Compact()
+    {
+        if (m_head == 0) return;
+
+        size_t pending = Pending();
+        if (pending > 0) {
+            memmove(m_data.data(), m_data.data() + m_head, pending);
+        }
+        m_scan -= m_head;
+        m_head = 0;
+        m_tail = pending;
+    }
+
+    // Discard everything (used after a connection reset)
+    void Clear()
+    {
+        m_head = m_tail = m_scan = 0;
+    }
+
+private:
+    static uint32_t ReadUint32(const char* p)
+    {
+        const unsigned char* b = (const unsigned char*)p;
+        return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+    }
+
+    bool NextFrame(std::string_view& frame, size_t headerSize, size_t& missing)
+    {
+        size_t pending = Pending();
+        if (pending < headerSize) {
+            missing = headerSize - pending;
+            return false;
+        }
+
+        size_t length = ReadUint32(m_data.data() + m_head);
+        if (pending - headerSize < length) {
+            missing = length - (pending - headerSize);
+            return false;
+        }
+
+        frame = std::string_view(m_data.data() + m_head + headerSize, length);
+        m_head += headerSize + length;
+        m_scan = m_head;
+        missing = 0;
+        return true;
+    }
+
+    std::vector<char> m_data;
+    size_t m_head;   // Start of unread data
+    size_t m_tail;   // End of received data
+    size_t m_scan;   // Newline search resumes here
+};
+
+#endif // RECVBUFFER_H
@@ -0,0 +1,258 @@
+// ReplySchema.h - Compile-time schemas for text replies
+// Copyright (c) 2025
+//
+// A text reply's layout is declared once as a type instead of being
+// re-parsed by hand with magic indices and size checks:
+//
+//     inline constexpr char TAG_PRICE[] = "PRICE";
+//     using QuoteSchema = ReplySchema<TAG_PRICE, ':', 4, Quote,
+//         Field<&Quote::last>, Field<&Quote::bid>,
+//         Field<&Quote::ask>, Field<&Quote::volume>>;
+//
+//     Quote quote;
+//     if (QuoteSchema::Parse("PRICE:6047.5:6047.25:6047.75:1200", quote)) ...
+//
+// Parse() is generated per schema: it walks the reply once (Tokenizer.h),
+// converts each field straight into its record member (NumberParser.h) and
+// never allocates. The member type picks the conversion - double, float,
+// int, std::string_view (a view into the reply) or char[N] (truncated
+// copy). Skip ignores a field.
+//
+// ReplyDispatcher<Schemas...> picks the schema by the reply's tag through
+// a perfect hash built at compile time, for code that receives more than
+// one kind of reply on the same path.
+
+#pragma once
+
+#ifndef REPLYSCHEMA_H
+#define REPLYSCHEMA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "NumberParser.h"
+#include "Tokenizer.h"
+
+//=============================================================================
+// Field descriptors
+//=============================================================================
+
+// Field stored in a record member; the member type selects the conversion
+template <auto Member>
+struct Field
+{
+    template <typename Record>
+    static bool Read(std::string_view text, Record& record)
+    {
+        return Convert(text, record.*Member);
+    }
+
+private:
+    static bool Convert(std::string_view text, double& value) { return ParseDouble(text, value) == ParseStatus::Ok; }
+    static bool Convert(std::string_view text, float& value)  { return ParseFloat(text, value) == ParseStatus::Ok; }
+    static bool Convert(std::string_view text, int& value)    { return ParseInt(text, value) == ParseStatus::Ok; }
+
+    static bool Convert(std::string_view text, std::string_view& value)
+    {
+        value = text;
+        return true;
+    }
+
+    template <size_t N>
+    static bool Convert(std::string_view text, char (&value)[N])
+    {
+        size_t length = text.size() < N - 1 ? text.size() : N - 1;
+        text.copy(value, length);
+        value[length] = '\0';
+        return true;
+    }
+};
+
+// Field present in the reply but not stored
+struct Skip
+{
+    template <typename Record>
+    static bool Read(std::string_view, Record&) { return true; }
+};
+
+//=============================================================================
+// ReplySchema - Layout of one reply type
+//=============================================================================
+//
+//     Tag        - leading field ("PRICE"), or nullptr for untagged list
+//                  entries such as "id,state,filled,avgFill"
+//     Delimiter  - field separator
+//     Required   - fields after the tag that must be present; the rest are
+//                  optional (newer AddOns append fields) and left at their
+//                  default when missing
+//     Record     - output struct, reset before parsing
+//     Fields     - one descriptor per field after the tag
+//
+// Fields beyond the schema are ignored, so the AddOn can append new ones.
+
+template <const char* Tag, char Delimiter, size_t Required, typename Record, typename... Fields>
+class ReplySchema
+{
+    static_assert(Required <= sizeof...(Fields), "more required fields than declared");
+
+public:
+    using RecordType = Record;
+
+    static constexpr size_t FIELD_COUNT = sizeof...(Fields);
+
+    static constexpr std::string_view TagName()
+    {
+        if constexpr (Tag != nullptr) {
+            return std::string_view(Tag);
+        } else {
+            return std::string_view();
+        }
+    }
+
+    static bool Parse(std::string_view reply, Record& record)
+    {
+        record = Record();
+
+        Tokenizer tokens(reply, Delimiter);
+        std::string_view field;
+        if constexpr (Tag != nullptr) {
+            if (!tokens.Next(field) || field != TagName()) {
+                return false;
+            }
+        }
+
+        size_t index = 0;
+        bool ok = (ReadNext<Fields>(tokens, record, index) && ...);
+        return ok && index >= Required;
+    }
+
+private:
+    // Reads one field; a missing field ends the reply (index stays at the
+    // number read) and is only an error if it is required
+    template <typename FieldType>
+    static bool ReadNext(Tokenizer& tokens, Record& record, size_t& index)
+    {
+        std::string_view field;
+        if (!tokens.Next(field)) {
+            return index >= Required;
+        }
+        if (!FieldType::Read(field, record)) {
+            return false;
+        }
+        index++;
+        return true;
+    }
+};
+
+//=============================================================================
+// ReplyDispatcher - Tag dispatch through a compile-time perfect hash
+//=============================================================================
+//
+//     using Replies = ReplyDispatcher<QuoteSchema, AccountSchema>;
+//     Replies::Dispatch(reply, [](const auto& record) { ... });
+//
+// The seed of the tag hash is searched at compile time until every tag
+// lands in its own slot, so a reply is matched with one hash, one table
+// load and one string compare, however many schemas there are.
+
+constexpr uint32_t TagHash(std::string_view tag, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;   // FNV-1a
+    for (char c : tag) {
+        hash = (hash ^ (unsigned char)c) * 16777619u;
+    }
+    return hash;
+}
+
+template <typename... Schemas>
+class ReplyDispatcher
+{
+    static constexpr size_t COUNT = sizeof...(Schemas);
+
+    static constexpr size_t TableSize()
+    {
+        size_t size = 1;
+        while (size < 2 * COUNT) size <<= 1;
+        return size;
+    }
+
+    static constexpr size_t TABLE_SIZE = TableSize();
+    static constexpr std::array<std::string_view, COUNT> TAGS = { Schemas::TagName()... };
+
+    static constexpr bool Collides(uint32_t seed)
+    {
+        bool used[TABLE_SIZE] = {};
+        for (size_t i = 0; i < COUNT; i++) {
+            size_t slot = TagHash(TAGS[i], seed) & (TABLE_SIZE - 1);
+            if (used[slot]) return true;
+            used[slot] = true;
+        }
+        return false;
+    }
+
+    static constexpr uint32_t FindSeed()
+    {
+        uint32_t seed = 0;
+        while (Collides(seed)) seed++;
+        return seed;
+    }
+
+    static constexpr uint32_t SEED = FindSeed();
+
+    static constexpr std::array<int8_t, TABLE_SIZE> BuildSlots()
+    {
+        std::array<int8_t, TABLE_SIZE> slots = {};
+        for (size_t i = 0; i < TABLE_SIZE; i++) slots[i] = -1;
+        for (size_t i = 0; i < COUNT; i++) {
+            slots[TagHash(TAGS[i], SEED) & (TABLE_SIZE - 1)] = (int8_t)i;
+        }
+        return slots;
+    }
+
+    static constexpr std::array<int8_t, TABLE_SIZE> SLOTS = BuildSlots();
+
+    static_assert(COUNT > 0 && COUNT < 128, "dispatcher needs 1..127 schemas");
+
+public:
+    // Index of the schema whose tag starts 'reply', -1 if none
+    static int Find(std::string_view reply, char delimiter = ':')
+    {
+        std::string_view tag = reply.substr(0, reply.find(delimiter));
+        int index = SLOTS[TagHash(tag, SEED) & (TABLE_SIZE - 1)];
+        return (index >= 0 && TAGS[index] == tag) ? index : -1;
+    }
+
+    // Parse 'reply' with its schema and pass the record to handler(record).
+    // Returns false for unknown tags and malformed replies.
+    template <typename Handler>
+    static bool Dispatch(std::string_view reply, Handler&& handler)
+    {
+        return DispatchAt(Find(reply), reply, handler, std::index_sequence_for<Schemas...>());
+    }
+
+private:
+    template <typename Handler, size_t... I>
+    static bool DispatchAt(int index, std::string_view reply, Handler& handler, std::index_sequence<I...>)
+    {
+        bool parsed = false;
+        ((index == (int)I && (parsed = ParseWith<Schemas>(reply, handler))) || ...);
+        return parsed;
+    }
+
+    template <typename Schema, typename Handler>
+    static bool ParseWith(std::string_view reply, Handler& handler)
+    {
+        typename Schema::RecordType record;
+        if (!Schema::Parse(reply, record)) {
+            return false;
+        }
+        handler(record);
+        return true;
+    }
+};
+
+#endif // REPLYSCHEMA_H
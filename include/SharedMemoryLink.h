@@ -0,0 +1,115 @@
+// SharedMemoryLink.h - Shared-memory transport between plugin and AddOn
+// Copyright (c) 2025
+//
+// Plugin and AddOn always run on the same machine, so a BridgeChannel can
+// move its request/reply traffic off the loopback TCP stack into a pair of
+// memory-mapped single-producer/single-consumer byte rings:
+//
+//     request ring   plugin -> AddOn   "command\n" lines
+//     reply ring     AddOn  -> plugin  length-prefixed frames
+//
+// The rings carry exactly the bytes the TCP connection would, so framing
+// and codecs are unchanged. A side that finds its ring empty (or full)
+// spins briefly, then raises its 'waiting' flag and sleeps on a wakeup
+// object; the other side only signals when that flag is set, so a busy
+// link runs without any system call. The wakeup object is a named auto-
+// reset event on Windows and a futex on the flag word on Linux.
+//
+// Mapping layout (all fields uint32, little-endian, 64-byte separated):
+//     0    magic 'ZBSM', version, requestSize, replySize, closed
+//     64   request ring head (written by plugin), 128 tail (by AddOn)
+//     192  reply ring head (written by AddOn),    256 tail (by plugin)
+//     320  plugin waiting flag,                   384 AddOn waiting flag
+//     512  request data [requestSize], then reply data [replySize]
+// Head and tail are free-running byte counters; ring sizes are powers of 2.
+
+#pragma once
+
+#ifndef SHAREDMEMORYLINK_H
+#define SHAREDMEMORYLINK_H
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+//=============================================================================
+// SharedMemoryLink class - Socket-like byte stream over two mapped rings
+//=============================================================================
+
+class SharedMemoryLink
+{
+public:
+    static constexpr uint32_t MAGIC = 0x4D53425A;              // "ZBSM"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t HEADER_SIZE = 512;
+    static constexpr uint32_t DEFAULT_REQUEST_SIZE = 64 * 1024;
+    static constexpr uint32_t DEFAULT_REPLY_SIZE = 4 * 1024 * 1024;  // Large history replies stream through
+    static constexpr int MAX_NAME_LENGTH = 64;
+
+    SharedMemoryLink();
+    ~SharedMemoryLink();
+
+    // Plugin side: attach to a mapping created by the AddOn (SHM:OPEN reply)
+    bool Open(const char* name);
+
+    // AddOn side: create the mapping. The AddOn does this in C#; the C++
+    // version exists for stand-in peers when testing the plugin side.
+    bool Create(const char* name, uint32_t requestSize = DEFAULT_REQUEST_SIZE,
+                uint32_t replySize = DEFAULT_REPLY_SIZE);
+
+    void Close();
+    bool IsOpen() const { return m_base != nullptr; }
+    bool PeerClosed() const;
+
+    // Write all bytes, sleeping while the ring is full, for up to
+    // timeoutMs. A message that fits the ring goes in whole or not at all.
+    // Returns 'length', 0 if no room came free in time (nothing written),
+    // or -1 if the peer closed the link or stopped reading partway through
+    // a message longer than the ring (the stream is out of step then).
+    int Send(const char* data, size_t length, int timeoutMs);
+
+    // Read up to 'length' bytes ('waitAll': exactly 'length'). Returns the
+    // number of bytes read, 0 if nothing arrived within timeoutMs, or -1 if
+    // the peer closed the link.
+    int Recv(char* buffer, size_t length, bool waitAll, int timeoutMs);
+
+private:
+    struct Ring {
+        std::atomic<uint32_t>* head = nullptr;  // Producer position
+        std::atomic<uint32_t>* tail = nullptr;  // Consumer position
+        char* data = nullptr;
+        uint32_t size = 0;
+    };
+
+    char* m_base;             // Start of the mapping
+    size_t m_mappedSize;
+    bool m_server;            // Created the mapping (AddOn role)
+    Ring m_outgoing;          // Ring this side produces into
+    Ring m_incoming;          // Ring this side consumes from
+    std::atomic<uint32_t>* m_ownWaiting;    // Set while this side sleeps
+    std::atomic<uint32_t>* m_peerWaiting;   // Set while the peer sleeps
+    char m_name[MAX_NAME_LENGTH];
+
+#ifdef _WIN32
+    HANDLE m_mapping;
+    HANDLE m_ownEvent;        // Signalled by the peer to wake this side
+    HANDLE m_peerEvent;
+#else
+    int m_fd;
+#endif
+
+    bool Map(bool create, uint32_t requestSize, uint32_t replySize);
+    void Attach();
+    template <typename Ready>
+    bool Wait(Ready ready, int timeoutMs);
+    void WakePeer();
+    bool CanRead() const;
+    uint32_t WriteSpace() const;
+    uint32_t* Field(uint32_t offset) const { return (uint32_t*)(m_base + offset); }
+};
+
+#endif // SHAREDMEMORYLINK_H
@@ -0,0 +1,96 @@
+// SubscriptionRegistry.h - Market data subscriptions of the plugin
+// Copyright (c) 2025
+//
+// Every asset the plugin has subscribed with SUBSCRIBE, with its contract
+// specs and whether a price has arrived yet. BrokerAsset looks an asset up
+// here instead of re-sending SUBSCRIBE whenever Zorro switches to another
+// asset of the portfolio.
+//
+// The number of subscriptions is capped (SET_MAXASSETS) to stay within the
+// data lines of the NinjaTrader connection. Adding an asset beyond the cap
+// evicts the least recently used ones; the caller sends UNSUBSCRIBE for
+// each evicted name.
+
+#pragma once
+
+#ifndef SUBSCRIPTIONREGISTRY_H
+#define SUBSCRIPTIONREGISTRY_H
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//=============================================================================
+// Asset specification structure
+//=============================================================================
+
+struct AssetSpec {
+    double tickSize;      // Minimum price increment (pip size)
+    double pointValue;    // Dollar value per point (pip cost)
+
+    AssetSpec() : tickSize(0), pointValue(0) {}
+};
+
+//=============================================================================
+// Subscription entry
+//=============================================================================
+
+enum class SubscriptionState {
+    Subscribed,     // SUBSCRIBE acknowledged, no price seen yet
+    Live            // A price has arrived
+};
+
+struct Subscription {
+    std::string symbol;
+    AssetSpec spec;       // From the SUBSCRIBE reply; zero if the AddOn sent none
+    SubscriptionState state = SubscriptionState::Subscribed;
+    bool depth = false;   // SUBSCRIBEDEPTH sent (GET_BOOK)
+};
+
+//=============================================================================
+// SubscriptionRegistry class - Subscribed assets in LRU order
+//=============================================================================
+
+class SubscriptionRegistry
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 100;
+
+    explicit SubscriptionRegistry(size_t capacity = DEFAULT_CAPACITY);
+
+    // Subscribed asset, marked most recently used; nullptr if not subscribed
+    Subscription* Use(std::string_view symbol);
+
+    // Subscribed asset without changing the LRU order
+    const Subscription* Find(std::string_view symbol) const;
+
+    // Record an acknowledged SUBSCRIBE (or refresh an existing entry).
+    // Assets evicted to stay within the capacity are appended to 'evicted'.
+    Subscription& Add(std::string_view symbol, const AssetSpec& spec, std::vector<std::string>& evicted);
+
+    bool Remove(std::string_view symbol);
+
+    // At least 1. Shrinking evicts the least recently used assets.
+    void SetCapacity(size_t capacity, std::vector<std::string>& evicted);
+    size_t Capacity() const { return m_capacity; }
+
+    size_t Size() const { return m_index.size(); }
+    void Clear();
+
+    // All subscriptions, most recently used first
+    const std::list<Subscription>& Entries() const { return m_lru; }
+
+private:
+    using Entry = std::list<Subscription>::iterator;
+
+    std::list<Subscription> m_lru;                          // Front = most recently used
+    std::map<std::string, Entry, std::less<>> m_index;      // symbol -> entry
+    size_t m_capacity;
+
+    void Trim(std::vector<std::string>& evicted);
+};
+
+#endif // SUBSCRIPTIONREGISTRY_H
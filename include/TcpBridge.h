@@ -6,32 +6,95 @@
 #ifndef TCPBRIDGE_H
 #define TCPBRIDGE_H
 
-#define WIN32_LEAN_AND_MEAN
-#include <windows.h>
-#include <winsock2.h>
-#include <ws2tcpip.h>
+#include <chrono>
 #include <string>
-#include <vector>
+#include <string_view>
 
-#pragma comment(lib, "ws2_32.lib")
+#include "BridgeChannel.h"
+#include "CommandWriter.h"
+#include "QuoteStream.h"
+#include "Tokenizer.h"
+#include "Transport.h"
+#include "WireCodec.h"
 
 //=============================================================================
-// TcpBridge class - Communicates with NinjaTrader 8.1+ via TCP
+// BasicTcpBridge class - Communicates with NinjaTrader 8.1+ via TCP
 //=============================================================================
+//
+// Transport (Transport.h) carries the bytes, CodecPolicy (TextCodec,
+// BinaryCodec or AdaptiveCodec from WireCodec.h) decides which reply codec
+// is negotiated and decodes the replies. Both are resolved at compile time.
+// The plugin uses TcpBridge, the default instantiation below; the others
+// are instantiated in TcpBridge.cpp for tests and benchmarks.
 
-class TcpBridge
+template <typename Transport, typename CodecPolicy>
+class BasicTcpBridge
 {
+    using Channel = BasicBridgeChannel<Transport>;
+    
 public:
-    TcpBridge();
-    ~TcpBridge();
+    // Each traffic class has its own connection (see BridgeChannel.h)
+    enum class TrafficClass { Orders, Data, History };
+    
+    static constexpr int STREAM_RETRY_MS = 5000;   // See ResumeStreaming
+    
+    // Reply deadlines per command class, in milliseconds. A command that
+    // misses its deadline gets "ERROR:Timeout" (see IsTimeout).
+    struct Timeouts {
+        int quote = 1000;       // GETPRICE/GETPRICES - stale after that anyway
+        int data = 5000;        // Login, account, positions, order status
+        int order = 10000;      // PLACEORDER/CANCELORDER
+        int history = 45000;    // The AddOn waits up to 30 s for NinjaTrader bars
+    };
+    
+    BasicTcpBridge();
+    ~BasicTcpBridge();
     
     bool Connect(const char* host = "127.0.0.1", int port = 8888);
     void Disconnect();
-    bool IsConnected() const { return m_connected; }
+    bool IsConnected() const { return m_dataChannel.IsOpen(); }
+    bool IsFramed() const { return m_dataChannel.IsFramed(); }  // Length-prefixed replies negotiated
+    bool IsTagged() const { return m_dataChannel.IsTagged(); }  // Replies may complete out of order
+    bool HasChannel(TrafficClass traffic) const;                // Dedicated connection open
+    
+    // Reply codec negotiated on Connect(), as chosen by CodecPolicy.
+    // Instantiate with TextCodec to keep readable replies for debugging.
+    Codec GetCodec() const { return m_dataChannel.GetCodec(); }
+    
+    // Shared-memory transport (see SharedMemoryLink.h), used when the AddOn
+    // offers it. Disable before connecting to force loopback TCP.
+    void SetSharedMemory(bool enable) { m_sharedMemory = enable; }
+    bool IsSharedMemory() const { return m_dataChannel.IsSharedMemory(); }
+    
+    void SetTimeouts(const Timeouts& timeouts) { m_timeouts = timeouts; }
+    const Timeouts& GetTimeouts() const { return m_timeouts; }
+    
+    // The reply is the timeout error, not an answer from the AddOn. The
+    // connection stays usable; the late reply is dropped when it arrives.
+    static bool IsTimeout(std::string_view reply) { return reply == Channel::TIMEOUT_REPLY; }
+    
+    // The AddOn doesn't know the command ("ERROR:Unknown command: VERB") -
+    // an older AddOn; asking again won't help
+    static bool IsUnknownCommand(std::string_view reply)
+    {
+        return reply.compare(0, 21, "ERROR:Unknown command") == 0;
+    }
     
     // Low-level command interface (public for direct use)
-    std::string SendCommand(const std::string& command);
-    std::vector<std::string> SplitResponse(const std::string& response, char delimiter);  // Now public
+    // The command is routed by its verb to the matching connection. The
+    // returned view points into that connection's receive buffer and stays
+    // valid until the next command on it - copy it to keep it.
+    std::string_view SendCommand(std::string_view command);
+    std::string_view SendCommand(TrafficClass traffic, std::string_view command);
+    
+    // Pipelined commands: all 'count' commands are written with one send(),
+    // then the replies are read back in order into 'replies'. Costs about
+    // one round trip instead of 'count'. Returns the number of replies
+    // received; missing replies are set to the error text. Views stay
+    // valid until the next SendCommand()/SendBatch() call. All commands of
+    // a batch go to the connection of the first one, with the longest
+    // deadline among them.
+    size_t SendBatch(const std::string_view* commands, size_t count, std::string_view* replies);
     
     // Connection
     int Connected(int showMessage = 0);
@@ -42,19 +105,75 @@ public:
     int UnSubscribeMarketData(const char* instrument);
     double MarketData(const char* instrument, int dataType);
     
-    // Convenience market data functions
+    // Complete quote in one step: the streamed quote if the push channel
+    // has one, otherwise a single GETPRICE. Returns false if neither
+    // delivered a quote (timeout, unknown instrument, malformed reply).
+    bool GetQuote(const char* instrument, Quote& quote);
+    
+    // Quotes of 'count' subscribed instruments in one GETPRICES round trip.
+    // On success 'entries' walks the reply list, read with NextQuote(); the
+    // views are valid until the next command. Instruments the AddOn has no
+    // subscription for are left out. Returns false on timeout or an error
+    // reply (AddOns before this command only know GETPRICE); 'entries'
+    // then holds the reply itself, see entries.Rest().
+    bool Quotes(const std::string* instruments, size_t count, Tokenizer& entries);
+    static bool NextQuote(Tokenizer& entries, std::string_view& instrument, Quote& quote);
+    
+    // Push quotes (second connection, see QuoteStream.h)
+    bool IsStreaming() const { return m_quoteStream.IsRunning(); }
+    
+    // Restart the push channel if its connection dropped while the bridge
+    // stayed connected. Tries at most every STREAM_RETRY_MS, and only if
+    // the channel ran before. Returns true if this call restarted it -
+    // instruments subscribed meanwhile need WatchQuotes() then.
+    bool ResumeStreaming();
+    bool WatchQuotes(const char* instrument) { return m_quoteStream.Watch(instrument); }
+    void UnwatchQuotes(const char* instrument) { m_quoteStream.Unwatch(instrument); }
+    bool StreamedQuote(const char* instrument, Quote& quote) const { return m_quoteStream.Latest(instrument, quote); }
+    bool NextPushedQuote(PushedQuote& update) { return m_quoteStream.NextUpdate(update); }
+    
+    // Order book (push channel): SUBSCRIBEDEPTH starts the DEPTH lines of
+    // a subscribed instrument; Book() copies its best rows per side
+    int SubscribeDepth(const char* instrument);
+    int Book(const char* instrument, int levels, T2* quotes, int maxQuotes) const
+    {
+        return m_quoteStream.Book(instrument, levels, quotes, maxQuotes);
+    }
+    
+    // Reply parsers - use these on replies obtained from SendBatch()
+    bool ParseQuote(std::string_view response, Quote& quote);         // PRICE:last:bid:ask:volume
+    double ParseMarketData(std::string_view response, int dataType);  // One field of the same
+    bool ParseAccount(std::string_view response, AccountRecord& record);  // ACCOUNT:cash:bp:realized:unrealized
+    double ParseAccount(std::string_view response, int field);        // 0=Cash 1=BuyingPower 2=Realized 3=Unrealized
+    int ParseFilled(std::string_view response);                       // ORDERSTATUS:id:state:filled:avgFill
+    double ParseAvgFillPrice(std::string_view response);
+    const char* ParseOrderStatus(std::string_view response);
+    
+    // Convenience market data functions - one GETPRICE each; use
+    // GetQuote() when more than one field is needed
     double GetLast(const char* instrument)    { return MarketData(instrument, 0); }
     double GetBid(const char* instrument)     { return MarketData(instrument, 1); }
     double GetAsk(const char* instrument)     { return MarketData(instrument, 2); }
     double GetVolume(const char* instrument)  { return MarketData(instrument, 3); }
     
     // Account
+    // All account values from one GETACCOUNT. Returns false on timeout or
+    // a malformed reply. The AddOn reports the account it is logged in to.
+    bool GetAccount(const char* account, AccountRecord& record);
     double CashValue(const char* account);
     double BuyingPower(const char* account);
     double RealizedPnL(const char* account);
     double UnrealizedPnL(const char* account);  // NEW: Get unrealized P&L from open positions
     
     // Position
+    // Every non-flat position in one GETPOSITIONS round trip. On success
+    // 'entries' walks the reply list, read with NextPosition(); the views
+    // are valid until the next command. Returns false on timeout or an
+    // error reply (AddOns before this command only know GETPOSITION);
+    // 'entries' then holds the reply itself, see entries.Rest().
+    bool Positions(Tokenizer& entries);
+    static bool NextPosition(Tokenizer& entries, std::string_view& instrument, PositionRecord& position);
+    bool GetPosition(const char* instrument, PositionRecord& position);  // One GETPOSITION
     int MarketPosition(const char* instrument, const char* account);
     double AvgEntryPrice(const char* instrument, const char* account);
     
@@ -67,6 +186,16 @@ public:
                 const char* oco, const char* orderId, const char* strategyId,
                 const char* strategyName);
     
+    // Bulk order status (GETORDERSTATUSES): state, fill quantity and fill
+    // price of all 'count' orders in one round trip. On success 'entries'
+    // walks the reply list, read with NextOrderStatus(); the views are
+    // valid until the next command. Returns false on timeout or an error
+    // reply (AddOns before this command answer "ERROR:Unknown command");
+    // 'entries' then holds the reply itself, see entries.Rest().
+    bool OrderStatuses(const std::string* orderIds, size_t count, Tokenizer& entries);
+    bool GetOrderStatus(const char* orderId, OrderStatusRecord& status);  // One GETORDERSTATUS
+    static bool NextOrderStatus(Tokenizer& entries, std::string_view& orderId, OrderStatusRecord& status);
+    
     int Filled(const char* orderId);
     double AvgFillPrice(const char* orderId);
     const char* OrderStatus(const char* orderId);
@@ -86,16 +215,33 @@ public:
     int ClosePosition(const char* account, const char* instrument);
 
 private:
-    SOCKET m_socket;
-    bool m_connected;
-    std::string m_lastResponse;
+    Channel m_orderChannel;       // PLACEORDER/CANCELORDER (optional)
+    Channel m_dataChannel;        // Everything else; required
+    Channel m_historyChannel;     // GETHISTORY/GETINSTRUMENTS (optional)
+    bool m_sharedMemory;          // Request shared memory on Connect()
+    Timeouts m_timeouts;
+    CommandWriter m_command;      // Builds every command except the GETORDERSTATUSES list
+    CommandPrefixes m_orderPrefixes;  // "PLACEORDER:BUY:instrument" etc., per asset
+    std::string m_commandBuffer;  // GETPRICES/GETORDERSTATUSES lists (may exceed CommandWriter::CAPACITY)
+    BasicQuoteStream<Transport> m_quoteStream;    // Push channel for quotes (optional)
+    std::string m_host;           // Of the last Connect(), for ResumeStreaming
+    int m_port;
+    bool m_streamWanted;          // The push channel was started on Connect()
+    std::chrono::steady_clock::time_point m_streamRetry;  // Next restart attempt
     char m_orderIdBuffer[64];
     int m_nextOrderId;
     std::string m_lastNtOrderId;  // Store NT order ID from last PLACEORDER
     
     // Communication helpers
-    bool InitializeWinsock();
-    void CleanupWinsock();
+    bool OpenChannel(Channel& channel, const char* host, int port);
+    static TrafficClass Classify(std::string_view command);
+    int TimeoutFor(TrafficClass traffic, std::string_view command) const;
+    Channel& Route(TrafficClass traffic);
+    std::string_view BuildCommand(const char* verb, const char* argument);
 };
 
+extern template class BasicTcpBridge<DefaultTransport, AdaptiveCodec>;
+
+using TcpBridge = BasicTcpBridge<DefaultTransport, AdaptiveCodec>;
+
 #endif // TCPBRIDGE_H
@@ -0,0 +1,122 @@
+// TickRecorder.h - Recording of observed quotes to Zorro T1 files
+// Copyright (c) 2025
+//
+// Optional capture of the live quotes the plugin sees, for later tick
+// backtests. Every quote update is appended as T1 ticks (ask positive,
+// bid negative) to one file per asset and UTC day:
+//
+//     {folder}/{Asset}_{YYYYMMDD}.t1
+//
+// The trading thread only pushes a fixed-size record into a single-
+// producer/single-consumer ring; it never touches the disk. A background
+// thread drains the ring and appends the ticks to memory-mapped files that
+// are preallocated and grow by doubling. A file is finalized - truncated
+// to its ticks and reversed to Zorro's newest-first order - when its day
+// ends, when it has been idle for a while, or when the recorder stops.
+// A file left unfinalized by a crash is repaired when it is reopened.
+//
+// If the ring is full the update is dropped (and counted) rather than
+// blocking the trading thread.
+
+#pragma once
+
+#ifndef TICKRECORDER_H
+#define TICKRECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "trading.h"        // DATE, T1
+
+//=============================================================================
+// TickRecorder class - SPSC queue plus mapped T1 writer thread
+//=============================================================================
+
+class TickRecorder
+{
+public:
+    static constexpr size_t QUEUE_CAPACITY = 1 << 16;          // Updates in flight; power of 2
+    static constexpr int MAX_SYMBOL_LENGTH = 48;
+    static constexpr size_t INITIAL_FILE_TICKS = 1 << 16;      // First mapping, grows by doubling
+    static constexpr int IDLE_FINALIZE_SECONDS = 60;
+
+    TickRecorder();
+    ~TickRecorder();
+
+    TickRecorder(const TickRecorder&) = delete;
+    TickRecorder& operator=(const TickRecorder&) = delete;
+
+    // Start the writer thread, recording into 'folder' (created if missing).
+    // A running recorder is stopped first.
+    bool Start(const char* folder);
+
+    // Drain the queue, finalize all files, stop the writer thread
+    void Stop();
+
+    bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    // Queue one quote update (trading thread only). 'time' is the UTC DATE
+    // of the update, 0 for now. Sides <= 0, and sides unchanged since the
+    // previous update of the asset, are not recorded. Returns false if the
+    // update was dropped.
+    bool Record(std::string_view symbol, DATE time, double bid, double ask);
+
+    uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // One queued update; a cache line each
+    struct Update {
+        char symbol[MAX_SYMBOL_LENGTH];
+        DATE time;
+        float bid;
+        float ask;
+    };
+
+    // The open day file of one asset, owned by the writer thread
+    struct TickFile {
+        int day = 0;                  // YYYYMMDD
+        T1* ticks = nullptr;          // Mapped ticks, oldest first while open
+        size_t count = 0;
+        size_t capacity = 0;
+        float lastBid = 0;            // Previous sides, to record changes only
+        float lastAsk = 0;
+        DATE lastTime = 0;
+        std::chrono::steady_clock::time_point used;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = NULL;
+#else
+        int fd = -1;
+#endif
+    };
+
+    std::unique_ptr<Update[]> m_queue;
+    alignas(64) std::atomic<size_t> m_head;     // Written by the trading thread
+    alignas(64) std::atomic<size_t> m_tail;     // Written by the writer thread
+    alignas(64) std::atomic<bool> m_running;
+    std::atomic<uint64_t> m_dropped;
+
+    std::thread m_writer;
+    std::string m_folder;
+    std::map<std::string, TickFile, std::less<>> m_files;   // Writer thread only
+
+    void WriterLoop();
+    bool Drain();
+    void Append(const Update& update);
+    void FinalizeIdle();
+
+    bool OpenFile(TickFile& file, std::string_view symbol, int day);
+    bool Grow(TickFile& file, size_t capacity);
+    bool Map(TickFile& file, size_t capacity);
+    void Unmap(TickFile& file);
+    void Finalize(TickFile& file);
+};
+
+#endif // TICKRECORDER_H
@@ -0,0 +1,105 @@
+// Tokenizer.h - Zero-copy field splitting for text replies
+// Copyright (c) 2025
+//
+// Text replies are colon/pipe/comma delimited (PRICE:last:bid:ask:volume,
+// HISTORY:n|time,o,h,l,c,v|...). Both helpers here hand out fields as
+// std::string_view into the reply itself - usually the connection's
+// receive buffer - so splitting never allocates:
+//
+//     Tokenizer   - walks the fields one at a time; for replies with an
+//                   open-ended number of fields (history bars)
+//     Fields<N>   - splits into a fixed-capacity array; for the short
+//                   replies with a known layout
+//
+// The views are only valid as long as the text they point into.
+
+#pragma once
+
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <cstddef>
+#include <string_view>
+
+//=============================================================================
+// Tokenizer - Forward iteration over delimited fields
+//=============================================================================
+
+class Tokenizer
+{
+public:
+    Tokenizer(std::string_view text, char delimiter)
+        : m_rest(text)
+        , m_delimiter(delimiter)
+        , m_done(text.empty())
+    {
+    }
+
+    // Next field, which may be empty ("a::b" has an empty middle field).
+    // Returns false once all fields have been returned.
+    bool Next(std::string_view& field)
+    {
+        if (m_done) {
+            return false;
+        }
+
+        size_t end = m_rest.find(m_delimiter);
+        if (end == std::string_view::npos) {
+            field = m_rest;
+            m_rest = std::string_view();
+            m_done = true;
+        } else {
+            field = m_rest.substr(0, end);
+            m_rest.remove_prefix(end + 1);
+        }
+        return true;
+    }
+
+    // Text after the last field returned
+    std::string_view Rest() const { return m_rest; }
+
+private:
+    std::string_view m_rest;
+    char m_delimiter;
+    bool m_done;
+};
+
+//=============================================================================
+// Fields - Fixed-capacity split for short replies
+//=============================================================================
+//
+//     Fields<5> parts("PRICE:1.5:1.4:1.6:100", ':');
+//     if (parts.Size() >= 5 && parts[0] == "PRICE") ...
+//
+// Fields beyond the capacity are not stored; Truncated() reports them.
+
+template <size_t N>
+class Fields
+{
+public:
+    Fields(std::string_view text, char delimiter)
+        : m_count(0)
+        , m_truncated(false)
+    {
+        Tokenizer tokens(text, delimiter);
+        std::string_view field;
+        while (tokens.Next(field)) {
+            if (m_count == N) {
+                m_truncated = true;
+                break;
+            }
+            m_fields[m_count++] = field;
+        }
+    }
+
+    size_t Size() const { return m_count; }
+    bool Truncated() const { return m_truncated; }
+    std::string_view operator[](size_t index) const { return m_fields[index]; }
+
+private:
+    std::string_view m_fields[N];
+    size_t m_count;
+    bool m_truncated;
+};
+
+#endif // TOKENIZER_H
@@ -0,0 +1,760 @@
+// Transport.h - Byte stream transports for the bridge (compile-time policies)
+// Copyright (c) 2025
+//
+// BasicTcpBridge, BasicBridgeChannel and BasicQuoteStream take the transport
+// as a template parameter, so every call below compiles to a direct call -
+// there is no virtual dispatch on the request path. A transport provides:
+//
+//     static bool Startup();             // Once per process user (WSAStartup)
+//     static void Cleanup();
+//     bool Connect(const char* host, int port);
+//     void Shutdown();                   // Unblock a Recv() in another thread
+//     void Close();
+//     bool IsOpen() const;
+//     int  Send(const char* data, int length);              // > 0 bytes sent
+//     int  Recv(char* buffer, int length, bool waitAll);    // > 0 bytes, else failed
+//     bool Alive();                      // Zero-timeout check for a closed peer
+//     bool SetNonBlocking(bool enable);  // Send/Recv return WOULD_BLOCK instead of waiting
+//     int  Wait(bool forWrite, int timeoutMs);  // 1 ready, 0 timed out, -1 failed
+//
+// In non-blocking mode 'waitAll' must be false.
+//
+// Implementations:
+//     WinsockTransport   - TCP via Winsock (Windows, the plugin default)
+//     PosixTcpTransport  - TCP via BSD sockets (Linux builds of the core)
+//     LoopbackTransport  - in-process peer (LoopbackServer), no sockets;
+//                          for benchmarks and tests of the bridge itself
+
+#pragma once
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Send()/Recv() result of a non-blocking transport that isn't ready
+constexpr int WOULD_BLOCK = -2;
+
+#ifdef _WIN32
+
+//=============================================================================
+// WinsockTransport - TCP via Winsock
+//=============================================================================
+
+class WinsockTransport
+{
+public:
+    static bool Startup()
+    {
+        WSADATA wsaData;
+        return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+    }
+
+    static void Cleanup()
+    {
+        WSACleanup();
+    }
+
+    bool Connect(const char* host, int port)
+    {
+        Close();
+
+        m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (m_socket == INVALID_SOCKET) {
+            return false;
+        }
+
+        sockaddr_in serverAddr;
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_port = htons(port);
+        inet_pton(AF_INET, host, &serverAddr.sin_addr);
+
+        if (connect(m_socket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Shutdown()
+    {
+        if (m_socket != INVALID_SOCKET) {
+            shutdown(m_socket, SD_BOTH);
+        }
+    }
+
+    void Close()
+    {
+        if (m_socket != INVALID_SOCKET) {
+            closesocket(m_socket);
+            m_socket = INVALID_SOCKET;
+        }
+    }
+
+    bool IsOpen() const { return m_socket != INVALID_SOCKET; }
+
+    int Send(const char* data, int length)
+    {
+        int sent = send(m_socket, data, length, 0);
+        return (sent == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK) ? WOULD_BLOCK : sent;
+    }
+
+    int Recv(char* buffer, int length, bool waitAll)
+    {
+        int received = recv(m_socket, buffer, length, waitAll ? MSG_WAITALL : 0);
+        return (received == SOCKET_ERROR && WSAGetLastError() == WSAEWOULDBLOCK) ? WOULD_BLOCK : received;
+    }
+
+    bool SetNonBlocking(bool enable)
+    {
+        u_long mode = enable ? 1 : 0;
+        return ioctlsocket(m_socket, FIONBIO, &mode) == 0;
+    }
+
+    int Wait(bool forWrite, int timeoutMs)
+    {
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(m_socket, &set);
+        timeval timeout = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+
+        int ready = forWrite ? select(0, nullptr, &set, nullptr, &timeout)
+                             : select(0, &set, nullptr, nullptr, &timeout);
+        return ready > 0 ? 1 : ready;
+    }
+
+    // A readable socket with nothing to read has been closed by the peer
+    bool Alive()
+    {
+        fd_set readSet;
+        FD_ZERO(&readSet);
+        FD_SET(m_socket, &readSet);
+        timeval timeout = { 0, 0 };
+
+        int ready = select(0, &readSet, nullptr, nullptr, &timeout);
+        if (ready == 0) {
+            return true;
+        }
+
+        char probe;
+        return ready > 0 && recv(m_socket, &probe, 1, MSG_PEEK) > 0;
+    }
+
+private:
+    SOCKET m_socket = INVALID_SOCKET;
+};
+
+using DefaultTransport = WinsockTransport;
+
+#else
+
+//=============================================================================
+// PosixTcpTransport - TCP via BSD sockets
+//=============================================================================
+
+class PosixTcpTransport
+{
+public:
+    static bool Startup() { return true; }
+    static void Cleanup() {}
+
+    bool Connect(const char* host, int port)
+    {
+        Close();
+
+        m_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (m_fd < 0) {
+            return false;
+        }
+
+        sockaddr_in serverAddr = {};
+        serverAddr.sin_family = AF_INET;
+        serverAddr.sin_port = htons(port);
+        inet_pton(AF_INET, host, &serverAddr.sin_addr);
+
+        if (connect(m_fd, (sockaddr*)&serverAddr, sizeof(serverAddr)) != 0) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void Shutdown()
+    {
+        if (m_fd >= 0) {
+            shutdown(m_fd, SHUT_RDWR);
+        }
+    }
+
+    void Close()
+    {
+        if (m_fd >= 0) {
+            close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    bool IsOpen() const { return m_fd >= 0; }
+
+    int Send(const char* data, int length)
+    {
+        int sent = (int)send(m_fd, data, length, MSG_NOSIGNAL);
+        return (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) ? WOULD_BLOCK : sent;
+    }
+
+    int Recv(char* buffer, int length, bool waitAll)
+    {
+        int received = (int)recv(m_fd, buffer, length, waitAll ? MSG_WAITALL : 0);
+        return (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) ? WOULD_BLOCK : received;
+    }
+
+    bool SetNonBlocking(bool enable)
+    {
+        int flags = fcntl(m_fd, F_GETFL, 0);
+        if (flags < 0) {
+            return false;
+        }
+        flags = enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+        return fcntl(m_fd, F_SETFL, flags) == 0;
+    }
+
+    int Wait(bool forWrite, int timeoutMs)
+    {
+        pollfd entry = { m_fd, (short)(forWrite ? POLLOUT : POLLIN), 0 };
+        int ready = poll(&entry, 1, timeoutMs);
+        if (ready < 0 && errno == EINTR) {
+            return 0;  // Caller re-checks its deadline
+        }
+        return ready > 0 ? 1 : ready;
+    }
+
+    bool Alive()
+    {
+        pollfd entry = { m_fd, POLLIN, 0 };
+        int ready = poll(&entry, 1, 0);
+        if (ready == 0) {
+            return true;
+        }
+
+        char probe;
+        return ready > 0 && recv(m_fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT) > 0;
+    }
+
+private:
+    int m_fd = -1;
+};
+
+using DefaultTransport = PosixTcpTransport;
+
+#endif // _WIN32
+
+//=============================================================================
+// LoopbackServer / LoopbackTransport - In-process peer without sockets
+//=============================================================================
+//
+// A LoopbackServer registers a request handler under a port number;
+// LoopbackTransport::Connect() to that port talks to it directly. Each
+// complete request line is answered synchronously inside Send(), with the
+// same newline/length-prefixed framing the AddOn uses (the server handles
+// VERSION:FRAMED itself). The handler sees every other command line.
+//
+// Tests can make the stand-in behave like a real socket peer: replies may
+// be handed out in small random pieces (SetSegmentation), as TCP delivers
+// them, held back to simulate a slow AddOn (SetReplyDelay), and a raw
+// server writes the handler's reply bytes unchanged, so a test can put
+// malformed frames on the wire (SetRawReplies). SetFraming(false) makes it
+// an older AddOn without length-prefixed replies; SetTags(true) makes it
+// accept TAGS:ON, after which requests carry "#<tag> " and reply frames
+// the tag, and delayed replies no longer wait behind each other. These
+// apply to connections made afterwards.
+//
+// A connection whose STREAM request the handler acknowledges with "OK:"
+// becomes a push channel: Publish() writes a line to every such
+// connection, DropStreams() closes them as if the AddOn went away.
+// The server must outlive its connections.
+
+class LoopbackTransport;
+
+class LoopbackServer
+{
+public:
+    using Handler = std::function<std::string(std::string_view request)>;
+
+    LoopbackServer(int port, Handler handler)
+        : m_port(port)
+        , m_handler(std::move(handler))
+    {
+        std::lock_guard<std::mutex> lock(Registry().mutex);
+        Registry().servers[port] = this;
+    }
+
+    ~LoopbackServer()
+    {
+        std::lock_guard<std::mutex> lock(Registry().mutex);
+        Registry().servers.erase(m_port);
+    }
+
+    LoopbackServer(const LoopbackServer&) = delete;
+    LoopbackServer& operator=(const LoopbackServer&) = delete;
+
+    static LoopbackServer* Find(int port)
+    {
+        std::lock_guard<std::mutex> lock(Registry().mutex);
+        auto it = Registry().servers.find(port);
+        return it != Registry().servers.end() ? it->second : nullptr;
+    }
+
+    std::string Handle(std::string_view request) { return m_handler(request); }
+
+    // Hand replies out in pieces of 1..maxSegment bytes (0 = as available).
+    // The sizes are random but repeat for the same seed.
+    void SetSegmentation(size_t maxSegment, uint32_t seed = 1)
+    {
+        m_maxSegment = maxSegment;
+        m_seed = seed ? seed : 1;
+    }
+    size_t MaxSegment() const { return m_maxSegment; }
+    uint32_t Seed() const { return m_seed; }
+
+    // Write handler replies unframed and without newline - the handler
+    // produces the exact bytes (VERSION:FRAMED is still answered here)
+    void SetRawReplies(bool raw) { m_raw = raw; }
+    bool RawReplies() const { return m_raw; }
+
+    // Answer VERSION:FRAMED like an older AddOn ("VERSION:1.0"), so the
+    // connection keeps newline-terminated replies
+    void SetFraming(bool supported) { m_framing = supported; }
+    bool Framing() const { return m_framing; }
+
+    // Answer TAGS:ON on a framed connection like the AddOn ("OK:Tags"),
+    // instead of passing it to the handler. The handler then sees requests
+    // without their tag, and replies carry it in an 8-byte frame header.
+    void SetTags(bool supported) { m_tags = supported; }
+    bool Tags() const { return m_tags; }
+
+    // Hold replies to requests starting with 'prefix' back for 'delayMs'.
+    // Replies stay in request order, so later ones wait behind them -
+    // except on a tagged connection, where each is due after its own delay.
+    void SetReplyDelay(std::string_view prefix, int delayMs) { m_delays[std::string(prefix)] = delayMs; }
+    const std::map<std::string, int>& ReplyDelays() const { return m_delays; }
+
+    // Push channels (see above)
+    inline void Publish(std::string_view line);
+    inline void DropStreams();
+    inline size_t StreamCount();
+
+private:
+    friend class LoopbackTransport;
+
+    struct ServerMap {
+        std::mutex mutex;
+        std::map<int, LoopbackServer*> servers;
+    };
+
+    static ServerMap& Registry()
+    {
+        static ServerMap registry;
+        return registry;
+    }
+
+    int m_port;
+    Handler m_handler;
+    size_t m_maxSegment = 0;
+    uint32_t m_seed = 1;
+    bool m_raw = false;
+    bool m_framing = true;
+    bool m_tags = false;
+    std::map<std::string, int> m_delays;
+
+    std::mutex m_streamMutex;         // Taken before a connection's own mutex
+    std::vector<LoopbackTransport*> m_streams;
+
+    void AddStream(LoopbackTransport* stream)
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_streams.push_back(stream);
+    }
+
+    void RemoveStream(LoopbackTransport* stream)
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        for (size_t i = 0; i < m_streams.size(); i++) {
+            if (m_streams[i] == stream) {
+                m_streams.erase(m_streams.begin() + i);
+                break;
+            }
+        }
+    }
+};
+
+class LoopbackTransport
+{
+public:
+    static bool Startup() { return true; }
+    static void Cleanup() {}
+
+    bool Connect(const char* /*host*/, int port)   // Port selects the LoopbackServer
+    {
+        Close();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_server = LoopbackServer::Find(port);
+        m_framed = false;
+        m_tagged = false;
+        m_nonBlocking = false;
+        m_closed = (m_server == nullptr);
+        if (m_server) {
+            m_maxSegment = m_server->MaxSegment();
+            m_random = m_server->Seed();
+            m_raw = m_server->RawReplies();
+            m_framing = m_server->Framing();
+            m_tags = m_server->Tags();
+            m_delays = m_server->ReplyDelays();
+        }
+        return m_server != nullptr;
+    }
+
+    void Shutdown()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_ready.notify_all();
+    }
+
+    void Close()
+    {
+        Shutdown();
+
+        bool streaming;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            streaming = m_streaming;
+        }
+        if (streaming) {
+            m_server->RemoveStream(this);   // Without holding m_mutex (lock order)
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_server = nullptr;
+        m_streaming = false;
+        m_input.clear();
+        m_output.clear();
+        m_delayed.clear();
+        m_readPos = 0;
+    }
+
+    bool IsOpen() const { return m_server != nullptr; }
+
+    int Send(const char* data, int length)
+    {
+        bool stream = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_closed || !m_server) {
+                return -1;
+            }
+
+            // Answer every complete line right away
+            m_input.append(data, length);
+            size_t start = 0, newline;
+            while ((newline = m_input.find('\n', start)) != std::string::npos) {
+                std::string_view request(m_input.data() + start, newline - start);
+                if (!request.empty() && request.back() == '\r') {
+                    request.remove_suffix(1);
+                }
+                stream |= Reply(request);
+                start = newline + 1;
+            }
+            m_input.erase(0, start);
+
+            m_ready.notify_all();
+        }
+
+        if (stream) {
+            m_server->AddStream(this);
+        }
+        return length;
+    }
+
+    int Recv(char* buffer, int length, bool waitAll)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Release();
+        if (m_nonBlocking && !m_closed && m_output.size() == m_readPos) {
+            return WOULD_BLOCK;
+        }
+
+        size_t wanted = waitAll ? (size_t)length : 1;
+        for (;;) {
+            Release();
+            if (m_closed || m_output.size() - m_readPos >= wanted) {
+                break;
+            }
+            if (m_delayed.empty()) {
+                m_ready.wait(lock);
+            } else {
+                m_ready.wait_until(lock, m_delayed.front().due);
+            }
+        }
+        if (m_output.size() == m_readPos) {
+            return 0;  // Closed
+        }
+
+        size_t n = m_output.size() - m_readPos;
+        if (n > (size_t)length) n = (size_t)length;
+        if (m_maxSegment > 0 && !waitAll) {
+            size_t segment = NextSegment();
+            if (n > segment) n = segment;
+        }
+        memcpy(buffer, m_output.data() + m_readPos, n);
+        m_readPos += n;
+        if (m_readPos == m_output.size()) {
+            m_output.clear();
+            m_readPos = 0;
+        }
+        return (int)n;
+    }
+
+    bool Alive()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return !m_closed;
+    }
+
+    bool SetNonBlocking(bool enable)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nonBlocking = enable;
+        return true;
+    }
+
+    // Sends never wait; replies are ready once the server has produced them
+    // (and their delay, if any, has passed)
+    int Wait(bool forWrite, int timeoutMs)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (forWrite) {
+            return m_closed ? -1 : 1;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        for (;;) {
+            Release();
+            if (m_closed || m_output.size() > m_readPos) {
+                return 1;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return 0;
+            }
+            auto wakeup = deadline;
+            if (!m_delayed.empty() && m_delayed.front().due < wakeup) {
+                wakeup = m_delayed.front().due;
+            }
+            m_ready.wait_until(lock, wakeup);
+        }
+    }
+
+private:
+    friend class LoopbackServer;
+
+    // A reply held back by SetReplyDelay
+    struct DelayedReply {
+        std::chrono::steady_clock::time_point due;
+        std::string bytes;
+    };
+
+    LoopbackServer* m_server = nullptr;
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::string m_input;          // Partial request line
+    std::string m_output;         // Replies not yet received
+    std::deque<DelayedReply> m_delayed;
+    size_t m_readPos = 0;
+    bool m_framed = false;
+    bool m_tagged = false;        // TAGS:ON acknowledged (needs SetTags)
+    bool m_nonBlocking = false;
+    bool m_closed = true;
+    bool m_streaming = false;     // Push channel (see LoopbackServer)
+    bool m_raw = false;           // Server settings, taken on Connect()
+    bool m_framing = true;
+    bool m_tags = false;
+    size_t m_maxSegment = 0;
+    uint32_t m_random = 1;
+    std::map<std::string, int> m_delays;
+
+    // Size of the next piece handed to Recv() - xorshift32
+    size_t NextSegment()
+    {
+        m_random ^= m_random << 13;
+        m_random ^= m_random >> 17;
+        m_random ^= m_random << 5;
+        return 1 + m_random % m_maxSegment;
+    }
+
+    // Move delayed replies that are due into the output (m_mutex held)
+    void Release()
+    {
+        auto now = std::chrono::steady_clock::now();
+        while (!m_delayed.empty() && m_delayed.front().due <= now) {
+            m_output += m_delayed.front().bytes;
+            m_delayed.pop_front();
+        }
+    }
+
+    int DelayFor(std::string_view request) const
+    {
+        for (const auto& delay : m_delays) {
+            if (request.compare(0, delay.first.size(), delay.first) == 0) {
+                return delay.second;
+            }
+        }
+        return 0;
+    }
+
+    // Take the "#<tag> " prefix off a tagged request
+    static uint32_t StripTag(std::string_view& request)
+    {
+        if (request.empty() || request[0] != '#') {
+            return 0;
+        }
+        uint32_t tag = 0;
+        size_t i = 1;
+        for (; i < request.size() && request[i] >= '0' && request[i] <= '9'; i++) {
+            tag = tag * 10 + (uint32_t)(request[i] - '0');
+        }
+        if (i < request.size() && request[i] == ' ') {
+            request.remove_prefix(i + 1);
+        }
+        return tag;
+    }
+
+    // Answer one request (m_mutex held). Returns true if the request made
+    // this connection a push channel.
+    bool Reply(std::string_view request)
+    {
+        bool tagged = m_tagged;
+        uint32_t tag = tagged ? StripTag(request) : 0;
+        
+        std::string bytes;
+        bool stream = false;
+        if (request == "VERSION:FRAMED" && m_framing) {
+            bytes = "VERSION:1.1:FRAMED\n";  // Acknowledged unframed, as the AddOn does
+            m_framed = true;
+        } else if (request == "VERSION:FRAMED") {
+            bytes = "VERSION:1.0\n";
+        } else {
+            // TAGS:ON is acknowledged in the last untagged reply
+            bool tags = (request == "TAGS:ON" && m_tags && m_framed);
+            std::string reply = tags ? std::string("OK:Tags") : m_server->Handle(request);
+            m_tagged |= tags;
+            stream = (request == "STREAM" && reply.compare(0, 3, "OK:") == 0 && !m_streaming);
+            if (m_raw) {
+                bytes = std::move(reply);
+            } else if (m_framed) {
+                uint32_t length = (uint32_t)reply.size();
+                char header[8] = { (char)length, (char)(length >> 8), (char)(length >> 16), (char)(length >> 24),
+                                   (char)tag, (char)(tag >> 8), (char)(tag >> 16), (char)(tag >> 24) };
+                bytes.assign(header, tagged ? 8 : 4);
+                bytes += reply;
+            } else {
+                bytes = std::move(reply);
+                bytes += '\n';
+            }
+        }
+        m_streaming |= stream;
+
+        int delayMs = DelayFor(request);
+        if (delayMs <= 0 && (m_delayed.empty() || tagged)) {
+            m_output += bytes;
+        } else if (tagged) {
+            // Out of order: due after its own delay, ahead of later ones
+            auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs);
+            auto it = m_delayed.end();
+            while (it != m_delayed.begin() && std::prev(it)->due > due) {
+                --it;
+            }
+            m_delayed.insert(it, { due, std::move(bytes) });
+        } else {
+            auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs);
+            if (!m_delayed.empty() && m_delayed.back().due > due) {
+                due = m_delayed.back().due;
+            }
+            m_delayed.push_back({ due, std::move(bytes) });
+        }
+        return stream;
+    }
+
+    // Closed by the server (DropStreams)
+    void Drop()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+        m_streaming = false;
+        m_ready.notify_all();
+    }
+
+    // Server push: one line, newline-terminated
+    void Push(std::string_view line)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_closed) {
+            return;
+        }
+        m_output.append(line.data(), line.size());
+        m_output += '\n';
+        m_ready.notify_all();
+    }
+};
+
+void LoopbackServer::Publish(std::string_view line)
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    for (LoopbackTransport* stream : m_streams) {
+        stream->Push(line);
+    }
+}
+
+void LoopbackServer::DropStreams()
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    for (LoopbackTransport* stream : m_streams) {
+        stream->Drop();
+    }
+    m_streams.clear();
+}
+
+size_t LoopbackServer::StreamCount()
+{
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    return m_streams.size();
+}
+
+#endif // TRANSPORT_H
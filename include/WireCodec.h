@@ -0,0 +1,301 @@
+// WireCodec.h - Reply codecs for the NinjaTrader bridge protocol
+// Copyright (c) 2025
+//
+// Two encodings exist for the data-carrying replies:
+//
+//   Text   - colon/pipe delimited, e.g. PRICE:last:bid:ask:volume
+//            Always available; easy to read in logs and with telnet.
+//   Binary - fixed-layout little-endian records, selected per connection
+//            with CODEC:BINARY after length-prefixed framing is active.
+//
+// Binary records start with a tag byte below 0x20, so a reply identifies
+// its own encoding. Status and error replies (OK:..., ERROR:..., ORDER:...)
+// and the bulk list replies (PRICES:..., ORDERSTATUSES:..., POSITIONS:...) are
+// always text.
+//
+// Binary layouts (payload after the frame header, no padding):
+//   QUOTE       0x01  double last, bid, ask, volume               33 bytes
+//   ACCOUNT     0x02  double cash, buyingPower, realized, unreal.  33 bytes
+//   ORDERSTATUS 0x03  char state[16], int32 filled, double avgFill 29 bytes
+//   POSITION    0x04  int32 quantity (signed), double avgPrice     13 bytes
+//   HISTORY     0x05  int32 count, then count x
+//                     { double time; float open, high, low, close, volume }
+//
+// TextCodec, BinaryCodec and AdaptiveCodec double as the CodecPolicy of
+// BasicTcpBridge: PREFERRED is the codec the bridge negotiates, STRICT
+// makes the connection fail if the AddOn doesn't agree to it, and the
+// static Decode* functions are called directly (no virtual dispatch).
+
+#pragma once
+
+#ifndef WIRECODEC_H
+#define WIRECODEC_H
+
+#include <cstdint>
+#include <string_view>
+
+#include "ReplySchema.h"
+#include "trading.h"
+
+//=============================================================================
+// Decoded reply records
+//=============================================================================
+
+// Quote - one price snapshot for an instrument
+struct Quote {
+    double last = 0;
+    double bid = 0;
+    double ask = 0;
+    double volume = 0;
+    double time = 0;      // OLE DATE (UTC) of the update, 0 if unknown
+};
+
+struct AccountRecord {
+    double cashValue = 0;
+    double buyingPower = 0;
+    double realizedPnL = 0;
+    double unrealizedPnL = 0;
+};
+
+struct OrderStatusRecord {
+    char state[16] = "Unknown";   // NinjaTrader OrderState name
+    int filled = 0;
+    double avgFillPrice = 0;
+};
+
+struct PositionRecord {
+    int quantity = 0;             // Signed: negative for short
+    double avgPrice = 0;
+};
+
+// Result of decoding a history reply into a T6 buffer
+struct HistoryResult {
+    int barCount = 0;             // Bars reported by the AddOn
+    int loaded = 0;               // Bars written to the output buffer
+    int skipped = 0;              // Bars before tStart
+    bool endReached = false;      // Stopped at a bar after tEnd
+};
+
+enum class Codec { Text, Binary };
+
+//=============================================================================
+// Text reply schemas (see ReplySchema.h)
+//=============================================================================
+
+// Entries of the bulk list replies and streamed quote lines carry a name
+// besides the record; the view points into the reply
+struct OrderStatusEntry : OrderStatusRecord {
+    std::string_view orderId;
+};
+
+struct PositionEntry : PositionRecord {
+    std::string_view instrument;
+};
+
+struct QuoteEntry : Quote {
+    std::string_view instrument;
+};
+
+struct StreamedQuote : Quote {
+    std::string_view instrument;
+};
+
+// One market depth row operation (push channel, see DepthBook.h)
+struct DepthUpdate {
+    std::string_view instrument;
+    int side = 0;             // 0 = ask, 1 = bid
+    int operation = 0;        // 0 = add, 1 = update, 2 = remove
+    int position = 0;         // Row, 0 = best
+    double price = 0;
+    double volume = 0;
+    double time = 0;          // OLE DATE (UTC) of the update, 0 if unknown
+};
+
+namespace ReplyTags {
+    inline constexpr char PRICE[] = "PRICE";
+    inline constexpr char ACCOUNT[] = "ACCOUNT";
+    inline constexpr char ORDERSTATUS[] = "ORDERSTATUS";
+    inline constexpr char POSITION[] = "POSITION";
+    inline constexpr char QUOTE[] = "QUOTE";
+    inline constexpr char DEPTH[] = "DEPTH";
+}
+
+// PRICE:last:bid:ask:volume
+using QuoteSchema = ReplySchema<ReplyTags::PRICE, ':', 4, Quote,
+    Field<&Quote::last>, Field<&Quote::bid>, Field<&Quote::ask>, Field<&Quote::volume>>;
+
+// ACCOUNT:cashValue:buyingPower:realizedPnL[:unrealizedPnL] (older AddOns send 4 parts)
+using AccountSchema = ReplySchema<ReplyTags::ACCOUNT, ':', 3, AccountRecord,
+    Field<&AccountRecord::cashValue>, Field<&AccountRecord::buyingPower>,
+    Field<&AccountRecord::realizedPnL>, Field<&AccountRecord::unrealizedPnL>>;
+
+// ORDERSTATUS:orderId:state[:filled[:avgFillPrice]]
+using OrderStatusSchema = ReplySchema<ReplyTags::ORDERSTATUS, ':', 2, OrderStatusRecord,
+    Skip, Field<&OrderStatusRecord::state>, Field<&OrderStatusRecord::filled>,
+    Field<&OrderStatusRecord::avgFillPrice>>;
+
+// POSITION:quantity:avgPrice
+using PositionSchema = ReplySchema<ReplyTags::POSITION, ':', 2, PositionRecord,
+    Field<&PositionRecord::quantity>, Field<&PositionRecord::avgPrice>>;
+
+// QUOTE:instrument:last:bid:ask:volume[:time] (push channel, see QuoteStream.h)
+using StreamedQuoteSchema = ReplySchema<ReplyTags::QUOTE, ':', 5, StreamedQuote,
+    Field<&StreamedQuote::instrument>, Field<&Quote::last>, Field<&Quote::bid>,
+    Field<&Quote::ask>, Field<&Quote::volume>, Field<&Quote::time>>;
+
+// DEPTH:instrument:side:operation:position:price:volume[:time] (push channel)
+using DepthUpdateSchema = ReplySchema<ReplyTags::DEPTH, ':', 6, DepthUpdate,
+    Field<&DepthUpdate::instrument>, Field<&DepthUpdate::side>, Field<&DepthUpdate::operation>,
+    Field<&DepthUpdate::position>, Field<&DepthUpdate::price>, Field<&DepthUpdate::volume>,
+    Field<&DepthUpdate::time>>;
+
+// PRICES list entry: instrument,last,bid,ask,volume
+using QuoteEntrySchema = ReplySchema<nullptr, ',', 5, QuoteEntry,
+    Field<&QuoteEntry::instrument>, Field<&Quote::last>, Field<&Quote::bid>,
+    Field<&Quote::ask>, Field<&Quote::volume>>;
+
+// ORDERSTATUSES list entry: orderId,state,filled,avgFillPrice
+using OrderStatusEntrySchema = ReplySchema<nullptr, ',', 4, OrderStatusEntry,
+    Field<&OrderStatusEntry::orderId>, Field<&OrderStatusRecord::state>,
+    Field<&OrderStatusRecord::filled>, Field<&OrderStatusRecord::avgFillPrice>>;
+
+// POSITIONS list entry: instrument,quantity,avgPrice
+using PositionEntrySchema = ReplySchema<nullptr, ',', 3, PositionEntry,
+    Field<&PositionEntry::instrument>, Field<&PositionRecord::quantity>,
+    Field<&PositionRecord::avgPrice>>;
+
+// HISTORY bar: time,open,high,low,close,volume
+using HistoryBarSchema = ReplySchema<nullptr, ',', 6, T6,
+    Field<&T6::time>, Field<&T6::fOpen>, Field<&T6::fHigh>, Field<&T6::fLow>,
+    Field<&T6::fClose>, Field<&T6::fVol>>;
+
+//=============================================================================
+// TextCodec - colon/pipe delimited replies
+//=============================================================================
+
+class TextCodec
+{
+public:
+    static constexpr Codec PREFERRED = Codec::Text;
+    static constexpr bool STRICT = false;   // Every AddOn speaks text
+
+    static bool DecodeQuote(std::string_view response, Quote& quote);
+    static bool DecodeAccount(std::string_view response, AccountRecord& account);
+    static bool DecodeOrderStatus(std::string_view response, OrderStatusRecord& status);
+    static bool DecodePosition(std::string_view response, PositionRecord& position);
+
+    // Any of the tagged replies above, picked by tag: calls handler(record)
+    // with the decoded Quote, AccountRecord, OrderStatusRecord or
+    // PositionRecord
+    using Replies = ReplyDispatcher<QuoteSchema, AccountSchema, OrderStatusSchema, PositionSchema>;
+
+    template <typename Handler>
+    static bool Decode(std::string_view response, Handler&& handler)
+    {
+        return Replies::Dispatch(response, handler);
+    }
+
+    // One entry of a PRICES list: instrument,last,bid,ask,volume
+    static bool DecodeQuoteEntry(std::string_view entry, std::string_view& instrument, Quote& quote);
+
+    // One entry of an ORDERSTATUSES list: orderId,state,filled,avgFillPrice
+    static bool DecodeOrderStatusEntry(std::string_view entry, std::string_view& orderId,
+                                       OrderStatusRecord& status);
+
+    // One entry of a POSITIONS list: instrument,quantity,avgPrice
+    static bool DecodePositionEntry(std::string_view entry, std::string_view& instrument,
+                                    PositionRecord& position);
+
+    // HISTORY:{n}|time,o,h,l,c,v|... - copy bars in [tStart, tEnd] into
+    // ticks (at most nTicks). False only for a malformed header.
+    static bool DecodeHistory(std::string_view response, DATE tStart, DATE tEnd,
+                              T6* ticks, int nTicks, HistoryResult& result);
+
+    // The two halves of DecodeHistory, for decoding the bars in pieces
+    // (see HistoryDecoder.h): the header yields the bar count and the
+    // bar list after it; DecodeHistoryBars() decodes any run of whole
+    // bars into ticks[0..] and sets result.loaded, skipped and endReached.
+    static bool DecodeHistoryHeader(std::string_view response, int& barCount, std::string_view& bars);
+    static void DecodeHistoryBars(std::string_view bars, DATE tStart, DATE tEnd,
+                                  T6* ticks, int nTicks, HistoryResult& result);
+};
+
+//=============================================================================
+// BinaryCodec - fixed-layout little-endian records
+//=============================================================================
+
+class BinaryCodec
+{
+public:
+    enum Tag : unsigned char {
+        TAG_QUOTE       = 0x01,
+        TAG_ACCOUNT     = 0x02,
+        TAG_ORDERSTATUS = 0x03,
+        TAG_POSITION    = 0x04,
+        TAG_HISTORY     = 0x05
+    };
+
+    static constexpr Codec PREFERRED = Codec::Binary;
+    static constexpr bool STRICT = true;    // Can't read text replies
+
+    static constexpr size_t QUOTE_SIZE       = 1 + 4 * 8;
+    static constexpr size_t ACCOUNT_SIZE     = 1 + 4 * 8;
+    static constexpr size_t ORDERSTATUS_SIZE = 1 + 16 + 4 + 8;
+    static constexpr size_t POSITION_SIZE    = 1 + 4 + 8;
+    static constexpr size_t HISTORY_HEADER   = 1 + 4;
+    static constexpr size_t HISTORY_BAR_SIZE = 8 + 5 * 4;
+
+    static bool IsRecord(std::string_view response)
+    {
+        return !response.empty() && (unsigned char)response[0] < 0x20;
+    }
+
+    static bool DecodeQuote(std::string_view response, Quote& quote);
+    static bool DecodeAccount(std::string_view response, AccountRecord& account);
+    static bool DecodeOrderStatus(std::string_view response, OrderStatusRecord& status);
+    static bool DecodePosition(std::string_view response, PositionRecord& position);
+
+    // Copy bars in [tStart, tEnd] into ticks (at most nTicks)
+    static bool DecodeHistory(std::string_view response, DATE tStart, DATE tEnd,
+                              T6* ticks, int nTicks, HistoryResult& result);
+};
+
+//=============================================================================
+// AdaptiveCodec - prefer binary, decode whichever encoding arrives
+//=============================================================================
+//
+// The default policy: asks for binary but keeps working against an AddOn
+// that only speaks text, picking the decoder from the reply's first byte.
+
+class AdaptiveCodec
+{
+public:
+    static constexpr Codec PREFERRED = Codec::Binary;
+    static constexpr bool STRICT = false;
+
+    static bool DecodeQuote(std::string_view response, Quote& quote)
+    {
+        return BinaryCodec::IsRecord(response) ? BinaryCodec::DecodeQuote(response, quote)
+                                               : TextCodec::DecodeQuote(response, quote);
+    }
+
+    static bool DecodeAccount(std::string_view response, AccountRecord& account)
+    {
+        return BinaryCodec::IsRecord(response) ? BinaryCodec::DecodeAccount(response, account)
+                                               : TextCodec::DecodeAccount(response, account);
+    }
+
+    static bool DecodeOrderStatus(std::string_view response, OrderStatusRecord& status)
+    {
+        return BinaryCodec::IsRecord(response) ? BinaryCodec::DecodeOrderStatus(response, status)
+                                               : TextCodec::DecodeOrderStatus(response, status);
+    }
+
+    static bool DecodePosition(std::string_view response, PositionRecord& position)
+    {
+        return BinaryCodec::IsRecord(response) ? BinaryCodec::DecodePosition(response, position)
+                                               : TextCodec::DecodePosition(response, position);
+    }
+};
+
+#endif // WIRECODEC_H
@@ -7,7 +7,9 @@
 #ifndef TRADING_H
 #define TRADING_H
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 // Ensure 4-byte struct alignment for Zorro compatibility
 #pragma pack(push, 4)
@@ -18,6 +20,24 @@ typedef double DATE;
 // Return value for unavailable data
 #define NAY (-999999)
 
+// Size of the T2 array Zorro passes to GET_BOOK
+#define MAX_QUOTES 5000
+
+// T1 structure for single stream ticks (.t1 files)
+typedef struct T1
+{
+    DATE  time;   // GMT timestamp
+    float fVal;   // Positive for ask, negative for bid
+} T1;
+
+// T2 structure for two-stream ticks, e.g. order book levels (.t2 files)
+typedef struct T2
+{
+    DATE  time;   // GMT timestamp
+    float fVal;   // Price, positive for ask, negative for bid
+    float fVol;   // Volume / size
+} T2;
+
 // T6 structure for historical price data
 typedef struct T6
 {
@@ -31,6 +51,7 @@ typedef struct T6
 } T6;
 
 // Broker command codes
+#define GET_BOOK           62   // Order book (T2* Quotes, asset by SET_SYMBOL)
 #define GET_COMPLIANCE     327
 #define GET_MAXTICKS       328
 #define GET_MAXREQUESTS    329
@@ -80,6 +101,10 @@ typedef struct T6
 #define SET_PRICETYPE      409
 #define SET_VOLTYPE        410
 #define SET_UUID           411
+#define SET_QUOTETTL       412  // Max age in ms of a reused cached quote (custom)
+#define SET_MAXASSETS      413  // Max simultaneously subscribed assets (custom)
+#define SET_RECORDTICKS    414  // Record observed quotes to T1 files in a folder (custom)
+#define SET_BARPERIOD      415  // Build local bars of a period in minutes from quotes, 0 = none (custom)
 
 #define DO_EXERCISE        420
 #define DO_CANCEL          421
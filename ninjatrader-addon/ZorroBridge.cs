@@ -8,6 +8,7 @@
 using System;
 using System.Collections.Generic;
 using System.Collections.Concurrent;  // NEW: For ConcurrentDictionary
+using System.IO.MemoryMappedFiles;  // Shared-memory transport
 using System.Linq;
 using System.Net;
 using System.Net.Sockets;
@@ -38,6 +39,7 @@ namespace NinjaTrader.NinjaScript.AddOns
         private Thread listenerThread;
         private bool isRunning = false;
         private const int PORT = 8888;
+        private const string PROTOCOL_VERSION = "1.1";
         
         private Account currentAccount;
         // **FIXED: Use thread-safe ConcurrentDictionary instead of Dictionary**
@@ -45,6 +47,31 @@ namespace NinjaTrader.NinjaScript.AddOns
         private ConcurrentDictionary<string, Instrument> subscribedInstruments = new ConcurrentDictionary<string, Instrument>();
         private ConcurrentDictionary<string, Order> activeOrders = new ConcurrentDictionary<string, Order>();
         
+        // Push quotes: one MarketData feed per subscribed instrument, fanned
+        // out to every client that sent STREAM
+        private ConcurrentDictionary<string, QuoteFeed> quoteFeeds = new ConcurrentDictionary<string, QuoteFeed>();
+        private readonly List<NetworkStream> quoteStreams = new List<NetworkStream>();
+        private readonly object quoteStreamsLock = new object();
+        
+        private class QuoteFeed
+        {
+            public MarketData Data;
+            public EventHandler<MarketDataEventArgs> Handler;
+        }
+        
+        // Push depth: one MarketDepth feed per instrument asked for with
+        // SUBSCRIBEDEPTH, on the same STREAM clients as the quotes
+        private ConcurrentDictionary<string, DepthFeed> depthFeeds = new ConcurrentDictionary<string, DepthFeed>();
+        
+        private class DepthFeed
+        {
+            public MarketDepth<MarketDepthRow> Depth;
+            public EventHandler<MarketDepthEventArgs> Handler;
+        }
+        
+        // Shared-memory sessions (SHM:OPEN), numbered for unique mapping names
+        private int shmSessionCount = 0;
+        
         // Order cleanup settings
         private const int MAX_ORDER_HISTORY = 100;  // Keep last N completed orders
         private int orderCleanupCount = 0;
@@ -204,27 +231,159 @@ namespace NinjaTrader.NinjaScript.AddOns
         {
             TcpClient client = (TcpClient)obj;
             
+            // Replies are newline-terminated until the client negotiates
+            // length-prefixed framing with VERSION:FRAMED
+            bool framed = false;
+            
+            // Data replies are text until the client selects CODEC:BINARY
+            bool binary = false;
+            
+            // Requests carry a tag after TAGS:ON; replies may then go out
+            // in any order, each with its request's tag in the frame header
+            bool tagged = false;
+            
             try
             {
                 using (NetworkStream stream = client.GetStream())
                 {
                     byte[] buffer = new byte[4096];
+                    char[] chars = new char[Encoding.UTF8.GetMaxCharCount(buffer.Length)];
+                    Decoder decoder = Encoding.UTF8.GetDecoder();
+                    StringBuilder pending = new StringBuilder();
                     
                     while (client.Connected && isRunning)
                     {
                         int bytesRead = stream.Read(buffer, 0, buffer.Length);
                         if (bytesRead == 0) break;
                         
-                        string request = Encoding.UTF8.GetString(buffer, 0, bytesRead).Trim();
-                        Log(LogLevel.TRACE, $"<< {request}");
+                        // One read may carry several pipelined commands (or only
+                        // part of one) - split on newlines and answer in order
+                        int charCount = decoder.GetChars(buffer, 0, bytesRead, chars, 0);
+                        pending.Append(chars, 0, charCount);
                         
-                        string response = ProcessCommand(request);
-                        
-                        Log(LogLevel.TRACE, $">> {response}");
-                        
-                        byte[] responseBytes = Encoding.UTF8.GetBytes(response + "\n");
-                        stream.Write(responseBytes, 0, responseBytes.Length);
-                        stream.Flush();
+                        string request;
+                        while ((request = NextRequest(pending)) != null)
+                        {
+                            if (request.Length == 0) continue;
+                            Log(LogLevel.TRACE, $"<< {request}");
+                            
+                            uint? tag = tagged ? StripTag(ref request) : null;
+                            
+                            if (IsStreamRequest(request))
+                            {
+                                // This connection now only receives pushed quotes
+                                WriteReply(stream, "OK:Streaming", false);
+                                lock (quoteStreamsLock)
+                                {
+                                    quoteStreams.Add(stream);
+                                }
+                                Log(LogLevel.DEBUG, "Client switched to quote streaming");
+                                continue;
+                            }
+                            
+                            if (IsFramingRequest(request))
+                            {
+                                // Acknowledge in the old format, then switch
+                                WriteReply(stream, $"VERSION:{PROTOCOL_VERSION}:FRAMED", false);
+                                framed = true;
+                                Log(LogLevel.DEBUG, "Client switched to length-prefixed framing");
+                                continue;
+                            }
+                            
+                            if (IsCodecRequest(request))
+                            {
+                                // Binary records may contain '\n' - framing is required
+                                bool wantBinary = request.EndsWith(":BINARY", StringComparison.OrdinalIgnoreCase);
+                                if (wantBinary && !framed)
+                                {
+                                    WriteReply(stream, "ERROR:Binary codec requires framing", framed, tag);
+                                    continue;
+                                }
+                                binary = wantBinary;
+                                WriteReply(stream, binary ? "OK:Codec BINARY" : "OK:Codec TEXT", framed, tag);
+                                Log(LogLevel.DEBUG, $"Client switched to {(binary ? "binary" : "text")} codec");
+                                continue;
+                            }
+                            
+                            if (IsTagsRequest(request))
+                            {
+                                // The tag travels in the frame header - framing is required
+                                if (!framed)
+                                {
+                                    WriteReply(stream, "ERROR:Tags require framing", framed, tag);
+                                    continue;
+                                }
+                                WriteReply(stream, "OK:Tags", framed, tag);
+                                tagged = true;
+                                Log(LogLevel.DEBUG, "Client switched to tagged requests");
+                                continue;
+                            }
+                            
+                            if (IsSharedMemoryRequest(request))
+                            {
+                                if (request.EndsWith(":CLOSE", StringComparison.OrdinalIgnoreCase))
+                                {
+                                    // Plugin could not attach - the session is already gone
+                                    WriteReply(stream, "OK:SHM closed", framed, tag);
+                                    continue;
+                                }
+                                
+                                // Shared-memory replies are always framed
+                                if (!framed)
+                                {
+                                    WriteReply(stream, "ERROR:Shared memory requires framing", framed, tag);
+                                    continue;
+                                }
+                                
+                                SharedMemorySession session;
+                                try
+                                {
+                                    string name = $"Local\\ZorroBridge_{System.Diagnostics.Process.GetCurrentProcess().Id}_{Interlocked.Increment(ref shmSessionCount)}";
+                                    session = new SharedMemorySession(name);
+                                }
+                                catch (Exception ex)
+                                {
+                                    Log(LogLevel.WARN, $"Shared memory unavailable: {ex.Message}");
+                                    WriteReply(stream, $"ERROR:{ex.Message}", framed, tag);
+                                    continue;
+                                }
+                                
+                                using (session)
+                                {
+                                    WriteReply(stream, $"OK:SHM:{session.Name}", framed, tag);
+                                    Log(LogLevel.DEBUG, $"Client switched to shared memory ({session.Name})");
+                                    
+                                    if (!ServeSharedMemory(client, session, ref binary, tagged))
+                                        return;  // Client gone
+                                }
+                                
+                                Log(LogLevel.DEBUG, "Client fell back to TCP");
+                                continue;
+                            }
+                            
+                            if (tag.HasValue && IsSlowRequest(request))
+                            {
+                                // History can take seconds - answer it from the thread
+                                // pool so the requests behind it aren't held up
+                                string slowRequest = request;
+                                bool slowBinary = binary;
+                                uint slowTag = tag.Value;
+                                ThreadPool.QueueUserWorkItem(_ =>
+                                {
+                                    try
+                                    {
+                                        WriteReply(stream, ProcessRequest(slowRequest, slowBinary), true, slowTag);
+                                    }
+                                    catch (Exception ex)
+                                    {
+                                        Log(LogLevel.DEBUG, $"Tagged reply dropped: {ex.Message}");
+                                    }
+                                });
+                                continue;
+                            }
+                            
+                            WriteReply(stream, ProcessRequest(request, binary), framed, tag);
+                        }
                     }
                 }
             }
@@ -235,9 +394,226 @@ namespace NinjaTrader.NinjaScript.AddOns
             finally
             {
                 Log(LogLevel.DEBUG, "Client disconnected");
+                lock (quoteStreamsLock)
+                {
+                    quoteStreams.RemoveAll(s => !s.CanWrite);
+                }
                 client.Close();
             }
         }
+        
+        // Remove and return the next complete line, or null if none is buffered
+        private static string NextRequest(StringBuilder pending)
+        {
+            for (int i = 0; i < pending.Length; i++)
+            {
+                if (pending[i] == '\n')
+                {
+                    string line = pending.ToString(0, i).Trim();
+                    pending.Remove(0, i + 1);
+                    return line;
+                }
+            }
+            return null;
+        }
+        
+        private static bool IsStreamRequest(string request)
+        {
+            return request.Equals("STREAM", StringComparison.OrdinalIgnoreCase);
+        }
+        
+        private static bool IsFramingRequest(string request)
+        {
+            return request.Equals("VERSION:FRAMED", StringComparison.OrdinalIgnoreCase);
+        }
+        
+        private static bool IsCodecRequest(string request)
+        {
+            return request.Equals("CODEC:BINARY", StringComparison.OrdinalIgnoreCase)
+                || request.Equals("CODEC:TEXT", StringComparison.OrdinalIgnoreCase);
+        }
+        
+        private static bool IsTagsRequest(string request)
+        {
+            return request.Equals("TAGS:ON", StringComparison.OrdinalIgnoreCase);
+        }
+        
+        // Commands worth running concurrently with the rest of a tagged connection
+        private static bool IsSlowRequest(string request)
+        {
+            return request.StartsWith("GETHISTORY:", StringComparison.OrdinalIgnoreCase)
+                || request.Equals("GETINSTRUMENTS", StringComparison.OrdinalIgnoreCase);
+        }
+        
+        // Remove the "#<tag> " prefix of a tagged request and return the tag.
+        // Requests without one get tag 0, which the plugin never uses.
+        private static uint? StripTag(ref string request)
+        {
+            uint tag = 0;
+            if (request.StartsWith("#"))
+            {
+                int space = request.IndexOf(' ');
+                if (space > 1 && uint.TryParse(request.Substring(1, space - 1), out tag))
+                    request = request.Substring(space + 1);
+            }
+            return tag;
+        }
+        
+        // Reply payload for an ordinary command: a binary record where one
+        // exists and the client selected the binary codec, else text
+        private byte[] ProcessRequest(string request, bool binary)
+        {
+            if (binary)
+            {
+                byte[] record = ProcessBinaryCommand(request);
+                if (record != null)
+                {
+                    Log(LogLevel.TRACE, $">> binary record ({record.Length} bytes)");
+                    return record;
+                }
+            }
+            
+            string response = ProcessCommand(request);
+            Log(LogLevel.TRACE, $">> {response}");
+            return Encoding.UTF8.GetBytes(response);
+        }
+        
+        private static bool IsSharedMemoryRequest(string request)
+        {
+            return request.Equals("SHM:OPEN", StringComparison.OrdinalIgnoreCase)
+                || request.Equals("SHM:CLOSE", StringComparison.OrdinalIgnoreCase);
+        }
+        
+        // Serve a client's requests from the shared-memory rings until the
+        // plugin closes the session (returns false) or sends on TCP again,
+        // which means it fell back to TCP (returns true).
+        private bool ServeSharedMemory(TcpClient client, SharedMemorySession session, ref bool binary, bool tagged)
+        {
+            byte[] buffer = new byte[8192];
+            char[] chars = new char[Encoding.UTF8.GetMaxCharCount(buffer.Length)];
+            Decoder decoder = Encoding.UTF8.GetDecoder();
+            StringBuilder pending = new StringBuilder();
+            
+            while (isRunning)
+            {
+                int bytesRead = session.Read(buffer, 100);
+                if (bytesRead < 0)
+                    return false;  // Plugin closed the session
+                
+                if (bytesRead == 0)
+                {
+                    // Quiet - check whether the TCP side closed or has a request
+                    if (client.Client.Poll(0, SelectMode.SelectRead))
+                        return client.Available > 0;
+                    continue;
+                }
+                
+                int charCount = decoder.GetChars(buffer, 0, bytesRead, chars, 0);
+                pending.Append(chars, 0, charCount);
+                
+                string request;
+                while ((request = NextRequest(pending)) != null)
+                {
+                    if (request.Length == 0) continue;
+                    Log(LogLevel.TRACE, $"<< {request} (shm)");
+                    
+                    uint? tag = tagged ? StripTag(ref request) : null;
+                    
+                    byte[] payload;
+                    if (IsCodecRequest(request))
+                    {
+                        binary = request.EndsWith(":BINARY", StringComparison.OrdinalIgnoreCase);
+                        payload = Encoding.UTF8.GetBytes(binary ? "OK:Codec BINARY" : "OK:Codec TEXT");
+                    }
+                    else if (IsStreamRequest(request) || IsFramingRequest(request) || IsSharedMemoryRequest(request)
+                             || IsTagsRequest(request))
+                    {
+                        payload = Encoding.UTF8.GetBytes("ERROR:Not available over shared memory");
+                    }
+                    else if (tag.HasValue && IsSlowRequest(request))
+                    {
+                        // See HandleClient - the reply follows when it is ready
+                        string slowRequest = request;
+                        bool slowBinary = binary;
+                        uint slowTag = tag.Value;
+                        ThreadPool.QueueUserWorkItem(_ =>
+                        {
+                            try
+                            {
+                                WriteFrame(session, ProcessRequest(slowRequest, slowBinary), slowTag);
+                            }
+                            catch (Exception ex)
+                            {
+                                Log(LogLevel.DEBUG, $"Tagged reply dropped: {ex.Message}");
+                            }
+                        });
+                        continue;
+                    }
+                    else
+                    {
+                        payload = ProcessRequest(request, binary);
+                    }
+                    
+                    if (!WriteFrame(session, payload, tag))
+                        return false;
+                }
+            }
+            
+            return false;
+        }
+        
+        // 4-byte little-endian payload length, followed by the 4-byte
+        // little-endian request tag for tagged replies
+        private static byte[] FrameHeader(int length, uint? tag = null)
+        {
+            byte[] header = new byte[tag.HasValue ? 8 : 4];
+            header[0] = (byte)length;
+            header[1] = (byte)(length >> 8);
+            header[2] = (byte)(length >> 16);
+            header[3] = (byte)(length >> 24);
+            if (tag.HasValue)
+            {
+                uint value = tag.Value;
+                header[4] = (byte)value;
+                header[5] = (byte)(value >> 8);
+                header[6] = (byte)(value >> 16);
+                header[7] = (byte)(value >> 24);
+            }
+            return header;
+        }
+        
+        // Newline mode: response + "\n"
+        // Framed mode:  4-byte little-endian payload length (+ tag) + response (no terminator)
+        private void WriteReply(NetworkStream stream, string response, bool framed, uint? tag = null)
+        {
+            WriteReply(stream, Encoding.UTF8.GetBytes(response), framed, tag);
+        }
+        
+        // Tagged replies can come from pool threads - keep each one whole
+        private void WriteReply(NetworkStream stream, byte[] payload, bool framed, uint? tag = null)
+        {
+            lock (stream)
+            {
+                if (framed)
+                {
+                    byte[] header = FrameHeader(payload.Length, tag);
+                    stream.Write(header, 0, header.Length);
+                }
+                
+                stream.Write(payload, 0, payload.Length);
+                if (!framed)
+                    stream.WriteByte((byte)'\n');
+                stream.Flush();
+            }
+        }
+        
+        private bool WriteFrame(SharedMemorySession session, byte[] payload, uint? tag)
+        {
+            lock (session)
+            {
+                return session.Write(FrameHeader(payload.Length, tag)) && session.Write(payload);
+            }
+        }
 
         private string ProcessCommand(string command)
         {
@@ -255,7 +631,7 @@ namespace NinjaTrader.NinjaScript.AddOns
                         return "PONG";
 
                     case "VERSION":
-                        return "VERSION:1.0";
+                        return $"VERSION:{PROTOCOL_VERSION}";
 
                     case "LOGIN":
                         return HandleLogin(parts);
@@ -275,12 +651,21 @@ namespace NinjaTrader.NinjaScript.AddOns
                     case "GETPRICE":
                         return HandleGetPrice(parts);
 
+                    case "GETPRICES":
+                        return HandleGetPrices(parts);
+
+                    case "SUBSCRIBEDEPTH":
+                        return HandleSubscribeDepth(parts);
+
                     case "GETACCOUNT":
                         return HandleGetAccount();
 
                     case "GETPOSITION":
                         return HandleGetPosition(parts);
 
+                    case "GETPOSITIONS":
+                        return HandleGetPositions();
+
                     case "PLACEORDER":
                         Log(LogLevel.ERROR, $"!! PLACEORDER RECEIVED: {command}");
                         return HandlePlaceOrder(parts);
@@ -294,6 +679,9 @@ namespace NinjaTrader.NinjaScript.AddOns
                     case "GETORDERSTATUS":
                         return HandleGetOrderStatus(parts);
                     
+                    case "GETORDERSTATUSES":
+                        return HandleGetOrderStatuses(parts);
+                    
                     case "GETHISTORY":
                         return HandleGetHistory(parts);
                     
@@ -312,6 +700,311 @@ namespace NinjaTrader.NinjaScript.AddOns
             }
         }
 
+        //=====================================================================
+        // Shared-memory transport
+        //=====================================================================
+        // Two SPSC byte rings in a named mapping plus two auto-reset events.
+        // The layout is shared with SharedMemoryLink.h in the plugin: the
+        // request ring carries "command\n" lines, the reply ring carries
+        // length-prefixed frames. A side that goes to sleep raises its
+        // 'waiting' flag; the other side only sets the event when the flag
+        // is up. On x86, aligned Int32 reads and writes are atomic and the
+        // full barriers below give the required ordering.
+        
+        private class SharedMemorySession : IDisposable
+        {
+            private const int MAGIC = 0x4D53425A;  // "ZBSM"
+            private const int VERSION = 1;
+            private const int HEADER_SIZE = 512;
+            private const int REQUEST_SIZE = 64 * 1024;
+            private const int REPLY_SIZE = 4 * 1024 * 1024;
+            private const int SPIN_COUNT = 20;
+            
+            private const int OFF_MAGIC = 0;
+            private const int OFF_VERSION = 4;
+            private const int OFF_REQUEST_SIZE = 8;
+            private const int OFF_REPLY_SIZE = 12;
+            private const int OFF_CLOSED = 16;
+            private const int OFF_REQUEST_HEAD = 64;
+            private const int OFF_REQUEST_TAIL = 128;
+            private const int OFF_REPLY_HEAD = 192;
+            private const int OFF_REPLY_TAIL = 256;
+            private const int OFF_PLUGIN_WAITING = 320;
+            private const int OFF_ADDON_WAITING = 384;
+            
+            public readonly string Name;
+            private readonly MemoryMappedFile file;
+            private readonly MemoryMappedViewAccessor view;
+            private readonly EventWaitHandle addonEvent;   // Set by the plugin to wake us
+            private readonly EventWaitHandle pluginEvent;  // Set by us to wake the plugin
+            
+            public SharedMemorySession(string name)
+            {
+                Name = name;
+                file = MemoryMappedFile.CreateNew(name, HEADER_SIZE + REQUEST_SIZE + REPLY_SIZE);
+                view = file.CreateViewAccessor();
+                addonEvent = new EventWaitHandle(false, EventResetMode.AutoReset, name + "_AddOn");
+                pluginEvent = new EventWaitHandle(false, EventResetMode.AutoReset, name + "_Plugin");
+                
+                view.Write(OFF_VERSION, VERSION);
+                view.Write(OFF_REQUEST_SIZE, REQUEST_SIZE);
+                view.Write(OFF_REPLY_SIZE, REPLY_SIZE);
+                Store(OFF_MAGIC, MAGIC);
+            }
+            
+            public bool PeerClosed { get { return Load(OFF_CLOSED) != 0; } }
+            
+            // Read available request bytes. Returns the count, 0 if nothing
+            // arrived within timeoutMs, or -1 if the plugin closed the session.
+            public int Read(byte[] buffer, int timeoutMs)
+            {
+                uint tail = (uint)Load(OFF_REQUEST_TAIL);
+                uint available = (uint)Load(OFF_REQUEST_HEAD) - tail;
+                if (available == 0)
+                {
+                    if (!Wait(() => (uint)Load(OFF_REQUEST_HEAD) != tail, timeoutMs))
+                        return PeerClosed ? -1 : 0;
+                    available = (uint)Load(OFF_REQUEST_HEAD) - tail;
+                }
+                
+                int n = (int)Math.Min(available, (uint)buffer.Length);
+                int start = (int)(tail & (REQUEST_SIZE - 1));
+                int first = Math.Min(n, REQUEST_SIZE - start);
+                view.ReadArray(HEADER_SIZE + start, buffer, 0, first);
+                if (n > first)
+                    view.ReadArray(HEADER_SIZE, buffer, first, n - first);
+                
+                Store(OFF_REQUEST_TAIL, (int)(tail + (uint)n));
+                WakePlugin();
+                return n;
+            }
+            
+            // Write all bytes to the reply ring, waiting while it is full.
+            // Returns false if the plugin closed the session.
+            public bool Write(byte[] data)
+            {
+                const int replyData = HEADER_SIZE + REQUEST_SIZE;
+                int offset = 0;
+                while (offset < data.Length)
+                {
+                    if (PeerClosed)
+                        return false;
+                    
+                    uint head = (uint)view.ReadInt32(OFF_REPLY_HEAD);
+                    uint space = REPLY_SIZE - (head - (uint)Load(OFF_REPLY_TAIL));
+                    if (space == 0)
+                    {
+                        Wait(() => head - (uint)Load(OFF_REPLY_TAIL) < REPLY_SIZE, 100);
+                        continue;
+                    }
+                    
+                    int n = (int)Math.Min(space, (uint)(data.Length - offset));
+                    int start = (int)(head & (REPLY_SIZE - 1));
+                    int first = Math.Min(n, REPLY_SIZE - start);
+                    view.WriteArray(replyData + start, data, offset, first);
+                    if (n > first)
+                        view.WriteArray(replyData, data, offset + first, n - first);
+                    
+                    Store(OFF_REPLY_HEAD, (int)(head + (uint)n));
+                    WakePlugin();
+                    offset += n;
+                }
+                return true;
+            }
+            
+            private bool Wait(Func<bool> ready, int timeoutMs)
+            {
+                SpinWait spin = new SpinWait();
+                for (int i = 0; i < SPIN_COUNT; i++)
+                {
+                    if (ready()) return true;
+                    spin.SpinOnce();
+                }
+                
+                Store(OFF_ADDON_WAITING, 1);
+                if (!ready() && !PeerClosed)
+                    addonEvent.WaitOne(timeoutMs);
+                Store(OFF_ADDON_WAITING, 0);
+                
+                return ready();
+            }
+            
+            private void WakePlugin()
+            {
+                if (Load(OFF_PLUGIN_WAITING) != 0)
+                {
+                    view.Write(OFF_PLUGIN_WAITING, 0);
+                    pluginEvent.Set();
+                }
+            }
+            
+            private int Load(int offset)
+            {
+                Thread.MemoryBarrier();
+                int value = view.ReadInt32(offset);
+                Thread.MemoryBarrier();
+                return value;
+            }
+            
+            private void Store(int offset, int value)
+            {
+                Thread.MemoryBarrier();
+                view.Write(offset, value);
+                Thread.MemoryBarrier();
+            }
+            
+            public void Dispose()
+            {
+                Store(OFF_CLOSED, 1);
+                WakePlugin();
+                view.Dispose();
+                file.Dispose();
+                addonEvent.Dispose();
+                pluginEvent.Dispose();
+            }
+        }
+        
+        //=====================================================================
+        // Binary codec
+        //=====================================================================
+        // Fixed-layout little-endian records (see WireCodec.h in the plugin).
+        // Returns null when there is no binary form of the reply - unknown
+        // commands and every error case - so the caller falls back to the
+        // text handler, which produces the usual ERROR:... reply.
+        
+        private const byte TAG_QUOTE = 0x01;
+        private const byte TAG_ACCOUNT = 0x02;
+        private const byte TAG_ORDERSTATUS = 0x03;
+        private const byte TAG_POSITION = 0x04;
+        private const byte TAG_HISTORY = 0x05;
+        private const int ORDER_STATE_LENGTH = 16;
+        
+        private byte[] ProcessBinaryCommand(string command)
+        {
+            try
+            {
+                string[] parts = command.Split(':');
+                
+                switch (parts[0].ToUpper())
+                {
+                    case "GETPRICE":
+                        return EncodeQuote(parts);
+                    case "GETACCOUNT":
+                        return EncodeAccount();
+                    case "GETPOSITION":
+                        return EncodePosition(parts);
+                    case "GETORDERSTATUS":
+                        return EncodeOrderStatus(parts);
+                    case "GETHISTORY":
+                        return EncodeHistory(parts);
+                    default:
+                        return null;
+                }
+            }
+            catch (Exception ex)
+            {
+                Log(LogLevel.WARN, $"Binary encode failed, using text: {ex.Message}");
+                return null;
+            }
+        }
+        
+        private static byte[] BuildRecord(byte tag, Action<System.IO.BinaryWriter> writeFields)
+        {
+            using (var ms = new System.IO.MemoryStream())
+            using (var writer = new System.IO.BinaryWriter(ms))  // Always little-endian
+            {
+                writer.Write(tag);
+                writeFields(writer);
+                writer.Flush();
+                return ms.ToArray();
+            }
+        }
+        
+        private byte[] EncodeQuote(string[] parts)
+        {
+            Instrument instrument;
+            if (parts.Length < 2 || !subscribedInstruments.TryGetValue(parts[1], out instrument) || instrument == null)
+                return null;
+            
+            double last, bid, ask;
+            long volume;
+            ReadQuote(instrument, out last, out bid, out ask, out volume);
+            priceRequestCount++;
+            Heartbeat();
+            
+            return BuildRecord(TAG_QUOTE, w => { w.Write(last); w.Write(bid); w.Write(ask); w.Write((double)volume); });
+        }
+        
+        private byte[] EncodeAccount()
+        {
+            if (currentAccount == null)
+                return null;
+            
+            double cashValue = currentAccount.Get(AccountItem.CashValue, Currency.UsDollar);
+            double buyingPower = currentAccount.Get(AccountItem.BuyingPower, Currency.UsDollar);
+            double realizedPnL = currentAccount.Get(AccountItem.RealizedProfitLoss, Currency.UsDollar);
+            double unrealizedPnL = ComputeUnrealizedPnL();
+            
+            return BuildRecord(TAG_ACCOUNT, w => { w.Write(cashValue); w.Write(buyingPower); w.Write(realizedPnL); w.Write(unrealizedPnL); });
+        }
+        
+        private byte[] EncodePosition(string[] parts)
+        {
+            if (currentAccount == null || parts.Length < 2)
+                return null;
+            
+            Instrument instrument = Instrument.GetInstrument(parts[1]);
+            if (instrument == null)
+                return null;
+            
+            int position;
+            double avgPrice;
+            FindPosition(instrument, out position, out avgPrice);
+            
+            return BuildRecord(TAG_POSITION, w => { w.Write(position); w.Write(avgPrice); });
+        }
+        
+        private byte[] EncodeOrderStatus(string[] parts)
+        {
+            Order order;
+            if (parts.Length < 2 || !activeOrders.TryGetValue(parts[1], out order))
+                return null;
+            
+            // State name zero-padded to a fixed width (longest NT8 state fits)
+            byte[] state = new byte[ORDER_STATE_LENGTH];
+            byte[] name = Encoding.ASCII.GetBytes(order.OrderState.ToString());
+            Array.Copy(name, state, Math.Min(name.Length, ORDER_STATE_LENGTH - 1));
+            int filled = order.Filled;
+            double avgFillPrice = order.AverageFillPrice;
+            
+            return BuildRecord(TAG_ORDERSTATUS, w => { w.Write(state); w.Write(filled); w.Write(avgFillPrice); });
+        }
+        
+        private byte[] EncodeHistory(string[] parts)
+        {
+            Bars bars;
+            string error = RequestBars(parts, out bars);
+            if (error != null)
+                return Encoding.UTF8.GetBytes(error);  // Text error reply, same as the text codec
+            
+            int barCount = bars != null ? bars.Count : 0;
+            Log(LogLevel.INFO, $"Returning {barCount} bars for {parts[1]} (binary)");
+            
+            return BuildRecord(TAG_HISTORY, w =>
+            {
+                w.Write(barCount);
+                for (int i = 0; i < barCount; i++)
+                {
+                    w.Write(BarTimeUtc(bars, i));
+                    w.Write((float)bars.GetOpen(i));
+                    w.Write((float)bars.GetHigh(i));
+                    w.Write((float)bars.GetLow(i));
+                    w.Write((float)bars.GetClose(i));
+                    w.Write((float)bars.GetVolume(i));
+                }
+            });
+        }
+
         private string HandleLogin(string[] parts)
         {
             if (parts.Length < 2)
@@ -338,6 +1031,10 @@ namespace NinjaTrader.NinjaScript.AddOns
                 currentAccount = null;
             }
             subscribedInstruments.Clear();
+            foreach (string instrumentName in quoteFeeds.Keys.ToList())
+                StopQuoteFeed(instrumentName);
+            foreach (string instrumentName in depthFeeds.Keys.ToList())
+                StopDepthFeed(instrumentName);
             return "OK:Logged out";
         }
 
@@ -365,6 +1062,7 @@ namespace NinjaTrader.NinjaScript.AddOns
             }
 
             subscribedInstruments[instrumentName] = instrument;
+            StartQuoteFeed(instrumentName, instrument);
             
             // Get contract specifications
             double tickSize = instrument.MasterInstrument.TickSize;
@@ -390,10 +1088,162 @@ namespace NinjaTrader.NinjaScript.AddOns
             // **FIXED: ConcurrentDictionary uses TryRemove instead of Remove**
             Instrument removedInstrument;
             subscribedInstruments.TryRemove(instrumentName, out removedInstrument);
+            StopQuoteFeed(instrumentName);
+            StopDepthFeed(instrumentName);
             
             return $"OK:Unsubscribed from {instrumentName}";
         }
 
+        // Start pushing updates for an instrument to STREAM clients
+        private void StartQuoteFeed(string instrumentName, Instrument instrument)
+        {
+            if (quoteFeeds.ContainsKey(instrumentName))
+                return;
+            
+            QuoteFeed feed = new QuoteFeed();
+            feed.Data = new MarketData(instrument);
+            feed.Handler = (sender, e) => PublishQuote(instrumentName, instrument);
+            
+            if (quoteFeeds.TryAdd(instrumentName, feed))
+                feed.Data.Update += feed.Handler;
+        }
+        
+        private void StopQuoteFeed(string instrumentName)
+        {
+            QuoteFeed feed;
+            if (quoteFeeds.TryRemove(instrumentName, out feed))
+                feed.Data.Update -= feed.Handler;
+        }
+        
+        // Push format: QUOTE:{instrument}:{last}:{bid}:{ask}:{volume}:{time}
+        private void PublishQuote(string instrumentName, Instrument instrument)
+        {
+            lock (quoteStreamsLock)
+            {
+                if (quoteStreams.Count == 0)
+                    return;
+            }
+            
+            try
+            {
+                double last = 0, bid = 0, ask = 0;
+                long volume = 0;
+                
+                if (instrument.MarketData.Last != null)
+                    last = instrument.MarketData.Last.Price;
+                if (instrument.MarketData.Bid != null)
+                    bid = instrument.MarketData.Bid.Price;
+                if (instrument.MarketData.Ask != null)
+                    ask = instrument.MarketData.Ask.Price;
+                if (instrument.MarketData.DailyVolume != null)
+                    volume = instrument.MarketData.DailyVolume.Volume;
+                
+                double time = DateTime.UtcNow.ToOADate();
+                BroadcastLine(Encoding.UTF8.GetBytes($"QUOTE:{instrumentName}:{last}:{bid}:{ask}:{volume}:{time}\n"));
+            }
+            catch (Exception ex)
+            {
+                Log(LogLevel.WARN, $"Error publishing quote for {instrumentName}: {ex.Message}");
+            }
+        }
+        
+        // Write one push line to every STREAM client
+        private void BroadcastLine(byte[] line)
+        {
+            lock (quoteStreamsLock)
+            {
+                for (int i = quoteStreams.Count - 1; i >= 0; i--)
+                {
+                    try
+                    {
+                        quoteStreams[i].Write(line, 0, line.Length);
+                    }
+                    catch (Exception)
+                    {
+                        quoteStreams.RemoveAt(i);  // Client went away
+                    }
+                }
+            }
+        }
+        
+        private string HandleSubscribeDepth(string[] parts)
+        {
+            // SUBSCRIBEDEPTH:symbol - the instrument must be subscribed
+            if (parts.Length < 2)
+                return "ERROR:Instrument name required";
+            
+            string instrumentName = parts[1];
+            Instrument instrument;
+            if (!subscribedInstruments.TryGetValue(instrumentName, out instrument) || instrument == null)
+            {
+                Log(LogLevel.ERROR, $"Not subscribed to {instrumentName}");
+                return "ERROR:Not subscribed to instrument";
+            }
+            
+            StartDepthFeed(instrumentName, instrument);
+            Log(LogLevel.INFO, $"Market depth for {instrumentName}");
+            return $"OK:Depth:{instrumentName}";
+        }
+        
+        // Start pushing depth rows for an instrument to STREAM clients
+        private void StartDepthFeed(string instrumentName, Instrument instrument)
+        {
+            if (depthFeeds.ContainsKey(instrumentName))
+                return;
+            
+            DepthFeed feed = new DepthFeed();
+            feed.Depth = new MarketDepth<MarketDepthRow>(instrument);
+            feed.Handler = (sender, e) => PublishDepth(instrumentName, e);
+            
+            if (depthFeeds.TryAdd(instrumentName, feed))
+                feed.Depth.Update += feed.Handler;
+        }
+        
+        private void StopDepthFeed(string instrumentName)
+        {
+            DepthFeed feed;
+            if (depthFeeds.TryRemove(instrumentName, out feed))
+                feed.Depth.Update -= feed.Handler;
+        }
+        
+        // Push format: DEPTH:{instrument}:{side}:{operation}:{position}:{price}:{volume}:{time}
+        // side 0 = ask, 1 = bid; operation 0 = add, 1 = update, 2 = remove
+        private void PublishDepth(string instrumentName, MarketDepthEventArgs e)
+        {
+            lock (quoteStreamsLock)
+            {
+                if (quoteStreams.Count == 0)
+                    return;
+            }
+            
+            int side;
+            if (e.MarketDataType == MarketDataType.Ask)
+                side = 0;
+            else if (e.MarketDataType == MarketDataType.Bid)
+                side = 1;
+            else
+                return;
+            
+            int operation;
+            if (e.Operation == Operation.Add)
+                operation = 0;
+            else if (e.Operation == Operation.Update)
+                operation = 1;
+            else
+                operation = 2;
+            
+            try
+            {
+                double time = DateTime.UtcNow.ToOADate();
+                BroadcastLine(Encoding.UTF8.GetBytes(
+                    $"DEPTH:{instrumentName}:{side}:{operation}:{e.Position}:{e.Price}:{e.Volume}:{time}\n"));
+            }
+            catch (Exception ex)
+            {
+                Log(LogLevel.WARN, $"Error publishing depth for {instrumentName}: {ex.Message}");
+            }
+        }
+
         private string HandleGetPrice(string[] parts)
         {
             if (parts.Length < 2)
@@ -419,22 +1269,9 @@ namespace NinjaTrader.NinjaScript.AddOns
             
             try
             {
-                double last = 0;
-                double bid = 0;
-                double ask = 0;
-                long volume = 0;
-                
-                if (instrument.MarketData.Last != null)
-                    last = instrument.MarketData.Last.Price;
-                    
-                if (instrument.MarketData.Bid != null)
-                    bid = instrument.MarketData.Bid.Price;
-                    
-                if (instrument.MarketData.Ask != null)
-                    ask = instrument.MarketData.Ask.Price;
-                    
-                if (instrument.MarketData.DailyVolume != null)
-                    volume = instrument.MarketData.DailyVolume.Volume;
+                double last, bid, ask;
+                long volume;
+                ReadQuote(instrument, out last, out bid, out ask, out volume);
 
                 priceRequestCount++;
                 Heartbeat();  // Check if we should log heartbeat
@@ -454,6 +1291,61 @@ namespace NinjaTrader.NinjaScript.AddOns
             }
         }
 
+        private string HandleGetPrices(string[] parts)
+        {
+            // GETPRICES:instrument1,instrument2,...
+            // Returns: PRICES:{count}|instrument,last,bid,ask,volume|...
+            // One reply for a whole portfolio sweep; instruments that aren't
+            // subscribed are left out
+            
+            if (parts.Length < 2 || string.IsNullOrEmpty(parts[1]))
+                return "PRICES:0";
+            
+            StringBuilder entries = new StringBuilder();
+            int count = 0;
+            
+            foreach (string zorroSymbol in parts[1].Split(','))
+            {
+                Instrument instrument;
+                if (!subscribedInstruments.TryGetValue(zorroSymbol, out instrument) || instrument == null)
+                    continue;
+                
+                double last, bid, ask;
+                long volume;
+                ReadQuote(instrument, out last, out bid, out ask, out volume);
+                
+                entries.Append($"|{zorroSymbol},{last},{bid},{ask},{volume}");
+                count++;
+            }
+            
+            priceRequestCount++;
+            Heartbeat();
+            
+            Log(LogLevel.TRACE, $"Prices: {count} instruments");
+            
+            return $"PRICES:{count}{entries}";
+        }
+
+        private static void ReadQuote(Instrument instrument, out double last, out double bid, out double ask, out long volume)
+        {
+            last = 0;
+            bid = 0;
+            ask = 0;
+            volume = 0;
+            
+            if (instrument.MarketData.Last != null)
+                last = instrument.MarketData.Last.Price;
+                
+            if (instrument.MarketData.Bid != null)
+                bid = instrument.MarketData.Bid.Price;
+                
+            if (instrument.MarketData.Ask != null)
+                ask = instrument.MarketData.Ask.Price;
+                
+            if (instrument.MarketData.DailyVolume != null)
+                volume = instrument.MarketData.DailyVolume.Volume;
+        }
+
         private string HandleGetAccount()
         {
             if (currentAccount == null)
@@ -462,8 +1354,17 @@ namespace NinjaTrader.NinjaScript.AddOns
             double cashValue = currentAccount.Get(AccountItem.CashValue, Currency.UsDollar);
             double buyingPower = currentAccount.Get(AccountItem.BuyingPower, Currency.UsDollar);
             double realizedPnL = currentAccount.Get(AccountItem.RealizedProfitLoss, Currency.UsDollar);
+            double unrealizedPnL = ComputeUnrealizedPnL();
+
+            Log(LogLevel.DEBUG, $"Account: Cash={cashValue} BuyPwr={buyingPower} RealPnL={realizedPnL} UnrealPnL={unrealizedPnL}");
+
+            // Return format: ACCOUNT:cashValue:buyingPower:realizedPnL:unrealizedPnL
+            return $"ACCOUNT:{cashValue}:{buyingPower}:{realizedPnL}:{unrealizedPnL}";
+        }
 
-            // Calculate unrealized P&L from open positions
+        // Calculate unrealized P&L from open positions
+        private double ComputeUnrealizedPnL()
+        {
             double unrealizedPnL = 0;
             
             foreach (Position pos in currentAccount.Positions)
@@ -510,10 +1411,7 @@ namespace NinjaTrader.NinjaScript.AddOns
                 }
             }
 
-            Log(LogLevel.DEBUG, $"Account: Cash={cashValue} BuyPwr={buyingPower} RealPnL={realizedPnL} UnrealPnL={unrealizedPnL}");
-
-            // Return format: ACCOUNT:cashValue:buyingPower:realizedPnL:unrealizedPnL
-            return $"ACCOUNT:{cashValue}:{buyingPower}:{realizedPnL}:{unrealizedPnL}";
+            return unrealizedPnL;
         }
 
         private string HandleGetPosition(string[] parts)
@@ -544,9 +1442,68 @@ namespace NinjaTrader.NinjaScript.AddOns
                 return "ERROR:Instrument not found";
             }
 
-            // Find position by iterating through positions
-            int position = 0;
-            double avgPrice = 0;
+            int position;
+            double avgPrice;
+            FindPosition(instrument, out position, out avgPrice);
+
+            if (position == 0)
+                Log(LogLevel.DEBUG, "No position found (flat)");
+            
+            Log(LogLevel.INFO, $"POSITION QUERY: {instrumentName} = {position} contracts @ {avgPrice}");
+            Log(LogLevel.DEBUG, "==== HandleGetPosition END ====");
+            
+            return $"POSITION:{position}:{avgPrice}";
+        }
+
+        // Find position by iterating through positions (signed quantity, 0 if flat)
+        private string HandleGetPositions()
+        {
+            // GETPOSITIONS
+            // Returns: POSITIONS:{count}|instrument,quantity,avgPrice|...
+            // Every non-flat position in one scan; quantity is signed (negative = short).
+            // A position in a subscribed instrument is reported under the name it was
+            // subscribed with, so the plugin can key its position book by Zorro's symbol.
+            
+            if (currentAccount == null)
+                return "ERROR:Not logged in";
+            
+            StringBuilder entries = new StringBuilder();
+            int count = 0;
+            
+            foreach (Position pos in currentAccount.Positions)
+            {
+                if (pos.MarketPosition == MarketPosition.Flat)
+                    continue;
+                
+                int quantity = (pos.MarketPosition == MarketPosition.Long) ? pos.Quantity : -pos.Quantity;
+                bool named = false;
+                
+                foreach (var pair in subscribedInstruments)
+                {
+                    if (pair.Value == pos.Instrument)
+                    {
+                        entries.Append($"|{pair.Key},{quantity},{pos.AveragePrice}");
+                        count++;
+                        named = true;
+                    }
+                }
+                
+                if (!named)
+                {
+                    entries.Append($"|{pos.Instrument.FullName},{quantity},{pos.AveragePrice}");
+                    count++;
+                }
+            }
+            
+            Log(LogLevel.DEBUG, $"Positions: {count} entries");
+            
+            return $"POSITIONS:{count}{entries}";
+        }
+
+        private void FindPosition(Instrument instrument, out int position, out double avgPrice)
+        {
+            position = 0;
+            avgPrice = 0;
             
             Log(LogLevel.TRACE, $"Searching {currentAccount.Positions.Count()} positions for {instrument.FullName}");
             
@@ -570,14 +1527,6 @@ namespace NinjaTrader.NinjaScript.AddOns
                     break;
                 }
             }
-
-            if (position == 0)
-                Log(LogLevel.DEBUG, "No position found (flat)");
-            
-            Log(LogLevel.INFO, $"POSITION QUERY: {instrumentName} = {position} contracts @ {avgPrice}");
-            Log(LogLevel.DEBUG, "==== HandleGetPosition END ====");
-            
-            return $"POSITION:{position}:{avgPrice}";
         }
 
         private string HandlePlaceOrder(string[] parts)
@@ -730,6 +1679,33 @@ namespace NinjaTrader.NinjaScript.AddOns
             return $"ORDERSTATUS:{orderId}:{state}:{filled}:{avgFillPrice}";
         }
         
+        private string HandleGetOrderStatuses(string[] parts)
+        {
+            // GETORDERSTATUSES:orderId1,orderId2,...
+            // Returns: ORDERSTATUSES:{count}|orderId,state,filled,avgFillPrice|...
+            // One reply for every trade Zorro polls in a cycle; unknown IDs are left out
+            
+            if (parts.Length < 2 || string.IsNullOrEmpty(parts[1]))
+                return "ORDERSTATUSES:0";
+            
+            StringBuilder entries = new StringBuilder();
+            int count = 0;
+            
+            foreach (string orderId in parts[1].Split(','))
+            {
+                Order order;
+                if (!activeOrders.TryGetValue(orderId, out order))
+                    continue;
+                
+                entries.Append($"|{orderId},{order.OrderState},{order.Filled},{order.AverageFillPrice}");
+                count++;
+            }
+            
+            Log(LogLevel.TRACE, $"Order statuses: {count} known");
+            
+            return $"ORDERSTATUSES:{count}{entries}";
+        }
+        
         private string HandleSetLogLevel(string[] parts)
         {
             // SETLOGLEVEL:TRACE/DEBUG/INFO/WARN/ERROR
@@ -758,6 +1734,61 @@ namespace NinjaTrader.NinjaScript.AddOns
             // GETHISTORY:symbol:startDate:endDate:barMinutes:maxBars
             // Returns: HISTORY:{numBars}|time,open,high,low,close,volume|...
             
+            Bars bars;
+            string error = RequestBars(parts, out bars);
+            if (error != null)
+                return error;
+            
+            if (bars == null || bars.Count == 0)
+            {
+                Log(LogLevel.WARN, "No bars available for requested period");
+                return "HISTORY:0";
+            }
+            
+            // Return ALL bars available (don't limit artificially)
+            // Zorro will handle chunking if needed
+            StringBuilder barsData = new StringBuilder();
+            int barCount = bars.Count;
+            
+            for (int i = 0; i < barCount; i++)
+            {
+                // Convert time to OLE date (UTC)
+                double oleTime = BarTimeUtc(bars, i);
+                
+                // Format: time,open,high,low,close,volume
+                barsData.Append($"{oleTime},{bars.GetOpen(i)},{bars.GetHigh(i)},{bars.GetLow(i)},{bars.GetClose(i)},{bars.GetVolume(i)}|");
+            }
+            
+            // Remove trailing |
+            barsData.Length--;
+            
+            Log(LogLevel.INFO, $"Returning {barCount} bars for {parts[1]}");
+            Log(LogLevel.DEBUG, "==== HandleGetHistory SUCCESS ====");
+            return $"HISTORY:{barCount}|{barsData}";
+        }
+        
+        // Bar times from NinjaTrader are in its configured time zone (Tools >
+        // Options > General), history replies are in UTC like every other time
+        // on the wire, so the plugin can merge them with its own UTC bars.
+        private static double BarTimeUtc(Bars bars, int index)
+        {
+            DateTime local = DateTime.SpecifyKind(bars.GetTime(index), DateTimeKind.Unspecified);
+            return TimeZoneInfo.ConvertTimeToUtc(local, Core.Globals.GeneralOptions.TimeZoneInfo).ToOADate();
+        }
+        
+        private static DateTime UtcToLocal(DateTime utc)
+        {
+            utc = DateTime.SpecifyKind(utc, DateTimeKind.Utc);
+            return TimeZoneInfo.ConvertTimeFromUtc(utc, Core.Globals.GeneralOptions.TimeZoneInfo);
+        }
+        
+        // Run a BarsRequest for GETHISTORY:symbol:startDate:endDate:barMinutes:maxBars
+        // and wait for it. Returns an ERROR:... reply on failure, otherwise null
+        // with 'bars' set (null if NinjaTrader returned no bars).
+        private string RequestBars(string[] parts, out Bars bars)
+        {
+            bars = null;
+            
             Log(LogLevel.DEBUG, "==== HandleGetHistory START ====");
             Log(LogLevel.TRACE, $"Parts: {string.Join(":", parts)}");
             
@@ -783,9 +1814,10 @@ namespace NinjaTrader.NinjaScript.AddOns
                 
                 Log(LogLevel.DEBUG, $"History request: {instrumentName} {barMinutes}min bars, max {maxBars}");
                 
-                // Convert OLE dates to DateTime (OLE epoch is Dec 30, 1899)
-                DateTime startDate = DateTime.FromOADate(startOleDate);
-                DateTime endDate = DateTime.FromOADate(endOleDate);
+                // Convert OLE dates to DateTime (OLE epoch is Dec 30, 1899).
+                // Zorro asks in UTC, BarsRequest takes NinjaTrader's local time.
+                DateTime startDate = UtcToLocal(DateTime.FromOADate(startOleDate));
+                DateTime endDate = UtcToLocal(DateTime.FromOADate(endOleDate));
                 
                 Log(LogLevel.DEBUG, $"Date range: {startDate} to {endDate}");
                 
@@ -799,9 +1831,7 @@ namespace NinjaTrader.NinjaScript.AddOns
                 
                 Log(LogLevel.TRACE, $"Instrument: {instrument.FullName}");
                 
-                // Build bars response synchronously
-                StringBuilder barsData = new StringBuilder();
-                int barCount = 0;
+                Bars result = null;
                 bool requestComplete = false;
                 string errorMsg = null;
                 
@@ -830,20 +1860,8 @@ namespace NinjaTrader.NinjaScript.AddOns
                         return;
                     }
                     
-                    // Return ALL bars available (don't limit artificially)
-                    // Zorro will handle chunking if needed
                     Log(LogLevel.DEBUG, $"NT8 returned {request.Bars.Count} bars");
-                    
-                    for (int i = 0; i < request.Bars.Count; i++)
-                    {
-                        // Convert time to OLE date
-                        double oleTime = request.Bars.GetTime(i).ToOADate();
-                        
-                        // Format: time,open,high,low,close,volume
-                        barsData.Append($"{oleTime},{request.Bars.GetOpen(i)},{request.Bars.GetHigh(i)},{request.Bars.GetLow(i)},{request.Bars.GetClose(i)},{request.Bars.GetVolume(i)}|");
-                        barCount++;
-                    }
-                    
+                    result = request.Bars;
                     requestComplete = true;
                 });
                 
@@ -867,19 +1885,8 @@ namespace NinjaTrader.NinjaScript.AddOns
                     return $"ERROR:{errorMsg}";
                 }
                 
-                if (barCount == 0)
-                {
-                    Log(LogLevel.WARN, "No bars available for requested period");
-                    return "HISTORY:0";
-                }
-                
-                // Remove trailing |
-                if (barsData.Length > 0)
-                    barsData.Length--;
-                
-                Log(LogLevel.INFO, $"Returning {barCount} bars for {instrumentName}");
-                Log(LogLevel.DEBUG, "==== HandleGetHistory SUCCESS ====");                
-                return $"HISTORY:{barCount}|{barsData}";
+                bars = result;
+                return null;
             }
             catch (Exception ex)
             {
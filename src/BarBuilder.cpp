@@ -0,0 +1,209 @@
+// BarBuilder.cpp - Real-time OHLCV bars from the observed quote stream
+// Copyright (c) 2025
+
+#include "BarBuilder.h"
+#include <algorithm>
+#include <cmath>
+
+static constexpr double SECONDS_PER_DAY = 24.0 * 60.0 * 60.0;
+
+static long long SecondsOf(DATE time)
+{
+    return std::llround(time * SECONDS_PER_DAY);
+}
+
+// More than MAX_GAP_SECONDS from one time to another, in whole seconds so
+// the limit itself is no gap
+static bool Gap(DATE from, DATE to)
+{
+    return SecondsOf(to) - SecondsOf(from) > BarBuilder::MAX_GAP_SECONDS;
+}
+
+// End time of bar 'bucket' of a period
+static DATE BarEnd(long long bucket, int minutes)
+{
+    return (double)((bucket + 1) * minutes * 60) / SECONDS_PER_DAY;
+}
+
+//=============================================================================
+// Configuration
+//=============================================================================
+
+BarBuilder::BarBuilder()
+    : m_periods{ 1 }    // Zorro's history requests are M1 by default
+{
+}
+
+bool BarBuilder::AddPeriod(int minutes)
+{
+    if (minutes < 1 || minutes > 1440) {
+        return false;
+    }
+    if (HasPeriod(minutes)) {
+        return true;
+    }
+    if ((int)m_periods.size() >= MAX_PERIODS) {
+        return false;
+    }
+
+    m_periods.push_back(minutes);
+    m_assets.clear();   // Series are rebuilt per period from the next quote
+    return true;
+}
+
+void BarBuilder::ClearPeriods()
+{
+    m_periods.clear();
+    m_assets.clear();
+}
+
+bool BarBuilder::HasPeriod(int minutes) const
+{
+    return std::find(m_periods.begin(), m_periods.end(), minutes) != m_periods.end();
+}
+
+//=============================================================================
+// Aggregation
+//=============================================================================
+
+void BarBuilder::Update(std::string_view symbol, DATE time, double price, double volume)
+{
+    if (m_periods.empty() || price <= 0 || time <= 0) {
+        return;
+    }
+
+    auto it = m_assets.find(symbol);
+    if (it == m_assets.end()) {
+        std::vector<Series> series(m_periods.size());
+        for (size_t i = 0; i < m_periods.size(); i++) {
+            series[i].minutes = m_periods[i];
+        }
+        it = m_assets.emplace(std::string(symbol), std::move(series)).first;
+    }
+
+    for (Series& series : it->second) {
+        Update(series, time, (float)price, volume);
+    }
+}
+
+void BarBuilder::Update(Series& series, DATE time, float price, double volume)
+{
+    // Quotes stopped for a while - bars in between may be missing
+    if (series.lastUpdate > 0 && Gap(series.lastUpdate, time)) {
+        series.bars.clear();
+        series.bucket = -1;
+        series.coveredFrom = 0;
+    }
+
+    long long bucket = SecondsOf(time) / (series.minutes * 60);
+    if (bucket < series.bucket) {
+        return;   // Late quote of a closed bar
+    }
+
+    // Volume traded since the previous quote; the daily counter may reset
+    double traded = (series.lastVolume > 0 && volume >= series.lastVolume) ? volume - series.lastVolume : 0;
+    series.lastVolume = volume;
+    series.lastUpdate = std::max(series.lastUpdate, time);
+
+    if (bucket == series.bucket) {
+        T6& bar = series.current;
+        bar.fHigh = std::max(bar.fHigh, price);
+        bar.fLow = std::min(bar.fLow, price);
+        bar.fClose = price;
+        bar.fVol += (float)traded;
+        return;
+    }
+
+    // New bar: keep the finished one unless it was only partly seen
+    if (series.bucket >= 0) {
+        if (!series.partial) {
+            series.bars.push_back(series.current);
+            if (series.bars.size() > MAX_BARS) {
+                series.bars.pop_front();
+                series.coveredFrom = series.bars.front().time;
+            }
+        }
+        if (series.coveredFrom == 0) {
+            // The partial bar's successor is the first complete one
+            series.coveredFrom = BarEnd(series.bucket + 1, series.minutes);
+        }
+    }
+
+    series.bucket = bucket;
+    series.partial = (series.coveredFrom == 0);
+    series.current = T6();
+    series.current.time = BarEnd(bucket, series.minutes);
+    series.current.fOpen = series.current.fHigh = series.current.fLow = series.current.fClose = price;
+    series.current.fVol = (float)traded;
+}
+
+//=============================================================================
+// Serving
+//=============================================================================
+
+const BarBuilder::Series* BarBuilder::Find(std::string_view symbol, int minutes) const
+{
+    auto it = m_assets.find(symbol);
+    if (it == m_assets.end()) {
+        return nullptr;
+    }
+    for (const Series& series : it->second) {
+        if (series.minutes == minutes) {
+            return &series;
+        }
+    }
+    return nullptr;
+}
+
+bool BarBuilder::CurrentComplete(const Series& series, DATE now)
+{
+    return series.bucket >= 0 && !series.partial && now >= series.current.time;
+}
+
+DATE BarBuilder::CoveredFrom(std::string_view symbol, int minutes, DATE now) const
+{
+    const Series* series = Find(symbol, minutes);
+    if (!series || Gap(series->lastUpdate, now)) {
+        return 0;
+    }
+
+    bool hasBars = !series->bars.empty() || CurrentComplete(*series, now);
+    return hasBars ? series->coveredFrom : 0;
+}
+
+int BarBuilder::Copy(std::string_view symbol, int minutes, DATE tStart, DATE tEnd, DATE now,
+                     T6* ticks, int nTicks) const
+{
+    const Series* series = Find(symbol, minutes);
+    if (!series || nTicks <= 0) {
+        return 0;
+    }
+
+    auto first = std::lower_bound(series->bars.begin(), series->bars.end(), tStart,
+                                  [](const T6& bar, DATE t) { return bar.time < t; });
+    int count = 0;
+    for (auto it = first; it != series->bars.end() && it->time <= tEnd && count < nTicks; ++it) {
+        ticks[count++] = *it;
+    }
+
+    const T6& current = series->current;
+    if (count < nTicks && CurrentComplete(*series, now) && current.time >= tStart && current.time <= tEnd) {
+        ticks[count++] = current;
+    }
+    return count;
+}
+
+int BarBuilder::Merge(std::string_view symbol, int minutes, DATE tStart, DATE tEnd, DATE now,
+                      T6* ticks, int loaded, int nTicks) const
+{
+    if (loaded >= nTicks) {
+        return loaded;
+    }
+
+    // Half a second past the last fetched bar: bar times are whole seconds
+    DATE from = tStart;
+    if (loaded > 0) {
+        from = std::max(from, ticks[loaded - 1].time + 0.5 / SECONDS_PER_DAY);
+    }
+    return loaded + Copy(symbol, minutes, from, tEnd, now, ticks + loaded, nTicks - loaded);
+}
@@ -0,0 +1,513 @@
+// BridgeChannel.cpp - Request/reply connection implementation
+// Copyright (c) 2025
+
+#include "BridgeChannel.h"
+#include <cstdio>
+#include <cstring>
+
+//=============================================================================
+// Constructor / Destructor
+//=============================================================================
+
+template <typename Transport>
+BasicBridgeChannel<Transport>::BasicBridgeChannel(size_t bufferCapacity)
+    : m_connected(false)
+    , m_framed(false)
+    , m_tagged(false)
+    , m_nextTag(1)
+    , m_codec(Codec::Text)
+    , m_recvBuffer(bufferCapacity)
+    , m_abandoned(0)
+{
+}
+
+template <typename Transport>
+BasicBridgeChannel<Transport>::~BasicBridgeChannel()
+{
+    Close();
+}
+
+//=============================================================================
+// Connection Management
+//=============================================================================
+
+template <typename Transport>
+bool BasicBridgeChannel<Transport>::Open(const char* host, int port, Codec preferredCodec, bool sharedMemory)
+{
+    Close();
+    
+    if (!m_transport.Connect(host, port)) {
+        return false;
+    }
+    
+    // Replies are awaited with Wait() up to each request's deadline
+    if (!m_transport.SetNonBlocking(true)) {
+        m_transport.Close();
+        return false;
+    }
+    
+    m_connected = true;
+    
+    // Test connection with PING
+    std::string_view response = SendCommand("PING");
+    if (response != "PONG") {
+        Close();
+        return false;
+    }
+    
+    // Switch to length-prefixed replies if the AddOn supports them, then
+    // to binary records (they can contain '\n', so they need framing)
+    if (NegotiateFraming()) {
+        if (preferredCodec == Codec::Binary) {
+            NegotiateCodec();
+        }
+        
+        NegotiateTags();
+        
+        // Same machine: move requests and replies into shared memory
+        if (sharedMemory) {
+            NegotiateSharedMemory();
+        }
+    }
+    
+    return true;
+}
+
+template <typename Transport>
+void BasicBridgeChannel<Transport>::Close()
+{
+    m_shm.Close();
+    m_transport.Close();
+    
+    m_connected = false;
+    m_framed = false;
+    m_tagged = false;
+    m_codec = Codec::Text;
+    m_abandoned = 0;
+    m_recvBuffer.Clear();
+}
+
+// Ask the AddOn for length-prefixed replies via the VERSION command.
+// Older AddOns ignore the argument and answer "VERSION:1.0", in which case
+// we stay in newline mode. The acknowledgement itself is still newline-
+// terminated; every reply after it carries a 4-byte length header.
+template <typename Transport>
+bool BasicBridgeChannel<Transport>::NegotiateFraming()
+{
+    std::string_view response = SendCommand("VERSION:FRAMED");
+    
+    const std::string_view ack = ":FRAMED";
+    if (response.size() > ack.size() &&
+        response.compare(0, 8, "VERSION:") == 0 &&
+        response.compare(response.size() - ack.size(), ack.size(), ack) == 0) {
+        m_framed = true;
+    }
+    
+    return m_framed;
+}
+
+// Ask for fixed-layout binary records for quote, account, order status,
+// position and history replies on this connection. AddOns without
+// binary support answer with an error and we keep the text codec.
+template <typename Transport>
+bool BasicBridgeChannel<Transport>::NegotiateCodec()
+{
+    std::string_view response = SendCommand("CODEC:BINARY");
+    if (response.compare(0, 3, "OK:") == 0) {
+        m_codec = Codec::Binary;
+    }
+    
+    return m_codec == Codec::Binary;
+}
+
+// Ask for tagged requests, so replies can complete out of order. The
+// acknowledgement is the last untagged reply. AddOns without tag support
+// answer with an error and replies stay matched by order.
+template <typename Transport>
+bool BasicBridgeChannel<Transport>::NegotiateTags()
+{
+    std::string_view response = SendCommand("TAGS:ON");
+    if (response.compare(0, 7, "OK:Tags") == 0) {
+        m_tagged = true;
+    }
+    
+    return m_tagged;
+}
+
+// Ask the AddOn for a shared-memory session (see SharedMemoryLink.h). The
+// reply names the mapping; from then on this channel's requests and framed
+// replies go through the rings and the socket only signals liveness. If
+// the mapping can't be opened, SHM:CLOSE tells the AddOn to stay on TCP.
+template <typename Transport>
+bool BasicBridgeChannel<Transport>::NegotiateSharedMemory()
+{
+    std::string_view response = SendCommand("SHM:OPEN");
+    
+    const std::string_view ack = "OK:SHM:";
+    if (response.compare(0, ack.size(), ack) != 0 ||
+        response.size() - ack.size() >= SharedMemoryLink::MAX_NAME_LENGTH) {
+        return false;
+    }
+    
+    char name[SharedMemoryLink::MAX_NAME_LENGTH];
+    memcpy(name, response.data() + ack.size(), response.size() - ack.size());
+    name[response.size() - ack.size()] = '\0';
+    
+    if (!m_shm.Open(name)) {
+        SendCommand("SHM:CLOSE");
+        return false;
+    }
+    
+    return true;
+}
+
+//=============================================================================
+// Communication Helper
+//=============================================================================
+
+template <typename Transport>
+std::string_view BasicBridgeChannel<Transport>::SendCommand(std::string_view command, int timeoutMs)
+{
+    std::string_view reply;
+    SendBatch(&command, 1, &reply, timeoutMs);
+    return reply;
+}
+
+template <typename Transport>
+size_t BasicBridgeChannel<Transport>::SendBatch(const std::string_view* commands, size_t count,
+                                                std::string_view* replies, int timeoutMs)
+{
+    if (count == 0) {
+        return 0;
+    }
+    
+    if (!m_connected || !m_transport.IsOpen()) {
+        FillReplies(replies, 0, count, "ERROR:Not connected");
+        return 0;
+    }
+    
+    // Pipeline: all commands go out in a single send() (the send buffer
+    // keeps its capacity between calls). Tagged: the batch takes the tags
+    // firstTag .. firstTag + count - 1.
+    uint32_t firstTag = m_nextTag;
+    m_sendBuffer.clear();
+    for (size_t i = 0; i < count; i++) {
+        if (m_tagged) {
+            char prefix[16];
+            int length = snprintf(prefix, sizeof(prefix), "#%u ", (unsigned)m_nextTag++);
+            m_sendBuffer.append(prefix, length);
+        }
+        m_sendBuffer.append(commands[i].data(), commands[i].size());
+        m_sendBuffer += '\n';
+    }
+    
+    // The deadline covers sending too: a full shared-memory ring or socket
+    // buffer means the AddOn has stopped reading
+    m_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    int sent = SendAll(m_sendBuffer.data(), m_sendBuffer.size());
+    if (sent == 0) {
+        FillReplies(replies, 0, count, TIMEOUT_REPLY);  // Nothing went out - no replies owed
+        return 0;
+    }
+    if (sent < 0) {
+        m_connected = false;
+        FillReplies(replies, 0, count, "ERROR:Send failed");
+        return 0;
+    }
+    
+    m_batchOffsets.clear();
+    size_t received = 0;
+    
+    try {
+        if (m_tagged) {
+            return ReceiveTagged(firstTag, count, replies);
+        }
+        
+        // Replies to commands that timed out earlier arrive first - drop
+        // them so they can't be taken for the answers to this batch
+        while (m_abandoned > 0) {
+            std::string_view late;
+            ReceiveStatus status = ReceiveReply(late);
+            if (status == ReceiveStatus::Failed) {
+                FillReplies(replies, 0, count, late);  // Error text
+                return 0;
+            }
+            if (status == ReceiveStatus::Timeout) {
+                m_abandoned += count;
+                FillReplies(replies, 0, count, TIMEOUT_REPLY);
+                return 0;
+            }
+            m_abandoned--;
+        }
+        
+        // Replies handed out by the previous command are no longer referenced
+        m_recvBuffer.Compact();
+        
+        // Replies come back in request order. The buffer may grow (and move)
+        // while later replies are read, so remember offsets and build the
+        // views once everything is in.
+        for (; received < count; received++) {
+            std::string_view reply;
+            ReceiveStatus status = ReceiveReply(reply);
+            if (status != ReceiveStatus::Ok) {
+                if (status == ReceiveStatus::Timeout) {
+                    m_abandoned += count - received;
+                }
+                FillReplies(replies, received, count, reply);  // Error text
+                break;
+            }
+            
+            m_batchOffsets.push_back(m_recvBuffer.Offset(reply));
+            replies[received] = reply;
+        }
+    }
+    catch (...) {
+        // Only possible if the buffer failed to grow for a huge reply
+        m_recvBuffer.Clear();
+        m_connected = false;
+        m_abandoned = 0;
+        FillReplies(replies, 0, count, "ERROR:Exception in receive");
+        return 0;
+    }
+    
+    for (size_t i = 0; i < received; i++) {
+        replies[i] = m_recvBuffer.View(m_batchOffsets[i], replies[i].size());
+    }
+    
+    return received;
+}
+
+// Tagged replies complete in any order: each is filed into the pending
+// table by its tag. Tags outside this batch belong to commands that timed
+// out earlier; their replies are dropped.
+template <typename Transport>
+size_t BasicBridgeChannel<Transport>::ReceiveTagged(uint32_t firstTag, size_t count,
+                                                    std::string_view* replies)
+{
+    // Replies handed out by the previous command are no longer referenced
+    m_recvBuffer.Compact();
+    
+    m_pending.assign(count, PendingReply());
+    size_t received = 0;
+    std::string_view error;
+    
+    while (received < count) {
+        std::string_view reply;
+        uint32_t tag = 0;
+        if (ReceiveFrame(reply, tag) != ReceiveStatus::Ok) {
+            error = reply;  // Timeout or failure text
+            break;
+        }
+        
+        uint32_t index = tag - firstTag;   // Wraps for tags before this batch
+        if (index >= count || m_pending[index].done) {
+            continue;  // Late reply
+        }
+        
+        PendingReply& pending = m_pending[index];
+        pending.offset = m_recvBuffer.Offset(reply);
+        pending.length = reply.size();
+        pending.done = true;
+        received++;
+    }
+    
+    // The buffer may have moved while later replies were read
+    for (size_t i = 0; i < count; i++) {
+        replies[i] = m_pending[i].done ? m_recvBuffer.View(m_pending[i].offset, m_pending[i].length)
+                                       : error;
+    }
+    
+    return received;
+}
+
+template <typename Transport>
+void BasicBridgeChannel<Transport>::FillReplies(std::string_view* replies, size_t from, size_t to,
+                                                std::string_view error)
+{
+    for (size_t i = from; i < to; i++) {
+        replies[i] = error;
+    }
+}
+
+// Send the request bytes by the deadline. Returns 1 once all went out, 0
+// if the deadline passed before any did, or -1 if the link failed - also
+// when the deadline passes partway, since a half-sent request would put
+// the AddOn out of step.
+template <typename Transport>
+int BasicBridgeChannel<Transport>::SendAll(const char* data, size_t length)
+{
+    if (m_shm.IsOpen()) {
+        int sent = m_shm.Send(data, length, RemainingMs());
+        return sent > 0 ? 1 : sent;
+    }
+    
+    // send() may accept fewer bytes than requested - loop until done
+    bool partial = false;
+    while (length > 0) {
+        int sent = m_transport.Send(data, (int)length);
+        if (sent == WOULD_BLOCK) {
+            int remaining = RemainingMs();
+            if (remaining == 0) {
+                return partial ? -1 : 0;
+            }
+            if (m_transport.Wait(true, remaining) < 0) {
+                return -1;
+            }
+            continue;
+        }
+        if (sent <= 0) {
+            return -1;
+        }
+        data += sent;
+        length -= sent;
+        partial = true;
+    }
+    return 1;
+}
+
+template <typename Transport>
+int BasicBridgeChannel<Transport>::RemainingMs() const
+{
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        m_deadline - std::chrono::steady_clock::now()).count();
+    return left > 0 ? (int)left : 0;
+}
+
+// Receive from shared memory if negotiated, else the transport, waiting
+// until data arrives or the deadline passes. Returns the byte count, 0 on
+// timeout, or < 0 if the link failed.
+template <typename Transport>
+int BasicBridgeChannel<Transport>::Receive(char* buffer, int length)
+{
+    if (!m_shm.IsOpen()) {
+        for (;;) {
+            int received = m_transport.Recv(buffer, length, false);
+            if (received != WOULD_BLOCK) {
+                return received > 0 ? received : -1;
+            }
+            
+            int remaining = RemainingMs();
+            if (remaining == 0) {
+                return 0;
+            }
+            if (m_transport.Wait(false, remaining) < 0) {
+                return -1;
+            }
+        }
+    }
+    
+    // Shared memory has no error path of its own if NinjaTrader dies, so
+    // check the connection whenever the rings stay quiet for a while
+    for (;;) {
+        int remaining = RemainingMs();
+        int slice = remaining < LIVENESS_CHECK_MS ? remaining : LIVENESS_CHECK_MS;
+        int received = m_shm.Recv(buffer, length, false, slice);
+        if (received != 0) {
+            return received;
+        }
+        if (!m_transport.Alive()) {
+            return -1;
+        }
+        if (remaining == slice) {
+            return 0;
+        }
+    }
+}
+
+template <typename Transport>
+typename BasicBridgeChannel<Transport>::ReceiveStatus
+BasicBridgeChannel<Transport>::ReceiveReply(std::string_view& reply)
+{
+    uint32_t tag;
+    return m_framed ? ReceiveFrame(reply, tag) : ReceiveLine(reply);
+}
+
+// A timeout leaves any partial reply in the buffer; the next call picks up
+// where this one stopped, so the stream stays in step.
+template <typename Transport>
+typename BasicBridgeChannel<Transport>::ReceiveStatus
+BasicBridgeChannel<Transport>::ReceiveLine(std::string_view& line)
+{
+    // Read until a complete newline-terminated reply is buffered.
+    // Historical data can be VERY large (10,000 bars = ~600KB) and arrive
+    // in many TCP segments - keep reading instead of guessing from sizes.
+    while (!m_recvBuffer.NextLine(line)) {
+        if (m_recvBuffer.WriteSpace() == 0) {
+            m_recvBuffer.Reserve(RecvBuffer::DEFAULT_CAPACITY);
+        }
+        
+        int received = Receive(m_recvBuffer.WritePtr(), (int)m_recvBuffer.WriteSpace());
+        if (received == 0) {
+            line = TIMEOUT_REPLY;
+            return ReceiveStatus::Timeout;
+        }
+        if (received < 0) {
+            m_recvBuffer.Clear();
+            m_connected = false;
+            m_abandoned = 0;
+            line = "ERROR:Receive failed";
+            return ReceiveStatus::Failed;
+        }
+        
+        m_recvBuffer.Commit(received);
+    }
+    
+    return ReceiveStatus::Ok;
+}
+
+template <typename Transport>
+typename BasicBridgeChannel<Transport>::ReceiveStatus
+BasicBridgeChannel<Transport>::ReceiveFrame(std::string_view& frame, uint32_t& tag)
+{
+    // Frame = 4-byte little-endian length (+ 4-byte tag) + payload. Once the
+    // header is in, the exact payload size is known: reserve it and fetch
+    // the remainder with sized reads instead of scanning for a terminator.
+    size_t headerSize = m_tagged ? RecvBuffer::TAGGED_HEADER_SIZE : RecvBuffer::FRAME_HEADER_SIZE;
+    size_t missing = 0;
+    while (m_tagged ? !m_recvBuffer.NextTaggedFrame(frame, tag, missing)
+                    : !m_recvBuffer.NextFrame(frame, missing)) {
+        bool payload = false;
+        if (m_recvBuffer.Pending() >= headerSize) {
+            // A length no reply can have means the stream is out of step
+            // (or not a bridge) - don't try to allocate it
+            if (m_recvBuffer.FrameLength() > RecvBuffer::MAX_FRAME_SIZE) {
+                m_recvBuffer.Clear();
+                m_connected = false;
+                m_abandoned = 0;
+                frame = "ERROR:Frame too large";
+                return ReceiveStatus::Failed;
+            }
+            m_recvBuffer.Reserve(missing);
+            payload = true;
+        } else if (m_recvBuffer.WriteSpace() < missing) {
+            m_recvBuffer.Reserve(RecvBuffer::DEFAULT_CAPACITY);
+        }
+        
+        // Header phase: take whatever is available (small replies usually
+        // arrive whole). Payload phase: read no further than this frame.
+        int toRead = (int)(payload ? missing : m_recvBuffer.WriteSpace());
+        int received = Receive(m_recvBuffer.WritePtr(), toRead);
+        if (received == 0) {
+            frame = TIMEOUT_REPLY;
+            return ReceiveStatus::Timeout;
+        }
+        if (received < 0) {
+            m_recvBuffer.Clear();
+            m_connected = false;
+            m_abandoned = 0;
+            frame = "ERROR:Receive failed";
+            return ReceiveStatus::Failed;
+        }
+        
+        m_recvBuffer.Commit(received);
+    }
+    
+    return ReceiveStatus::Ok;
+}
+
+//=============================================================================
+// Instantiations
+//=============================================================================
+
+template class BasicBridgeChannel<DefaultTransport>;
+template class BasicBridgeChannel<LoopbackTransport>;
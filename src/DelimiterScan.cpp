@@ -0,0 +1,205 @@
+// DelimiterScan.cpp - Vectorized delimiter search for bulk text replies
+// Copyright (c) 2025
+
+#include "DelimiterScan.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DELIMITERSCAN_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang only emit SSE2/AVX2 instructions in functions marked for them;
+// MSVC accepts the intrinsics anywhere
+#if defined(DELIMITERSCAN_X86) && defined(__GNUC__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+using ScanFunction = size_t (*)(const char* data, size_t size, size_t from, char first, char second,
+                                uint32_t* positions, size_t capacity, size_t& next);
+
+//=============================================================================
+// Scalar
+//=============================================================================
+
+// Also finishes the last partial block of the vector versions
+static size_t ScanScalarFrom(const char* data, size_t size, size_t from, char first, char second,
+                             uint32_t* positions, size_t count, size_t capacity, size_t& next)
+{
+    size_t i = from;
+    for (; i < size; i++) {
+        char c = data[i];
+        if (c == first || c == second) {
+            if (count == capacity) {
+                break;
+            }
+            positions[count++] = (uint32_t)i;
+        }
+    }
+    next = i;
+    return count;
+}
+
+static size_t ScanScalar(const char* data, size_t size, size_t from, char first, char second,
+                         uint32_t* positions, size_t capacity, size_t& next)
+{
+    return ScanScalarFrom(data, size, from, first, second, positions, 0, capacity, next);
+}
+
+#ifdef DELIMITERSCAN_X86
+
+static inline unsigned CountTrailingZeros(uint32_t mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// Append the offset of every set bit of 'mask' (bit n = byte base + n)
+static inline size_t EmitMask(uint32_t mask, size_t base, uint32_t* positions, size_t count)
+{
+    while (mask) {
+        positions[count++] = (uint32_t)(base + CountTrailingZeros(mask));
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+//=============================================================================
+// SSE2 - 16 bytes per step
+//=============================================================================
+
+TARGET_SSE2
+static size_t ScanSse2(const char* data, size_t size, size_t from, char first, char second,
+                       uint32_t* positions, size_t capacity, size_t& next)
+{
+    const __m128i a = _mm_set1_epi8(first);
+    const __m128i b = _mm_set1_epi8(second);
+
+    size_t count = 0;
+    size_t i = from;
+    while (i + 16 <= size && count + 16 <= capacity) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, a), _mm_cmpeq_epi8(block, b));
+        count = EmitMask((uint32_t)_mm_movemask_epi8(hits), i, positions, count);
+        i += 16;
+    }
+    if (i + 16 <= size) {
+        next = i;   // Positions full - resume here
+        return count;
+    }
+    return ScanScalarFrom(data, size, i, first, second, positions, count, capacity, next);
+}
+
+//=============================================================================
+// AVX2 - 32 bytes per step
+//=============================================================================
+
+TARGET_AVX2
+static size_t ScanAvx2(const char* data, size_t size, size_t from, char first, char second,
+                       uint32_t* positions, size_t capacity, size_t& next)
+{
+    const __m256i a = _mm256_set1_epi8(first);
+    const __m256i b = _mm256_set1_epi8(second);
+
+    size_t count = 0;
+    size_t i = from;
+    while (i + 32 <= size && count + 32 <= capacity) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, a), _mm256_cmpeq_epi8(block, b));
+        count = EmitMask((uint32_t)_mm256_movemask_epi8(hits), i, positions, count);
+        i += 32;
+    }
+    if (i + 32 <= size) {
+        next = i;
+        return count;
+    }
+    // Less than one AVX2 block left: up to one SSE2 block, then scalar
+    return count + ScanSse2(data, size, i, first, second, positions + count, capacity - count, next);
+}
+
+//=============================================================================
+// CPU detection
+//=============================================================================
+
+static bool CpuHasAvx2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osSavesAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+    if (!osSavesAvx) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");   // Includes the OS (XSAVE) check
+#endif
+}
+
+static bool CpuHasSse2()
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(_MSC_VER)
+    return true;    // Part of x86-64; MSVC builds for x86 require it
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif // DELIMITERSCAN_X86
+
+//=============================================================================
+// Dispatch
+//=============================================================================
+
+struct ScanImplementation {
+    ScanFunction scan;
+    const char* name;
+};
+
+static ScanImplementation SelectImplementation()
+{
+#ifdef DELIMITERSCAN_X86
+    if (CpuHasAvx2()) return { ScanAvx2, "AVX2" };
+    if (CpuHasSse2()) return { ScanSse2, "SSE2" };
+#endif
+    return { ScanScalar, "scalar" };
+}
+
+static const ScanImplementation& Implementation()
+{
+    static const ScanImplementation selected = SelectImplementation();
+    return selected;
+}
+
+size_t ScanDelimiters(std::string_view text, size_t from, char first, char second,
+                      uint32_t* positions, size_t capacity, size_t& next)
+{
+    if (from >= text.size()) {
+        next = text.size();
+        return 0;
+    }
+    return Implementation().scan(text.data(), text.size(), from, first, second, positions, capacity, next);
+}
+
+const char* DelimiterScanLevel()
+{
+    return Implementation().name;
+}
@@ -0,0 +1,135 @@
+// DepthBook.cpp - Level-2 order book of one asset
+// Copyright (c) 2025
+
+#include "DepthBook.h"
+
+//=============================================================================
+// Constructor
+//=============================================================================
+
+DepthBook::DepthBook()
+    : m_seq(0)
+    , m_time(0)
+{
+    for (Ladder& ladder : m_sides) {
+        for (int i = 0; i < MAX_LEVELS; i++) {
+            ladder.price[i].store(0, std::memory_order_relaxed);
+            ladder.volume[i].store(0, std::memory_order_relaxed);
+        }
+        ladder.count.store(0, std::memory_order_relaxed);
+    }
+}
+
+//=============================================================================
+// Writer
+//=============================================================================
+
+// Copy row 'from' to row 'to'
+void DepthBook::Move(Ladder& ladder, int to, int from)
+{
+    ladder.price[to].store(ladder.price[from].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    ladder.volume[to].store(ladder.volume[from].load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+bool DepthBook::Apply(BookSide side, DepthOperation operation, int position,
+                      float price, float volume, DATE time)
+{
+    Ladder& ladder = m_sides[side == BookSide::Bid ? 1 : 0];
+    int count = ladder.count.load(std::memory_order_relaxed);
+    if (position < 0 || position >= MAX_LEVELS ||
+        (operation == DepthOperation::Add ? position > count : position >= count)) {
+        return false;
+    }
+
+    // Seqlock write: odd while rows are inconsistent
+    uint32_t seq = m_seq.load(std::memory_order_relaxed);
+    m_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    switch (operation) {
+        case DepthOperation::Add:
+            // Shift the rows behind down; a full ladder drops its last row
+            if (count == MAX_LEVELS) {
+                count--;
+            }
+            for (int i = count; i > position; i--) {
+                Move(ladder, i, i - 1);
+            }
+            count++;
+            break;
+
+        case DepthOperation::Update:
+            break;
+
+        case DepthOperation::Remove:
+            count--;
+            for (int i = position; i < count; i++) {
+                Move(ladder, i, i + 1);
+            }
+            break;
+    }
+
+    if (operation != DepthOperation::Remove) {
+        ladder.price[position].store(price, std::memory_order_relaxed);
+        ladder.volume[position].store(volume, std::memory_order_relaxed);
+    }
+    ladder.count.store(count, std::memory_order_relaxed);
+    m_time.store(time, std::memory_order_relaxed);
+
+    m_seq.store(seq + 2, std::memory_order_release);
+    return true;
+}
+
+void DepthBook::Clear()
+{
+    uint32_t seq = m_seq.load(std::memory_order_relaxed);
+    m_seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_sides[0].count.store(0, std::memory_order_relaxed);
+    m_sides[1].count.store(0, std::memory_order_relaxed);
+
+    m_seq.store(seq + 2, std::memory_order_release);
+}
+
+//=============================================================================
+// Reader
+//=============================================================================
+
+int DepthBook::CopySide(const Ladder& ladder, float sign, int levels, DATE time, T2* quotes, int space)
+{
+    int count = ladder.count.load(std::memory_order_relaxed);
+    if (count > levels) count = levels;
+    if (count > space) count = space;
+
+    for (int i = 0; i < count; i++) {
+        quotes[i].time = time;
+        quotes[i].fVal = sign * ladder.price[i].load(std::memory_order_relaxed);
+        quotes[i].fVol = ladder.volume[i].load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+int DepthBook::Top(int levels, T2* quotes, int maxQuotes) const
+{
+    if (!quotes || levels <= 0 || maxQuotes <= 0) {
+        return 0;
+    }
+
+    // Seqlock read: copy straight into the caller's array, retry if the
+    // writer was active or finished meanwhile
+    uint32_t before, after;
+    int written;
+    do {
+        before = m_seq.load(std::memory_order_acquire);
+        DATE time = m_time.load(std::memory_order_relaxed);
+
+        written = CopySide(m_sides[0], 1.0f, levels, time, quotes, maxQuotes);
+        written += CopySide(m_sides[1], -1.0f, levels, time, quotes + written, maxQuotes - written);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = m_seq.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    return written;
+}
@@ -0,0 +1,92 @@
+// DepthGenerator.cpp - Stand-in source of DEPTH push lines
+// Copyright (c) 2025
+
+#include "DepthGenerator.h"
+#include <cmath>
+
+//=============================================================================
+// Constructor
+//=============================================================================
+
+DepthGenerator::DepthGenerator(std::string instrument, double mid, double tickSize, int levels, uint32_t seed)
+    : m_instrument(std::move(instrument))
+    , m_tickSize(tickSize)
+    , m_levels(levels < 1 ? 1 : (levels >= DepthBook::MAX_LEVELS ? DepthBook::MAX_LEVELS - 1 : levels))
+    , m_random(seed ? seed : 1)
+    , m_built(0)
+    , m_pendingCount(0)
+    , m_pendingNext(0)
+{
+    // Best levels one tick either side of the mid, on the tick grid
+    double base = std::floor(mid / tickSize) * tickSize;
+    m_bestBid = base;
+    m_bestAsk = base + tickSize;
+}
+
+//=============================================================================
+// Operations
+//=============================================================================
+
+// xorshift32 - deterministic per seed
+uint32_t DepthGenerator::Random()
+{
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return m_random;
+}
+
+// Queue the four row operations of a one-tick move of the mid price.
+// Both ladders keep m_levels contiguous rows.
+void DepthGenerator::Move(bool up)
+{
+    double tick = m_tickSize;
+    double depth = m_levels * tick;
+    if (up) {
+        m_pending[0] = { BookSide::Ask, DepthOperation::Remove, 0, m_bestAsk, 0 };
+        m_pending[1] = { BookSide::Ask, DepthOperation::Add, m_levels - 1, m_bestAsk + depth, RandomVolume() };
+        m_pending[2] = { BookSide::Bid, DepthOperation::Add, 0, m_bestBid + tick, RandomVolume() };
+        m_pending[3] = { BookSide::Bid, DepthOperation::Remove, m_levels, m_bestBid - depth + tick, 0 };
+        m_bestAsk += tick;
+        m_bestBid += tick;
+    } else {
+        m_pending[0] = { BookSide::Bid, DepthOperation::Remove, 0, m_bestBid, 0 };
+        m_pending[1] = { BookSide::Bid, DepthOperation::Add, m_levels - 1, m_bestBid - depth, RandomVolume() };
+        m_pending[2] = { BookSide::Ask, DepthOperation::Add, 0, m_bestAsk - tick, RandomVolume() };
+        m_pending[3] = { BookSide::Ask, DepthOperation::Remove, m_levels, m_bestAsk + depth - tick, 0 };
+        m_bestAsk -= tick;
+        m_bestBid -= tick;
+    }
+    m_pendingCount = 4;
+    m_pendingNext = 0;
+}
+
+std::string_view DepthGenerator::Next(DATE time)
+{
+    Operation op;
+    if (m_built < 2 * m_levels) {
+        // Build the book: ask and bid rows alternately, best first
+        int row = m_built / 2;
+        op = (m_built % 2 == 0)
+            ? Operation{ BookSide::Ask, DepthOperation::Add, row, m_bestAsk + row * m_tickSize, RandomVolume() }
+            : Operation{ BookSide::Bid, DepthOperation::Add, row, m_bestBid - row * m_tickSize, RandomVolume() };
+        m_built++;
+    } else {
+        if (m_pendingNext == m_pendingCount && (int)(Random() % 100) < MOVE_PERCENT) {
+            Move(Random() % 2 == 0);
+        }
+        if (m_pendingNext < m_pendingCount) {
+            op = m_pending[m_pendingNext++];
+        } else {
+            // Volume change of an existing row
+            BookSide side = (Random() % 2 == 0) ? BookSide::Ask : BookSide::Bid;
+            int row = (int)(Random() % (uint32_t)m_levels);
+            double price = (side == BookSide::Ask) ? m_bestAsk + row * m_tickSize : m_bestBid - row * m_tickSize;
+            op = { side, DepthOperation::Update, row, price, RandomVolume() };
+        }
+    }
+
+    m_line.Begin("DEPTH").Arg(m_instrument).Arg((int)op.side).Arg((int)op.operation)
+          .Arg(op.position).Arg(op.price).Arg(op.volume).Arg(time);
+    return m_line.View();
+}
@@ -0,0 +1,195 @@
+// HistoryDecoder.cpp - Parallel decoding of large text HISTORY replies
+// Copyright (c) 2025
+
+#include "HistoryDecoder.h"
+#include "DelimiterScan.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+// Bars in a run of whole bars: one more than its '|' separators
+static size_t CountBars(std::string_view bars)
+{
+    if (bars.empty()) {
+        return 0;
+    }
+
+    uint32_t positions[1024];
+    size_t count = 1;
+    size_t next = 0;
+    while (next < bars.size()) {
+        count += ScanDelimiters(bars, next, '|', '|', positions, 1024, next);
+    }
+    return count;
+}
+
+//=============================================================================
+// Constructor / Destructor
+//=============================================================================
+
+HistoryDecoder::HistoryDecoder(int workers)
+    : m_workerCount(workers)
+    , m_generation(0)
+    , m_pending(0)
+    , m_stopping(false)
+    , m_poolTried(false)
+    , m_tStart(0)
+    , m_tEnd(0)
+    , m_nTicks(0)
+{
+}
+
+HistoryDecoder::~HistoryDecoder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_start.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+//=============================================================================
+// Decoding
+//=============================================================================
+
+bool HistoryDecoder::Decode(std::string_view response, DATE tStart, DATE tEnd,
+                            T6* ticks, int nTicks, HistoryResult& result)
+{
+    result = HistoryResult();
+
+    std::string_view bars;
+    if (!TextCodec::DecodeHistoryHeader(response, result.barCount, bars)) {
+        return false;
+    }
+
+    if (bars.size() < PARALLEL_THRESHOLD || nTicks <= 0 || !StartWorkers()) {
+        TextCodec::DecodeHistoryBars(bars, tStart, tEnd, ticks, nTicks, result);
+        return true;
+    }
+
+    size_t count = m_workers.size() + 1;
+    Split(bars, count);
+    m_tStart = tStart;
+    m_tEnd = tEnd;
+    m_nTicks = nTicks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = (unsigned)(count - 1);
+        m_generation++;
+    }
+    m_start.notify_all();
+
+    // First chunk: straight into the caller's buffer, meanwhile the workers
+    // decode the rest
+    Chunk& first = m_chunks[0];
+    TextCodec::DecodeHistoryBars(first.bars, tStart, tEnd, ticks, nTicks, first.result);
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_pending == 0; });
+    }
+
+    result.loaded = first.result.loaded;
+    result.skipped = first.result.skipped;
+    result.endReached = first.result.endReached;
+
+    // Append the other chunks in order, each behind the bars loaded so far
+    for (size_t i = 1; i < count && !result.endReached && result.loaded < nTicks; i++) {
+        Chunk& chunk = m_chunks[i];
+        HistoryResult part;
+
+        if (chunk.decoded && result.loaded + chunk.result.loaded < nTicks) {
+            memcpy(ticks + result.loaded, chunk.scratch.get(), chunk.result.loaded * sizeof(T6));
+            part = chunk.result;
+        } else {
+            // The buffer fills up inside this chunk (or it had no scratch
+            // buffer): decode it again in place, so that loaded and skipped
+            // stop exactly where the serial decoder's would
+            TextCodec::DecodeHistoryBars(chunk.bars, tStart, tEnd, ticks + result.loaded,
+                                         nTicks - result.loaded, part);
+        }
+
+        result.loaded += part.loaded;
+        result.skipped += part.skipped;
+        result.endReached = part.endReached;
+    }
+
+    return true;
+}
+
+// Cut the bar list into 'count' runs of whole bars of about equal size
+void HistoryDecoder::Split(std::string_view bars, size_t count)
+{
+    size_t start = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t end = bars.size();
+        if (i + 1 < count) {
+            size_t target = std::max(start, bars.size() / count * (i + 1));
+            end = std::min(bars.find('|', target), bars.size());
+        }
+
+        m_chunks[i].bars = bars.substr(start, end - start);
+        start = std::min(end + 1, bars.size());
+    }
+}
+
+void HistoryDecoder::DecodeChunk(Chunk& chunk)
+{
+    size_t needed = std::min(CountBars(chunk.bars), (size_t)m_nTicks);
+    if (needed > chunk.capacity) {
+        chunk.scratch.reset(new (std::nothrow) T6[needed]);
+        chunk.capacity = chunk.scratch ? needed : 0;
+    }
+
+    chunk.result = HistoryResult();
+    chunk.decoded = (chunk.capacity >= needed);
+    if (chunk.decoded) {
+        TextCodec::DecodeHistoryBars(chunk.bars, m_tStart, m_tEnd, chunk.scratch.get(), (int)needed, chunk.result);
+    }
+}
+
+//=============================================================================
+// Worker pool
+//=============================================================================
+
+bool HistoryDecoder::StartWorkers()
+{
+    if (!m_poolTried) {
+        m_poolTried = true;
+
+        unsigned cores = std::thread::hardware_concurrency();
+        unsigned count = cores > 1 ? std::min(cores - 1, MAX_WORKERS) : 0;
+        if (m_workerCount >= 0) {
+            count = std::min((unsigned)m_workerCount, MAX_WORKERS);
+        }
+        for (unsigned i = 0; i < count; i++) {
+            m_workers.emplace_back(&HistoryDecoder::WorkerLoop, this, i + 1);
+        }
+    }
+    return !m_workers.empty();
+}
+
+void HistoryDecoder::WorkerLoop(unsigned chunk)
+{
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping) {
+                return;
+            }
+            seen = m_generation;
+        }
+
+        DecodeChunk(m_chunks[chunk]);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pending == 0) {
+            m_done.notify_one();
+        }
+    }
+}
@@ -5,6 +5,11 @@
 // Supports: Market data, order placement, position tracking, account info
 
 #include "NT8Plugin.h"
+#include "CommandWriter.h"
+#include "DelimiterScan.h"
+#include "HistoryDecoder.h"
+#include "NumberParser.h"
+#include "TickRecorder.h"
 #include <cstdio>
 #include <cstdarg>
 #include <cstring>
@@ -12,14 +17,14 @@
 #include <map>
 #include <vector>
 #include <algorithm>  // For std::sort
-#include <sstream>
-#include <iomanip>
 
 //=============================================================================
 // Global State
 //=============================================================================
 
 std::unique_ptr<TcpBridge> g_bridge;  // TCP communication bridge
+static std::unique_ptr<HistoryDecoder> g_historyDecoder;  // Text history decoding (worker pool)
+static std::unique_ptr<TickRecorder> g_tickRecorder;      // Quote recording (SET_RECORDTICKS)
 int (__cdecl *BrokerMessage)(const char* text) = nullptr;
 int (__cdecl *BrokerProgress)(const int progress) = nullptr;
 
@@ -106,12 +111,278 @@ static int responsiveSleep(int ms)
     return 1;  // Continue
 }
 
+// Cached quote for an asset if it is younger than the quote TTL
+static bool FindFreshQuote(const char* symbol, Quote& quote)
+{
+    auto it = g_state.quotes.find(symbol);
+    if (it == g_state.quotes.end()) {
+        return false;
+    }
+    
+    auto age = std::chrono::steady_clock::now() - it->second.fetched;
+    if (age >= std::chrono::milliseconds(g_state.quoteTtlMs)) {
+        return false;
+    }
+    
+    quote = it->second.quote;
+    return true;
+}
+
+// Current UTC time as DATE, millisecond resolution
+static DATE CurrentDate()
+{
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return (double)ms / (24.0 * 60.0 * 60.0 * 1000.0) + 25569.0;
+}
+
+// Every quote the plugin receives goes to the tick recorder, if recording.
+// Only pushed quotes also feed the local bars: they are every update, while
+// polled quotes are samples that miss the highs and lows between polls.
+static void ObserveQuote(std::string_view symbol, const Quote& quote, bool pushed)
+{
+    DATE time = quote.time > 0 ? quote.time : CurrentDate();
+    if (pushed) {
+        g_state.bars.Update(symbol, time, quote.last > 0 ? quote.last : quote.ask, quote.volume);
+    }
+    
+    if (g_tickRecorder && g_tickRecorder->IsRunning()) {
+        g_tickRecorder->Record(symbol, time, quote.bid, quote.ask);
+    }
+}
+
+// Take the quotes the push channel queued since the last call. Where
+// updates were lost (queue overflow, channel restart) the bars restart.
+static void DrainPushedQuotes()
+{
+    PushedQuote update;
+    while (g_bridge->NextPushedQuote(update)) {
+        if (update.instrument[0] == '\0') {
+            g_state.bars.Clear();
+            continue;
+        }
+        ObserveQuote(update.instrument, update.quote, true);
+    }
+}
+
+static void CacheQuote(const char* symbol, const Quote& quote)
+{
+    CachedQuote& entry = g_state.quotes[symbol];
+    entry.quote = quote;
+    entry.fetched = std::chrono::steady_clock::now();
+    entry.sweep = 0;
+}
+
+// Quote snapshot for an asset: the streamed quote if there is one, else a
+// cached quote younger than the TTL, else one GETPRICE ('refresh' skips
+// the cache). All four fields come from the same reply.
+static bool GetQuoteSnapshot(const char* symbol, Quote& quote, bool refresh = false)
+{
+    if (!refresh && !g_bridge->IsStreaming() && FindFreshQuote(symbol, quote)) {
+        return true;
+    }
+    
+    // A pushed quote was observed from the queue already
+    DrainPushedQuotes();
+    if (g_bridge->StreamedQuote(symbol, quote)) {
+        CacheQuote(symbol, quote);
+        return true;
+    }
+    
+    if (!g_bridge->GetQuote(symbol, quote)) {
+        return false;
+    }
+    
+    ObserveQuote(symbol, quote, false);
+    CacheQuote(symbol, quote);
+    return true;
+}
+
+// Fetch the quotes of every subscribed asset with one GETPRICES and start a
+// new sweep. Assets missing from the reply keep their previous cache entry.
+static bool PrefetchPrices()
+{
+    std::vector<std::string> symbols;
+    symbols.reserve(g_state.subscriptions.Size());
+    for (const Subscription& subscription : g_state.subscriptions.Entries()) {
+        symbols.push_back(subscription.symbol);
+    }
+    
+    Tokenizer entries(std::string_view(), '|');
+    if (!g_bridge->Quotes(symbols.data(), symbols.size(), entries)) {
+        // Older AddOn - one GETPRICE per asset from now on. After a timeout
+        // the rest of the cycle polls; the next cycle sweeps again.
+        if (TcpBridge::IsUnknownCommand(entries.Rest())) {
+            g_state.bulkPrices = false;
+            LogInfo("# Bulk prices not available, requesting assets one by one");
+        } else {
+            g_state.pricesRetry = std::chrono::steady_clock::now() +
+                                  std::chrono::milliseconds(g_state.quoteTtlMs);
+        }
+        return false;
+    }
+    
+    g_state.priceSweep++;
+    auto now = std::chrono::steady_clock::now();
+    std::string_view instrument;
+    Quote quote;
+    int count = 0;
+    while (TcpBridge::NextQuote(entries, instrument, quote)) {
+        ObserveQuote(instrument, quote, false);
+        CachedQuote& entry = g_state.quotes[std::string(instrument)];
+        entry.quote = quote;
+        entry.fetched = now;
+        entry.sweep = g_state.priceSweep;
+        entry.served = false;
+        count++;
+    }
+    
+    LogDebug("# Price sweep: %d of %zu assets", count, symbols.size());
+    return true;
+}
+
+// Quote for BrokerAsset from the current sweep. The first asset of a cycle
+// - its sweep quote is missing, older than the quote TTL or already served -
+// starts a new sweep. Returns false when the caller should use GETPRICE.
+static bool TakeSweepQuote(const char* symbol, Quote& quote)
+{
+    if (!g_state.bulkPrices || g_state.quoteTtlMs <= 0 || g_bridge->IsStreaming()) {
+        return false;   // Streamed quotes are local already
+    }
+    
+    auto findUnserved = [symbol]() -> CachedQuote* {
+        auto it = g_state.quotes.find(symbol);
+        if (it == g_state.quotes.end()) {
+            return nullptr;
+        }
+        CachedQuote& entry = it->second;
+        auto age = std::chrono::steady_clock::now() - entry.fetched;
+        bool current = entry.sweep != 0 && entry.sweep == g_state.priceSweep && !entry.served &&
+                       age < std::chrono::milliseconds(g_state.quoteTtlMs);
+        return current ? &entry : nullptr;
+    };
+    
+    CachedQuote* entry = findUnserved();
+    if (!entry) {
+        if (std::chrono::steady_clock::now() < g_state.pricesRetry ||
+            !PrefetchPrices() || !(entry = findUnserved())) {
+            return false;
+        }
+    }
+    
+    entry->served = true;
+    quote = entry->quote;
+    return true;
+}
+
+// UNSUBSCRIBE the assets the subscription registry evicted to stay within
+// SET_MAXASSETS, and forget their cached and streamed quotes
+static void ReleaseEvicted(const std::vector<std::string>& evicted)
+{
+    for (const std::string& symbol : evicted) {
+        g_bridge->UnSubscribeMarketData(symbol.c_str());
+        g_bridge->UnwatchQuotes(symbol.c_str());
+        g_state.quotes.erase(symbol);
+        LogInfo("# Unsubscribed %s (asset limit %d)", symbol.c_str(), (int)g_state.subscriptions.Capacity());
+    }
+}
+
+// Account snapshot: one GETACCOUNT fills every value, and the snapshot is
+// reused for accountTtlMs. A fill changes cash and P&L, so the cache is
+// dropped by InvalidateAccounts() whenever the plugin observes one.
+static bool GetAccountSnapshot(const char* account, AccountRecord& values)
+{
+    auto now = std::chrono::steady_clock::now();
+    auto it = g_state.accounts.find(account);
+    if (it != g_state.accounts.end() &&
+        now - it->second.fetched < std::chrono::milliseconds(g_state.accountTtlMs)) {
+        values = it->second.values;
+        return true;
+    }
+    
+    if (!g_bridge->GetAccount(account, values)) {
+        return false;
+    }
+    
+    CachedAccount& entry = g_state.accounts[account];
+    entry.values = values;
+    entry.fetched = now;
+    return true;
+}
+
+static void InvalidateAccounts()
+{
+    g_state.accounts.clear();
+}
+
+// Reload the position book with one GETPOSITIONS (every non-flat position)
+static bool RefreshPositions()
+{
+    Tokenizer entries(std::string_view(), '|');
+    if (!g_bridge->Positions(entries)) {
+        // Older AddOn - query symbols one by one from now on. After a
+        // timeout the book stays as it is until the next cycle retries.
+        if (TcpBridge::IsUnknownCommand(entries.Rest())) {
+            g_state.bulkPositions = false;
+            LogInfo("# Bulk positions not available, querying symbols one by one");
+        } else {
+            g_state.positionsRetry = std::chrono::steady_clock::now() +
+                                     std::chrono::milliseconds(g_state.positionTtlMs);
+        }
+        return false;
+    }
+    
+    g_state.positions.clear();
+    
+    std::string_view instrument;
+    PositionRecord position;
+    while (TcpBridge::NextPosition(entries, instrument, position)) {
+        g_state.positions[std::string(instrument)] = position;
+    }
+    
+    g_state.positionsFetched = std::chrono::steady_clock::now();
+    LogDebug("# Position book refreshed: %zu positions", g_state.positions.size());
+    return true;
+}
+
+// Reload the book if it is older than the TTL ('force': in any case),
+// unless a reload timed out within the TTL
+static void RefreshPositionsIfStale(bool force = false)
+{
+    auto now = std::chrono::steady_clock::now();
+    bool stale = force || now - g_state.positionsFetched >= std::chrono::milliseconds(g_state.positionTtlMs);
+    if (g_state.bulkPositions && stale && now >= g_state.positionsRetry) {
+        RefreshPositions();
+    }
+}
+
+// Position of a symbol as NinjaTrader reports it: from the position book
+// ('refresh' reloads it first), or with one GETPOSITION if the AddOn has
+// no GETPOSITIONS
+static PositionRecord CurrentPosition(const char* symbol, bool refresh)
+{
+    RefreshPositionsIfStale(refresh);
+    
+    PositionRecord position;
+    if (!g_state.bulkPositions) {
+        g_bridge->GetPosition(symbol, position);
+        return position;
+    }
+    
+    auto it = g_state.positions.find(symbol);
+    return (it != g_state.positions.end()) ? it->second : position;
+}
+
 // Poll for position update after order fill
 // Retries up to maxAttempts times with delayMs between attempts
 // Returns actual position or 0 if timeout/error
 static int pollForPosition(const char* symbol, const char* account, int expectedChange, int maxAttempts, int delayMs)
 {
-    int previousPos = g_bridge->MarketPosition(symbol, account);
+    // Position the caller just booked for the fill - NinjaTrader may lag
+    // behind it. Missing from the book means flat.
+    auto booked = g_state.positions.find(symbol);
+    int bookedPos = (booked != g_state.positions.end()) ? booked->second.quantity : 0;
+    int previousPos = CurrentPosition(symbol, true).quantity;
     
     for (int attempt = 0; attempt < maxAttempts; attempt++) {
         if (!responsiveSleep(delayMs)) {
@@ -119,7 +390,7 @@ static int pollForPosition(const char* symbol, const char* account, int expected
             break;
         }
         
-        int currentPos = g_bridge->MarketPosition(symbol, account);
+        int currentPos = CurrentPosition(symbol, true).quantity;
         
         // Check if position changed in expected direction
         if (expectedChange > 0 && currentPos > previousPos) {
@@ -138,7 +409,21 @@ static int pollForPosition(const char* symbol, const char* account, int expected
     }
     
     // Timeout - return last known position
-    int finalPos = g_bridge->MarketPosition(symbol, account);
+    int finalPos = CurrentPosition(symbol, true).quantity;
+    
+    // Never let a lagging reload replace the booked fill with a transient
+    // value; the book is trusted for another TTL period, and the caller
+    // gets the same position the book holds
+    if (g_state.bulkPositions && finalPos != bookedPos) {
+        if (bookedPos != 0) {
+            g_state.positions[symbol].quantity = bookedPos;
+        } else {
+            g_state.positions.erase(symbol);
+        }
+        g_state.positionsFetched = std::chrono::steady_clock::now();
+        finalPos = bookedPos;
+    }
+    
     LogInfo("# Position poll timeout after %d ms, returning: %d", maxAttempts * delayMs, finalPos);
     return finalPos;
 }
@@ -227,6 +512,95 @@ static void CleanupOldOrders()
     }
 }
 
+// An order in a final state: cancelled, rejected or completely filled
+static bool IsFinal(const OrderInfo& order)
+{
+    return order.status == "Cancelled" || order.status == "Rejected" ||
+           (order.status == "Filled" && order.filled >= order.quantity);
+}
+
+// Refresh the order status table with one GETORDERSTATUSES covering every
+// tracked order that can still change, plus 'orderId'. Requested orders the
+// AddOn doesn't know stay in the table with state "Unknown".
+static bool RefreshOrderStatus(const std::string& orderId)
+{
+    std::vector<std::string> orderIds;
+    for (const auto& pair : g_state.orders) {
+        const OrderInfo& order = pair.second;
+        if (!order.orderId.empty() && order.orderId != orderId && !IsFinal(order)) {
+            orderIds.push_back(order.orderId);
+        }
+    }
+    orderIds.push_back(orderId);
+    
+    Tokenizer entries(std::string_view(), '|');
+    if (!g_bridge->OrderStatuses(orderIds.data(), orderIds.size(), entries)) {
+        // Older AddOn - use single GETORDERSTATUS from now on. A timeout or
+        // other error only costs this cycle; the next one tries again.
+        g_state.orderStatus.clear();
+        if (TcpBridge::IsUnknownCommand(entries.Rest())) {
+            g_state.bulkOrderStatus = false;
+            LogInfo("# Bulk order status not available, querying orders one by one");
+        } else {
+            g_state.orderStatusRetry = std::chrono::steady_clock::now() +
+                                       std::chrono::milliseconds(g_state.orderStatusTtlMs);
+        }
+        return false;
+    }
+    
+    g_state.orderStatus.clear();
+    for (const std::string& id : orderIds) {
+        g_state.orderStatus[id] = OrderStatusRecord();
+    }
+    
+    std::string_view id;
+    OrderStatusRecord status;
+    int count = 0;
+    while (TcpBridge::NextOrderStatus(entries, id, status)) {
+        auto it = g_state.orderStatus.find(std::string(id));
+        if (it != g_state.orderStatus.end()) {
+            it->second = status;
+            count++;
+        }
+    }
+    
+    g_state.orderStatusFetched = std::chrono::steady_clock::now();
+    LogDebug("# Order status table refreshed: %d of %zu orders", count, orderIds.size());
+    return true;
+}
+
+// Current status of an order: from the table while it is fresh and lists
+// the order, else refreshed in bulk, else one GETORDERSTATUS. Returns false
+// if no reply was available; 'status' then stays "Unknown".
+static bool LookupOrderStatus(const OrderInfo& order, OrderStatusRecord& status)
+{
+    status = OrderStatusRecord();
+    if (order.orderId.empty()) {
+        return false;
+    }
+    
+    if (g_state.bulkOrderStatus) {
+        auto now = std::chrono::steady_clock::now();
+        auto it = g_state.orderStatus.find(order.orderId);
+        if (it == g_state.orderStatus.end() ||
+            now - g_state.orderStatusFetched >= std::chrono::milliseconds(g_state.orderStatusTtlMs)) {
+            // After a timed-out refresh the rest of the cycle gets no status
+            // - a single GETORDERSTATUS would only time out as well
+            if (now < g_state.orderStatusRetry ||
+                (!RefreshOrderStatus(order.orderId) && g_state.bulkOrderStatus)) {
+                return false;
+            }
+            it = g_state.orderStatus.find(order.orderId);
+        }
+        if (it != g_state.orderStatus.end()) {
+            status = it->second;
+            return true;
+        }
+    }
+    
+    return g_bridge->GetOrderStatus(order.orderId.c_str(), status);
+}
+
 //=============================================================================
 // BrokerOpen - Initialize plugin
 //=============================================================================
@@ -273,10 +647,22 @@ DLLFUNC int BrokerLogin(char* User, char* Pwd, char* Type, char* Accounts)
     // Logout request
     if (!User || !*User) {
         if (g_bridge) {
+            // Unsubscribe and stop the push channel here - DllMain must not
+            // do network I/O or join threads
+            if (g_bridge->IsConnected()) {
+                for (const Subscription& subscription : g_state.subscriptions.Entries()) {
+                    g_bridge->UnSubscribeMarketData(subscription.symbol.c_str());
+                }
+            }
             g_bridge->TearDown();
         }
+        g_state.subscriptions.Clear();
         g_state.connected = false;
         g_state.account.clear();
+        g_state.accounts.clear();
+        g_state.quotes.clear();
+        g_historyDecoder.reset();   // Join the decode workers here, not at DLL unload
+        g_tickRecorder.reset();     // Likewise the recorder thread; finalizes its files
         LogMessage("# NT8 disconnected");
         return 0;
     }
@@ -294,11 +680,11 @@ DLLFUNC int BrokerLogin(char* User, char* Pwd, char* Type, char* Accounts)
     }
     
     // Send login command
-    std::string loginCmd = std::string("LOGIN:") + User;
-    std::string response = g_bridge->SendCommand(loginCmd);
+    CommandWriter loginCmd;
+    std::string_view response = g_bridge->SendCommand(loginCmd.Begin("LOGIN").Arg(User).View());
     
-    if (response.find("ERROR") != std::string::npos) {
-        LogError("Login failed: %s", response.c_str());
+    if (response.find("ERROR") != std::string_view::npos) {
+        LogError("Login failed: %.*s", (int)response.size(), response.data());
         LogError("Check account name is correct in NinjaTrader");
         return 0;
     }
@@ -306,6 +692,13 @@ DLLFUNC int BrokerLogin(char* User, char* Pwd, char* Type, char* Accounts)
     // Store account name
     g_state.account = User;
     g_state.connected = true;
+    g_state.bulkOrderStatus = true;  // Re-check what this AddOn supports
+    g_state.orderStatus.clear();
+    g_state.bulkPositions = true;
+    g_state.positionsFetched = {};   // Load the position book on first use
+    g_state.bulkPrices = true;
+    g_state.subscriptions.Clear();   // The AddOn may have restarted - subscribe again on use
+    g_state.dataWaited = false;
     
     // Returned account name in Accounts parameter
     if (Accounts) {
@@ -345,6 +738,15 @@ DLLFUNC int BrokerTime(DATE* pTimeUTC)
         return 0;
     }
     
+    // Quotes are polled while the push channel is down; once it is back,
+    // let it fill the quote table for every subscribed asset again
+    if (g_bridge->ResumeStreaming()) {
+        for (const Subscription& subscription : g_state.subscriptions.Entries()) {
+            g_bridge->WatchQuotes(subscription.symbol.c_str());
+        }
+        LogInfo("# Quote stream restarted");
+    }
+    
     // NinjaTrader doesn't expose server time via ATI
     // Return current local time in UTC
     if (pTimeUTC) {
@@ -371,33 +773,50 @@ DLLFUNC int BrokerAsset(char* Asset, double* pPrice, double* pSpread,
     
     // Subscribe mode (pPrice == NULL) - just subscribe to data
     if (!pPrice) {
+        // Already subscribed - nothing to send
+        if (g_state.subscriptions.Use(Asset)) {
+            if (pLotAmount) *pLotAmount = 1.0;
+            return 1;
+        }
+        
         // Send SUBSCRIBE command and parse response
-        std::string cmd = std::string("SUBSCRIBE:") + Asset;
-        std::string response = g_bridge->SendCommand(cmd);
+        CommandWriter cmd;
+        std::string_view response = g_bridge->SendCommand(cmd.Begin("SUBSCRIBE").Arg(Asset).View());
         
-        if (response.find("OK") != std::string::npos) {
-            g_state.currentSymbol = Asset;
+        if (response.find("OK") != std::string_view::npos) {
+            // Let the push channel (if any) fill the quote table for this asset
+            if (g_bridge->IsStreaming() && !g_bridge->WatchQuotes(Asset)) {
+                LogInfo("# Quote table full - %s will be polled", Asset);
+            }
             
             // **NEW: Parse contract specs from SUBSCRIBE response**
             // Format: OK:Subscribed:{instrument}:{tickSize}:{pointValue}
-            auto parts = g_bridge->SplitResponse(response, ':');
+            Fields<5> parts(response, ':');
+            AssetSpec spec;
             
-            if (parts.size() >= 5 && parts[0] == "OK") {
-                try {
-                    double tickSize = std::stod(parts[3]);
-                    double pointValue = std::stod(parts[4]);
-                    
+            if (parts.Size() >= 5 && parts[0] == "OK") {
+                double tickSize = 0.0;
+                double pointValue = 0.0;
+                
+                if (ParseDouble(parts[3], tickSize) == ParseStatus::Ok &&
+                    ParseDouble(parts[4], pointValue) == ParseStatus::Ok) {
                     // Store contract specifications
-                    g_state.assetSpecs[Asset].tickSize = tickSize;
-                    g_state.assetSpecs[Asset].pointValue = pointValue;
+                    spec.tickSize = tickSize;
+                    spec.pointValue = pointValue;
                     
                     LogInfo("# Asset specs for %s: tick=%.4f value=%.2f", Asset, tickSize, pointValue);
                 }
-                catch (...) {
+                else {
                     LogInfo("# Could not parse asset specs for %s, using defaults", Asset);
                 }
             }
             
+            // Register the subscription; beyond SET_MAXASSETS the least
+            // recently used assets are unsubscribed
+            std::vector<std::string> evicted;
+            g_state.subscriptions.Add(Asset, spec, evicted);
+            ReleaseEvicted(evicted);
+            
             // **CRITICAL FIX: Zorro 2.70 checks pLotAmount even in subscribe mode!**
             if (pLotAmount) *pLotAmount = 1.0;
             
@@ -409,18 +828,42 @@ DLLFUNC int BrokerAsset(char* Asset, double* pPrice, double* pSpread,
         return 0;
     }
     
-    // Make sure we're subscribed
-    if (g_state.currentSymbol != Asset) {
+    // Make sure we're subscribed - switching between subscribed assets
+    // costs nothing
+    Subscription* subscription = g_state.subscriptions.Use(Asset);
+    if (!subscription) {
         // Need to subscribe first - call ourselves recursively
-        BrokerAsset(Asset, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
-        Sleep(100);  // Brief delay for data to arrive
+        if (!BrokerAsset(Asset, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL)) {
+            return 0;
+        }
+        subscription = g_state.subscriptions.Use(Asset);
+    }
+    
+    // Fresh snapshot: from this cycle's GETPRICES sweep, else streamed or
+    // one GETPRICE; cached for the order functions called later in the
+    // same cycle
+    Quote quote;
+    if (!TakeSweepQuote(Asset, quote)) {
+        GetQuoteSnapshot(Asset, quote, true);
+    }
+    
+    // Only the session's first subscription waits for data to arrive (up
+    // to 100 ms); a later new asset without a price yet reports none until
+    // Zorro's next poll instead of stalling the whole sweep
+    if (subscription->state == SubscriptionState::Subscribed && !g_state.dataWaited) {
+        g_state.dataWaited = true;
+        for (int waited = 0; quote.ask <= 0 && quote.last <= 0 && waited < 100; waited += 10) {
+            if (!responsiveSleep(10)) {
+                break;
+            }
+            GetQuoteSnapshot(Asset, quote, true);
+        }
+    }
+    if (quote.ask > 0 || quote.last > 0) {
+        subscription->state = SubscriptionState::Live;
     }
     
-    // Get market data
-    double bid = g_bridge->GetBid(Asset);
-    double ask = g_bridge->GetAsk(Asset);
-    double last = g_bridge->GetLast(Asset);
-    double volume = g_bridge->GetVolume(Asset);
+    double bid = quote.bid, ask = quote.ask, last = quote.last, volume = quote.volume;
     
     // Return price (use ask for consistency)
     *pPrice = ask > 0 ? ask : last;
@@ -436,11 +879,11 @@ DLLFUNC int BrokerAsset(char* Asset, double* pPrice, double* pSpread,
     }
     
     // **FIXED: Return actual contract specs from NT8**
+    const AssetSpec& spec = subscription->spec;
     if (pPip) {
-        auto it = g_state.assetSpecs.find(Asset);
-        if (it != g_state.assetSpecs.end() && it->second.tickSize > 0) {
-            *pPip = it->second.tickSize;
-            LogDebug("# Returning tick size for %s: %.4f", Asset, it->second.tickSize);
+        if (spec.tickSize > 0) {
+            *pPip = spec.tickSize;
+            LogDebug("# Returning tick size for %s: %.4f", Asset, spec.tickSize);
         } else {
             // **ZORRO 2.70 FIX: Must return non-zero default**
             // Default tick size for micro futures (MES, MNQ, etc.)
@@ -451,10 +894,9 @@ DLLFUNC int BrokerAsset(char* Asset, double* pPrice, double* pSpread,
     }
     
     if (pPipCost) {
-        auto it = g_state.assetSpecs.find(Asset);
-        if (it != g_state.assetSpecs.end() && it->second.pointValue > 0) {
-            *pPipCost = it->second.pointValue;
-            LogDebug("# Returning point value for %s: %.2f", Asset, it->second.pointValue);
+        if (spec.pointValue > 0) {
+            *pPipCost = spec.pointValue;
+            LogDebug("# Returning point value for %s: %.2f", Asset, spec.pointValue);
         } else {
             // **ZORRO 2.70 FIX: Must return non-zero default**
             // Default point value for MES ($1.25 per 0.25 tick)
@@ -487,11 +929,16 @@ DLLFUNC int BrokerAccount(char* Account, double* pBalance, double* pTradeVal,
     // Switch account if specified
     const char* acct = (Account && *Account) ? Account : g_state.account.c_str();
     
-    // Get account values (now includes unrealized P&L as 4th field)
-    double cashValue = g_bridge->CashValue(acct);
-    double buyingPower = g_bridge->BuyingPower(acct);
-    double realizedPnL = g_bridge->RealizedPnL(acct);
-    double unrealizedPnL = g_bridge->UnrealizedPnL(acct);  // NEW: Get unrealized P&L
+    // Get account values from a single GETACCOUNT snapshot
+    // (includes unrealized P&L as 4th field)
+    AccountRecord snapshot;
+    if (!GetAccountSnapshot(acct, snapshot)) {
+        return 0;
+    }
+    double cashValue = snapshot.cashValue;
+    double buyingPower = snapshot.buyingPower;
+    double realizedPnL = snapshot.realizedPnL;
+    double unrealizedPnL = snapshot.unrealizedPnL;
     
     if (pBalance) {
         *pBalance = cashValue;
@@ -542,10 +989,13 @@ DLLFUNC int BrokerBuy2(char* Asset, int Amount, double StopDist, double Limit,
     // BUY STOP: Enter long when price rises to stop (stop is ABOVE market)
     // SELL STOP: Enter short when price falls to stop (stop is BELOW market)
     if (StopDist > 0) {
-        // Get current market price for stop calculation
-        double currentPrice = g_bridge->GetLast(Asset);
+        // Get current market price for stop calculation (usually the
+        // quote BrokerAsset just cached)
+        Quote quote;
+        GetQuoteSnapshot(Asset, quote);
+        double currentPrice = quote.last;
         if (currentPrice <= 0) {
-            currentPrice = g_bridge->GetAsk(Asset);  // Fallback to ask
+            currentPrice = quote.ask;  // Fallback to ask
         }
         
         if (currentPrice > 0) {
@@ -573,8 +1023,12 @@ DLLFUNC int BrokerBuy2(char* Asset, int Amount, double StopDist, double Limit,
         // Limit order (no stop)
         orderType = "LIMIT";
         limitPrice = Limit;
-        LogInfo("# [BrokerBuy2] Limit order: %s @ %.2f (current market: %.2f)", 
-            action, limitPrice, g_bridge->GetLast(Asset));
+        if (g_state.diagLevel >= 1) {
+            Quote quote;
+            GetQuoteSnapshot(Asset, quote);
+            LogInfo("# [BrokerBuy2] Limit order: %s @ %.2f (current market: %.2f)", 
+                action, limitPrice, quote.last);
+        }
     }
     // else: Market order (defaults set above)
     
@@ -656,15 +1110,19 @@ DLLFUNC int BrokerBuy2(char* Asset, int Amount, double StopDist, double Limit,
     // For market orders, wait briefly for fill
     if (strcmp(orderType, "MARKET") == 0) {
         LogDebug("# [BrokerBuy2] Waiting for market order fill...");
+        CommandWriter statusCmd;
+        statusCmd.Begin("GETORDERSTATUS").Arg(ntActualOrderId);  // Use NT order ID
         for (int i = 0; i < 10; i++) {
             if (!responsiveSleep(100)) {
                 LogInfo("# [BrokerBuy2] User cancelled wait for fill");
                 break;  // User wants to abort
             }
             
-            int filled = g_bridge->Filled(ntActualOrderId);  // Use NT order ID
+            // Filled quantity and fill price come from the same reply
+            std::string_view statusReply = g_bridge->SendCommand(statusCmd.View());
+            int filled = g_bridge->ParseFilled(statusReply);
             if (filled > 0) {
-                double fillPrice = g_bridge->AvgFillPrice(ntActualOrderId);
+                double fillPrice = g_bridge->ParseAvgFillPrice(statusReply);
                 
                 // Update order info
                 OrderInfo* orderInfo = GetOrder(numericId);
@@ -677,10 +1135,11 @@ DLLFUNC int BrokerBuy2(char* Asset, int Amount, double StopDist, double Limit,
                 // **CRITICAL: Update position cache IMMEDIATELY on fill**
                 // This ensures GET_POSITION returns correct value instantly
                 int signedQty = (Amount > 0) ? filled : -filled;  // Positive for long, negative for sell
-                g_state.positions[Asset] += signedQty;
+                g_state.positions[Asset].quantity += signedQty;
+                InvalidateAccounts();
                 
                 LogInfo("# Order %d filled: %d @ %.2f (cached position now: %d)", 
-                    numericId, filled, fillPrice, g_state.positions[Asset]);
+                    numericId, filled, fillPrice, g_state.positions[Asset].quantity);
                 
                 if (pPrice) *pPrice = fillPrice;
                 if (pFill) *pFill = filled;
@@ -727,30 +1186,35 @@ DLLFUNC int BrokerTrade(int nTradeID, double* pOpen, double* pClose,
         return NAY;
     }
     
-    // Get current order status from NinjaTrader
-    const char* status = g_bridge->OrderStatus(order->orderId.c_str());
-    order->status = status ? status : "";
-    
-    // Check for cancelled/rejected
-    if (order->status == "Cancelled" || order->status == "Rejected") {
-        // Trigger cleanup when orders reach terminal states
-        CleanupOldOrders();
-        return NAY;
-    }
-    
-    // Get fill information
-    int filled = g_bridge->Filled(order->orderId.c_str());
-    double avgFill = g_bridge->AvgFillPrice(order->orderId.c_str());
-    
-    order->filled = filled;
-    if (avgFill > 0) {
-        order->avgFillPrice = avgFill;
-    }
-    
-    // If order is fully filled, mark as complete and trigger cleanup
-    if (filled > 0 && filled >= order->quantity) {
-        order->status = "Filled";
-        CleanupOldOrders();
+    // Get current order status - state, fill quantity and fill price come
+    // from the status table, which one GETORDERSTATUSES fills for every
+    // open trade Zorro polls in this cycle. Without a reply (timeout, or
+    // the rest of a cycle after one) the trade keeps its last known state.
+    OrderStatusRecord record;
+    if (LookupOrderStatus(*order, record)) {
+        order->status = record.state;
+        
+        // Check for cancelled/rejected
+        if (order->status == "Cancelled" || order->status == "Rejected") {
+            // Trigger cleanup when orders reach terminal states
+            CleanupOldOrders();
+            return NAY;
+        }
+        
+        // Get fill information
+        if (record.filled > order->filled) {
+            InvalidateAccounts();  // A pending order (partly) filled
+        }
+        order->filled = record.filled;
+        if (record.avgFillPrice > 0) {
+            order->avgFillPrice = record.avgFillPrice;
+        }
+        
+        // If order is fully filled, mark as complete and trigger cleanup
+        if (order->filled > 0 && order->filled >= order->quantity) {
+            order->status = "Filled";
+            CleanupOldOrders();
+        }
     }
     
     // Return entry price
@@ -758,12 +1222,11 @@ DLLFUNC int BrokerTrade(int nTradeID, double* pOpen, double* pClose,
         *pOpen = order->avgFillPrice;
     }
     
-    // Current price for P&L calculation
-    if (pClose && !order->instrument.empty()) {
-        double currentPrice = g_bridge->GetLast(order->instrument.c_str());
-        if (currentPrice > 0) {
-            *pClose = currentPrice;
-        }
+    // Current price for P&L calculation (usually the cached quote)
+    Quote quote;
+    if (pClose && !order->instrument.empty() &&
+        GetQuoteSnapshot(order->instrument.c_str(), quote) && quote.last > 0) {
+        *pClose = quote.last;
     }
     
     // Calculate profit (simplified - doesn't account for tick value)
@@ -797,14 +1260,16 @@ DLLFUNC int BrokerSell2(int nTradeID, int nAmount, double Limit,
 
     // ALWAYS update filled quantity from NinjaTrader (don't trust cached value)
     if (!order->orderId.empty()) {
-        int currentFilled = g_bridge->Filled(order->orderId.c_str());
+        CommandWriter statusCmd;
+        std::string_view statusReply = g_bridge->SendCommand(statusCmd.Begin("GETORDERSTATUS").Arg(order->orderId).View());
+        int currentFilled = g_bridge->ParseFilled(statusReply);
         
         if (currentFilled > 0) {
             // Order has filled
             order->filled = currentFilled;
             
-            // Also update average fill price
-            double avgFill = g_bridge->AvgFillPrice(order->orderId.c_str());
+            // Also update average fill price (same reply)
+            double avgFill = g_bridge->ParseAvgFillPrice(statusReply);
             if (avgFill > 0) {
                 order->avgFillPrice = avgFill;
             }
@@ -837,7 +1302,7 @@ DLLFUNC int BrokerSell2(int nTradeID, int nAmount, double Limit,
         
         // If filled is still 0, check current position from NinjaTrader
         if (quantity <= 0 && !order->instrument.empty()) {
-            int position = g_bridge->MarketPosition(order->instrument.c_str(), g_state.account.c_str());
+            int position = CurrentPosition(order->instrument.c_str(), false).quantity;
             quantity = abs(position);
             
             if (quantity > 0) {
@@ -901,15 +1366,18 @@ DLLFUNC int BrokerSell2(int nTradeID, int nAmount, double Limit,
     
     // Wait for fill (market orders)
     if (strcmp(orderType, "MARKET") == 0) {
+        CommandWriter statusCmd;
+        statusCmd.Begin("GETORDERSTATUS").Arg(ntCloseOrderId);  // Use NT order ID
         for (int i = 0; i < 10; i++) {
             if (!responsiveSleep(100)) {
                 LogInfo("# [BrokerSell2] User cancelled wait for fill");
                 break;  // User wants to abort
             }
             
-            int filled = g_bridge->Filled(ntCloseOrderId);  // Use NT order ID
+            std::string_view statusReply = g_bridge->SendCommand(statusCmd.View());
+            int filled = g_bridge->ParseFilled(statusReply);
             if (filled > 0) {
-                double fillPrice = g_bridge->AvgFillPrice(ntCloseOrderId);
+                double fillPrice = g_bridge->ParseAvgFillPrice(statusReply);
                 
                 if (pClose) *pClose = fillPrice;
                 if (pFill) *pFill = filled;
@@ -922,10 +1390,11 @@ DLLFUNC int BrokerSell2(int nTradeID, int nAmount, double Limit,
                 
                 // **CRITICAL: Update position cache on close fill**
                 int signedQty = (action == "BUY") ? filled : -filled;
-                g_state.positions[order->instrument] += signedQty;
+                g_state.positions[order->instrument].quantity += signedQty;
+                InvalidateAccounts();
                 
                 LogMessage("# Trade %d closed: %d @ %.2f (cached position now: %d)", 
-                    nTradeID, filled, fillPrice, g_state.positions[order->instrument]);
+                    nTradeID, filled, fillPrice, g_state.positions[order->instrument].quantity);
                 
                 // Poll for position update to confirm close
                 LogDebug("# Polling for position update after close...");
@@ -973,72 +1442,126 @@ DLLFUNC int BrokerHistory2(char* Asset, DATE tStart, DATE tEnd,
         return 0;
     }
     
-    // Build command
-    std::ostringstream cmd;
-    cmd << "GETHISTORY:" << Asset << ":" 
-        << std::fixed << std::setprecision(8) << tStart << ":"
-        << tEnd << ":" << nTickMinutes << ":" << nTicks;
-    
-    if (histLog) {
-        fprintf(histLog, "Sending: %s\n", cmd.str().c_str());
-        fflush(histLog);
+    // Local bars: a request inside the window the bar builder has seen
+    // completely needs no BarsRequest; one reaching back before the window
+    // only fetches the bars up to its start. Only while the push channel
+    // runs - without it the bars miss the quotes since it stopped.
+    DrainPushedQuotes();
+    DATE now = CurrentDate();
+    DATE covered = g_bridge->IsStreaming() ? g_state.bars.CoveredFrom(Asset, nTickMinutes, now) : 0;
+    if (covered > 0 && tStart > covered - nTickMinutes / (24.0 * 60.0)) {
+        int loaded = g_state.bars.Copy(Asset, nTickMinutes, tStart, tEnd, now, ticks, nTicks);
+        
+        sprintf_s(msg, sizeof(msg), "# [HIST] %d local bars, buf=%d", loaded, nTicks);
+        LogMessage(msg);
+        
+        if (histLog) {
+            fprintf(histLog, "Local bars cover from %.8f\n", covered);
+            fprintf(histLog, "Returning: %d to Zorro\n", loaded);
+            fprintf(histLog, "==== BrokerHistory2 END ====\n\n");
+            fclose(histLog);
+        }
+        return loaded;
     }
+    bool merge = (covered > 0 && covered < tEnd);
+    DATE fetchEnd = merge ? covered : tEnd;
     
-    std::string response = g_bridge->SendCommand(cmd.str());
-    
-    sprintf_s(msg, sizeof(msg), "# [HIST] Response: %zu bytes", response.length());
-    LogMessage(msg);
+    // Build command - dates in shortest round-trip form, so no sub-second
+    // part of tStart/tEnd is rounded away
+    CommandWriter cmd;
+    cmd.Begin("GETHISTORY").Arg(Asset).Arg(tStart).Arg(fetchEnd).Arg(nTickMinutes).Arg(nTicks);
     
     if (histLog) {
-        fprintf(histLog, "Response size: %zu bytes\n", response.length());
+        fprintf(histLog, "Sending: %.*s\n", (int)cmd.View().size(), cmd.View().data());
         fflush(histLog);
     }
     
-    // Parse: HISTORY:{numBars}|time,o,h,l,c,v|...
-    auto parts = g_bridge->SplitResponse(response, '|');
+    // View into the bridge's receive buffer - valid until the next command
+    std::string_view response = g_bridge->SendCommand(cmd.View());
     
-    sprintf_s(msg, sizeof(msg), "# [HIST] Split: %zu parts", parts.size());
+    sprintf_s(msg, sizeof(msg), "# [HIST] Response: %zu bytes", response.length());
     LogMessage(msg);
     
     if (histLog) {
-        fprintf(histLog, "Split into: %zu parts\n", parts.size());
+        fprintf(histLog, "Response size: %zu bytes\n", response.length());
         fflush(histLog);
     }
-    
-    if (parts.size() < 1 || parts[0].find("HISTORY:") != 0) {
-        LogError("[HIST] Bad response");
+
+    // NinjaTrader didn't deliver the bars in time - Zorro may ask again
+    if (TcpBridge::IsTimeout(response)) {
+        LogError("[HIST] Timeout waiting for history");
         if (histLog) {
-            fprintf(histLog, "ERROR: Bad response format\n");
-            if (parts.size() > 0) {
-                fprintf(histLog, "First part: %s\n", parts[0].c_str());
-            }
+            fprintf(histLog, "ERROR: Timeout\n");
             fclose(histLog);
         }
         return 0;
     }
-    
-    // Extract count
-    size_t colonPos = parts[0].find(':');
-    if (colonPos == std::string::npos) {
-        LogError("[HIST] Malformed");
+
+    // Binary codec: fixed-size bar records are copied straight into ticks
+    if (BinaryCodec::IsRecord(response)) {
+        HistoryResult result;
+        if (!BinaryCodec::DecodeHistory(response, tStart, fetchEnd, ticks, nTicks, result)) {
+            LogError("[HIST] Bad binary history record");
+            if (histLog) {
+                fprintf(histLog, "ERROR: Bad binary history record\n");
+                fclose(histLog);
+            }
+            return 0;
+        }
+        int fetched = result.loaded;
+        if (merge) {
+            result.loaded = g_state.bars.Merge(Asset, nTickMinutes, tStart, tEnd, now, ticks, result.loaded, nTicks);
+        }
+
+        sprintf_s(msg, sizeof(msg), "# [HIST] NT8=%d bars, buf=%d (binary)", result.barCount, nTicks);
+        LogMessage(msg);
+
         if (histLog) {
-            fprintf(histLog, "ERROR: Malformed header\n");
+            fprintf(histLog, "NT8 says: %d bars available (binary)\n", result.barCount);
+            fprintf(histLog, "Skipped %d bars before tStart (%.8f)\n", result.skipped, tStart);
+            fprintf(histLog, "Successfully loaded: %d bars\n", fetched);
+            fprintf(histLog, "Local bars merged: %d (cover from %.8f)\n", result.loaded - fetched, covered);
+            fprintf(histLog, "Returning: %d to Zorro\n", result.loaded);
+            fprintf(histLog, "==== BrokerHistory2 END ====\n\n");
+            fclose(histLog);
+        }
+
+        return result.loaded;
+    }
+
+    // Parse: HISTORY:{numBars}|time,o,h,l,c,v|...
+    // Bars are decoded in place in the receive buffer, straight into ticks;
+    // large replies are split across the decoder's worker threads
+    if (!g_historyDecoder) {
+        g_historyDecoder = std::make_unique<HistoryDecoder>();
+    }
+    HistoryResult result;
+    if (!g_historyDecoder->Decode(response, tStart, fetchEnd, ticks, nTicks, result)) {
+        std::string_view header = response.substr(0, response.find('|'));
+        LogError("[HIST] Bad response");
+        if (histLog) {
+            fprintf(histLog, "ERROR: Bad response format\n");
+            fprintf(histLog, "First part: %.*s\n", (int)header.size(), header.data());
             fclose(histLog);
         }
         return 0;
     }
+    int fetched = result.loaded;
+    if (merge) {
+        result.loaded = g_state.bars.Merge(Asset, nTickMinutes, tStart, tEnd, now, ticks, result.loaded, nTicks);
+    }
     
-    int barCount = std::stoi(parts[0].substr(colonPos + 1));
-    
-    sprintf_s(msg, sizeof(msg), "# [HIST] NT8=%d bars, buf=%d", barCount, nTicks);
+    sprintf_s(msg, sizeof(msg), "# [HIST] NT8=%d bars, buf=%d", result.barCount, nTicks);
     LogMessage(msg);
     
     if (histLog) {
-        fprintf(histLog, "NT8 says: %d bars available\n", barCount);
+        fprintf(histLog, "NT8 says: %d bars available\n", result.barCount);
         fprintf(histLog, "Buffer size: %d\n", nTicks);
+        fprintf(histLog, "Delimiter scan: %s, decode workers: %u\n",
+            DelimiterScanLevel(), g_historyDecoder->Workers());
     }
     
-    if (barCount == 0) {
+    if (result.barCount == 0 && result.loaded == 0) {
         if (histLog) {
             fprintf(histLog, "No bars available\n");
             fclose(histLog);
@@ -1046,59 +1569,22 @@ DLLFUNC int BrokerHistory2(char* Asset, DATE tStart, DATE tEnd,
         return 0;
     }
     
-    // Parse bars - SKIP bars before tStart!
-    int loaded = 0;
-    int skipped = 0;
-    
-    for (size_t i = 1; i < parts.size() && loaded < nTicks; i++) {
-        if (parts[i].empty()) continue;
-        
-        auto fields = g_bridge->SplitResponse(parts[i], ',');
-        if (fields.size() < 6) continue;
-        
-        try {
-            double barTime = std::stod(fields[0]);
-            
-            // CRITICAL: Skip bars before requested start time
-            if (barTime < tStart) {
-                skipped++;
-                continue;
-            }
-            
-            // Also skip bars after requested end time
-            if (barTime > tEnd) {
-                break;  // All remaining bars will be after tEnd
-            }
-            
-            ticks[loaded].time = barTime;
-            ticks[loaded].fOpen = (float)std::stod(fields[1]);
-            ticks[loaded].fHigh = (float)std::stod(fields[2]);
-            ticks[loaded].fLow = (float)std::stod(fields[3]);
-            ticks[loaded].fClose = (float)std::stod(fields[4]);
-            ticks[loaded].fVol = (float)std::stod(fields[5]);
-            
-            // Log first and last bar times
-            if (histLog && (loaded == 0 || loaded == 299)) {
-                fprintf(histLog, "Bar[%d] time=%.8f, close=%.2f\n", 
-                    loaded, ticks[loaded].time, ticks[loaded].fClose);
+    if (histLog) {
+        // Log first and last bar times
+        for (int i : { 0, 299 }) {
+            if (i < result.loaded) {
+                fprintf(histLog, "Bar[%d] time=%.8f, close=%.2f\n", i, ticks[i].time, ticks[i].fClose);
             }
-            
-            loaded++;
         }
-        catch (...) {
-            continue;
-        }
-    }
-    
-    if (histLog) {
-        fprintf(histLog, "Skipped %d bars before tStart (%.8f)\n", skipped, tStart);
-        fprintf(histLog, "Successfully loaded: %d bars\n", loaded);
-        fprintf(histLog, "Returning: %d to Zorro\n", loaded);
+        fprintf(histLog, "Skipped %d bars before tStart (%.8f)\n", result.skipped, tStart);
+        fprintf(histLog, "Successfully loaded: %d bars\n", fetched);
+        fprintf(histLog, "Local bars merged: %d (cover from %.8f)\n", result.loaded - fetched, covered);
+        fprintf(histLog, "Returning: %d to Zorro\n", result.loaded);
         fprintf(histLog, "==== BrokerHistory2 END ====\n\n");
         fclose(histLog);
     }
     
-    return loaded;
+    return result.loaded;
 }
 
 //=============================================================================
@@ -1114,7 +1600,7 @@ DLLFUNC double BrokerCommand(int Command, DWORD dwParameter)
             return NFA_COMPLIANT;
             
         case GET_BROKERZONE:
-            return -5;  // EST timezone
+            return 0;   // UTC - the AddOn converts bar times from NT8's zone
             
         case GET_MAXTICKS:
             return 0;   // No historical data via ATI
@@ -1124,8 +1610,10 @@ DLLFUNC double BrokerCommand(int Command, DWORD dwParameter)
             const char* symbol = (const char*)dwParameter;
             
             // **CRITICAL: Return cached position immediately**
-            // Never return transient 0 - always return last known value
-            int cachedPosition = g_state.positions[symbol];
+            // Never return transient 0 - always return last known value.
+            // The book is reloaded in bulk once it is older than the TTL.
+            RefreshPositionsIfStale();
+            int cachedPosition = g_state.positions[symbol].quantity;
             int absolutePosition = abs(cachedPosition);
             
             LogInfo("# GET_POSITION query for: %s (cached: %d signed, returning: %d absolute)", 
@@ -1141,7 +1629,7 @@ DLLFUNC double BrokerCommand(int Command, DWORD dwParameter)
             
             LogInfo("# GET_AVGENTRY query for: %s", symbol);
             
-            double avgEntry = g_bridge->AvgEntryPrice(symbol, g_state.account.c_str());
+            double avgEntry = CurrentPosition(symbol, false).avgPrice;
             
             LogInfo("# Avg entry returned: %.2f", avgEntry);
             
@@ -1152,11 +1640,86 @@ DLLFUNC double BrokerCommand(int Command, DWORD dwParameter)
             g_state.orderType = (int)dwParameter;
             return 1;
             
+        case SET_QUOTETTL:
+            // 0 disables reuse: every price lookup asks NinjaTrader
+            g_state.quoteTtlMs = (int)dwParameter;
+            LogInfo("# Quote TTL set to %d ms", g_state.quoteTtlMs);
+            return 1;
+            
         case SET_SYMBOL:
-            if (dwParameter) {
-                g_state.currentSymbol = (const char*)dwParameter;
+            // Only GET_BOOK uses it; every other call names its asset
+            g_state.bookSymbol = dwParameter ? (const char*)dwParameter : "";
+            return 1;
+            
+        case GET_BOOK: {
+            // Best levels of the SET_SYMBOL asset, copied from the order
+            // book the push channel keeps - no request, no allocation
+            T2* quotes = (T2*)dwParameter;
+            if (!quotes || !g_state.connected || !g_bridge->IsStreaming()) return 0;
+            
+            Subscription* subscription = g_state.subscriptions.Use(g_state.bookSymbol);
+            if (!subscription) return 0;   // BrokerAsset subscribes first
+            
+            if (!subscription->depth) {
+                // Depth starts with the first GET_BOOK of an asset; until
+                // the first rows arrive the book is empty
+                if (g_bridge->SubscribeDepth(subscription->symbol.c_str()) != 0) {
+                    LogError("# No market depth for %s", subscription->symbol.c_str());
+                    return 0;
+                }
+                subscription->depth = true;
+                LogInfo("# Market depth subscribed: %s", subscription->symbol.c_str());
             }
+            
+            return g_bridge->Book(subscription->symbol.c_str(), DepthBook::MAX_LEVELS, quotes, MAX_QUOTES);
+        }
+            
+        case SET_MAXASSETS: {
+            // Cap on subscribed assets (NinjaTrader data lines); lowering it
+            // unsubscribes the least recently used ones
+            std::vector<std::string> evicted;
+            g_state.subscriptions.SetCapacity(dwParameter > 0 ? (size_t)dwParameter : 1, evicted);
+            ReleaseEvicted(evicted);
+            LogInfo("# Asset limit set to %d", (int)g_state.subscriptions.Capacity());
             return 1;
+        }
+            
+        case SET_BARPERIOD:
+            // Period in minutes to build local bars for; 0 stops building
+            if ((int)dwParameter == 0) {
+                g_state.bars.ClearPeriods();
+                LogInfo("# Local bars disabled");
+                return 1;
+            }
+            if (!g_state.bars.AddPeriod((int)dwParameter)) {
+                LogError("# Cannot build local %d-minute bars", (int)dwParameter);
+                return 0;
+            }
+            LogInfo("# Building local %d-minute bars", (int)dwParameter);
+            return 1;
+            
+        case SET_RECORDTICKS: {
+            // Folder name starts recording the quotes seen from here on,
+            // 0 or "" stops it and finalizes the files
+            const char* folder = (const char*)(uintptr_t)dwParameter;
+            if (!folder || !*folder) {
+                if (g_tickRecorder) {
+                    g_tickRecorder->Stop();
+                    LogInfo("# Tick recording stopped (%llu updates dropped)",
+                            (unsigned long long)g_tickRecorder->Dropped());
+                }
+                return 1;
+            }
+            if (!g_tickRecorder) {
+                g_tickRecorder = std::make_unique<TickRecorder>();
+            }
+            if (!g_tickRecorder->Start(folder)) {
+                LogError("# Cannot record ticks to %s", folder);
+                return 0;
+            }
+            LogInfo("# Recording ticks to %s", folder);
+            return 1;
+        }
             
         case DO_CANCEL: {
             // Cancel specific order - handle negative IDs from pending orders
@@ -1211,14 +1774,17 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserv
             break;
             
         case DLL_PROCESS_DETACH:
-            // Cleanup
-            if (g_bridge) {
-                // Unsubscribe from market data
-                if (!g_state.currentSymbol.empty()) {
-                    g_bridge->UnSubscribeMarketData(g_state.currentSymbol.c_str());
-                }
-                g_bridge.reset();
-            }
+            // Runs under the loader lock: no network I/O and no thread
+            // joins. Zorro logs out before unloading, which unsubscribes and
+            // stops the quote reader (BrokerLogin). Without a logout the
+            // bridge is abandoned instead of destroyed - its destructor would
+            // join the reader thread - and the OS reclaims it with the process.
+            // The history decoder's workers likewise: logout joins them.
+            // Logout also stops the tick recorder and finalizes its files;
+            // a file left open here is repaired when it is reopened.
+            (void)g_bridge.release();
+            (void)g_historyDecoder.release();
+            (void)g_tickRecorder.release();
             g_state.orders.clear();
             g_state.orderIdMap.clear();
             break;
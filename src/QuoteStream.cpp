@@ -0,0 +1,366 @@
+// QuoteStream.cpp - Server-push quote channel implementation
+// Copyright (c) 2025
+
+#include "QuoteStream.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// Lines of the push channel
+using PushLines = ReplyDispatcher<StreamedQuoteSchema, DepthUpdateSchema>;
+
+//=============================================================================
+// Constructor / Destructor
+//=============================================================================
+
+template <typename Transport>
+BasicQuoteStream<Transport>::BasicQuoteStream()
+    : m_running(false)
+    , m_recvBuffer(4096)
+    , m_count(0)
+    , m_updates(new PushedQuote[UPDATE_QUEUE_CAPACITY])
+    , m_updateHead(0)
+    , m_updateTail(0)
+    , m_updatesLost(false)
+{
+    for (Slot& slot : m_slots) {
+        slot.symbol[0] = '\0';
+        slot.seq.store(0, std::memory_order_relaxed);
+    }
+}
+
+template <typename Transport>
+BasicQuoteStream<Transport>::~BasicQuoteStream()
+{
+    Stop();
+}
+
+//=============================================================================
+// Connection Management
+//=============================================================================
+
+template <typename Transport>
+bool BasicQuoteStream<Transport>::Start(const char* host, int port, int timeoutMs)
+{
+    if (IsRunning()) {
+        return true;
+    }
+    Stop();  // Reap a reader thread that exited after a dropped connection
+
+    // Transport::Startup() is done by the owning TcpBridge
+    if (!m_transport.Connect(host, port)) {
+        return false;
+    }
+
+    // Turn this connection into a push channel. Older AddOns answer
+    // "ERROR:Unknown command" and we stay with GETPRICE polling. The
+    // acknowledgement is awaited with a deadline, as on the request
+    // channels; only the reader thread blocks in Recv() afterwards.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    const char request[] = "STREAM\n";
+    bool ok = m_transport.SetNonBlocking(true) &&
+              m_transport.Send(request, (int)sizeof(request) - 1) == (int)sizeof(request) - 1;
+
+    m_recvBuffer.Clear();
+    std::string_view reply;
+    while (ok && !m_recvBuffer.NextLine(reply)) {
+        if (m_recvBuffer.WriteSpace() == 0) {
+            ok = false;  // No acknowledgement line - not a bridge we understand
+            break;
+        }
+        int received = m_transport.Recv(m_recvBuffer.WritePtr(), (int)m_recvBuffer.WriteSpace(), false);
+        if (received == WOULD_BLOCK) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            ok = remaining > 0 && m_transport.Wait(false, (int)remaining) >= 0;
+            continue;
+        }
+        if (received <= 0) {
+            ok = false;
+            break;
+        }
+        m_recvBuffer.Commit(received);
+    }
+
+    if (!ok || reply.compare(0, 3, "OK:") != 0 || !m_transport.SetNonBlocking(false)) {
+        m_transport.Close();
+        return false;
+    }
+
+    m_running.store(true, std::memory_order_release);
+    m_reader = std::thread(&BasicQuoteStream::ReaderLoop, this);
+    return true;
+}
+
+template <typename Transport>
+void BasicQuoteStream<Transport>::Stop()
+{
+    m_running.store(false, std::memory_order_release);
+
+    // Shutting the connection down unblocks Recv() in the reader thread;
+    // it is closed only after the thread is gone
+    m_transport.Shutdown();
+
+    if (m_reader.joinable()) {
+        m_reader.join();
+    }
+    m_transport.Close();
+
+    // The reader is gone - this thread is the only writer now
+    ResetTable();
+}
+
+// Forget all streamed quotes and books, keeping the watched instruments
+// (writer side only: the reader thread, or Stop() after joining it)
+template <typename Transport>
+void BasicQuoteStream<Transport>::ResetTable()
+{
+    std::lock_guard<std::mutex> lock(m_tableMutex);
+    int count = m_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        m_slots[i].seq.store(0, std::memory_order_release);
+        m_books[i].Clear();
+    }
+}
+
+//=============================================================================
+// Quote Table
+//=============================================================================
+
+template <typename Transport>
+bool BasicQuoteStream<Transport>::Watch(const char* instrument)
+{
+    if (!instrument || strlen(instrument) >= MAX_SYMBOL_LENGTH) {
+        return false;
+    }
+
+    if (Find(instrument) >= 0) {
+        return true;  // Already watched
+    }
+
+    // A slot released by Unwatch(), else the next unused one
+    int count = m_count.load(std::memory_order_relaxed);
+    int index = 0;
+    while (index < count && m_slots[index].symbol[0] != '\0') {
+        index++;
+    }
+    if (index >= MAX_ASSETS) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_tableMutex);
+    Slot& slot = m_slots[index];
+    snprintf(slot.symbol, sizeof(slot.symbol), "%s", instrument);
+    slot.seq.store(0, std::memory_order_relaxed);
+    if (index == count) {
+        m_count.store(index + 1, std::memory_order_release);
+    }
+    return true;
+}
+
+template <typename Transport>
+void BasicQuoteStream<Transport>::Unwatch(const char* instrument)
+{
+    int index = instrument ? Find(instrument) : -1;
+    if (index < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_tableMutex);
+    m_slots[index].symbol[0] = '\0';
+    m_slots[index].seq.store(0, std::memory_order_release);
+    m_books[index].Clear();
+}
+
+template <typename Transport>
+int BasicQuoteStream<Transport>::Find(std::string_view instrument) const
+{
+    int count = m_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        if (m_slots[i].symbol[0] != '\0' && instrument == m_slots[i].symbol) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+template <typename Transport>
+bool BasicQuoteStream<Transport>::Latest(const char* instrument, Quote& quote) const
+{
+    if (!instrument || !IsRunning()) return false;
+
+    int index = Find(instrument);
+    if (index < 0) {
+        return false;
+    }
+
+    // Seqlock read: retry if the writer was active or finished meanwhile
+    const Slot& slot = m_slots[index];
+    uint32_t before, after;
+    do {
+        before = slot.seq.load(std::memory_order_acquire);
+        if (before == 0) {
+            return false;  // No update received yet
+        }
+
+        quote.last = slot.last.load(std::memory_order_relaxed);
+        quote.bid = slot.bid.load(std::memory_order_relaxed);
+        quote.ask = slot.ask.load(std::memory_order_relaxed);
+        quote.volume = slot.volume.load(std::memory_order_relaxed);
+        quote.time = slot.time.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = slot.seq.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    return true;
+}
+
+template <typename Transport>
+int BasicQuoteStream<Transport>::Book(const char* instrument, int levels, T2* quotes, int maxQuotes) const
+{
+    if (!instrument || !IsRunning()) return 0;
+
+    int index = Find(instrument);
+    return (index >= 0) ? m_books[index].Top(levels, quotes, maxQuotes) : 0;
+}
+
+//=============================================================================
+// Reader Thread
+//=============================================================================
+
+template <typename Transport>
+void BasicQuoteStream<Transport>::ReaderLoop()
+{
+    // Lines that arrived together with the STREAM acknowledgement
+    std::string_view line;
+    {
+        std::lock_guard<std::mutex> lock(m_tableMutex);
+        while (m_recvBuffer.NextLine(line)) {
+            Apply(line);
+        }
+    }
+
+    while (m_running.load(std::memory_order_acquire)) {
+        m_recvBuffer.Compact();
+        if (m_recvBuffer.WriteSpace() == 0) {
+            m_recvBuffer.Reserve(4096);
+        }
+
+        int received = m_transport.Recv(m_recvBuffer.WritePtr(), (int)m_recvBuffer.WriteSpace(), false);
+        if (received <= 0) {
+            break;  // Stopped, or the AddOn went away
+        }
+        m_recvBuffer.Commit(received);
+
+        // Once per received block, not per line
+        std::lock_guard<std::mutex> lock(m_tableMutex);
+        while (m_recvBuffer.NextLine(line)) {
+            Apply(line);
+        }
+    }
+
+    // Quotes stop being live with the connection; a restarted channel
+    // starts with a gap in the queue
+    m_running.store(false, std::memory_order_release);
+    m_updatesLost = true;
+    ResetTable();
+}
+
+// Decode one QUOTE or DEPTH line into the table or the books. A malformed
+// or unknown line is dropped; the slot keeps its previous state.
+template <typename Transport>
+void BasicQuoteStream<Transport>::Apply(std::string_view line)
+{
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+
+    PushLines::Dispatch(line, [this](const auto& record) { Apply(record); });
+}
+
+// "QUOTE:{instrument}:{last}:{bid}:{ask}:{volume}:{time}"
+template <typename Transport>
+void BasicQuoteStream<Transport>::Apply(const StreamedQuote& quote)
+{
+    int index = Find(quote.instrument);
+    if (index < 0) {
+        return;  // Not watched by the plugin
+    }
+
+    // Seqlock write (single writer): odd while the prices are inconsistent
+    Slot& slot = m_slots[index];
+    uint32_t seq = slot.seq.load(std::memory_order_relaxed);
+    slot.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.last.store(quote.last, std::memory_order_relaxed);
+    slot.bid.store(quote.bid, std::memory_order_relaxed);
+    slot.ask.store(quote.ask, std::memory_order_relaxed);
+    slot.volume.store(quote.volume, std::memory_order_relaxed);
+    slot.time.store(quote.time, std::memory_order_relaxed);
+
+    slot.seq.store(seq + 2, std::memory_order_release);
+
+    // A gap marker first if updates were lost, then the update itself
+    if (m_updatesLost) {
+        m_updatesLost = !Enqueue("", Quote());
+    }
+    if (m_updatesLost || !Enqueue(slot.symbol, quote)) {
+        m_updatesLost = true;
+    }
+}
+
+// "DEPTH:{instrument}:{side}:{operation}:{position}:{price}:{volume}[:{time}]"
+template <typename Transport>
+void BasicQuoteStream<Transport>::Apply(const DepthUpdate& update)
+{
+    int index = Find(update.instrument);
+    if (index < 0 || update.side < 0 || update.side > 1 || update.operation < 0 || update.operation > 2) {
+        return;
+    }
+
+    m_books[index].Apply((BookSide)update.side, (DepthOperation)update.operation, update.position,
+                         (float)update.price, (float)update.volume, update.time);
+}
+
+//=============================================================================
+// Update Queue
+//=============================================================================
+
+// Reader thread only. Returns false if the queue is full.
+template <typename Transport>
+bool BasicQuoteStream<Transport>::Enqueue(const char* instrument, const Quote& quote)
+{
+    size_t head = m_updateHead.load(std::memory_order_relaxed);
+    if (head - m_updateTail.load(std::memory_order_acquire) >= UPDATE_QUEUE_CAPACITY) {
+        return false;
+    }
+
+    PushedQuote& update = m_updates[head & (UPDATE_QUEUE_CAPACITY - 1)];
+    snprintf(update.instrument, sizeof(update.instrument), "%s", instrument);
+    update.quote = quote;
+
+    m_updateHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename Transport>
+bool BasicQuoteStream<Transport>::NextUpdate(PushedQuote& update)
+{
+    size_t tail = m_updateTail.load(std::memory_order_relaxed);
+    if (tail == m_updateHead.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    update = m_updates[tail & (UPDATE_QUEUE_CAPACITY - 1)];
+    m_updateTail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+//=============================================================================
+// Instantiations
+//=============================================================================
+
+template class BasicQuoteStream<DefaultTransport>;
+template class BasicQuoteStream<LoopbackTransport>;
@@ -0,0 +1,405 @@
+// SharedMemoryLink.cpp - Shared-memory transport implementation
+// Copyright (c) 2025
+
+#include "SharedMemoryLink.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+// Header field offsets (see layout in SharedMemoryLink.h)
+static constexpr uint32_t OFF_MAGIC          = 0;
+static constexpr uint32_t OFF_VERSION        = 4;
+static constexpr uint32_t OFF_REQUEST_SIZE   = 8;
+static constexpr uint32_t OFF_REPLY_SIZE     = 12;
+static constexpr uint32_t OFF_CLOSED         = 16;
+static constexpr uint32_t OFF_REQUEST_HEAD   = 64;
+static constexpr uint32_t OFF_REQUEST_TAIL   = 128;
+static constexpr uint32_t OFF_REPLY_HEAD     = 192;
+static constexpr uint32_t OFF_REPLY_TAIL     = 256;
+static constexpr uint32_t OFF_PLUGIN_WAITING = 320;
+static constexpr uint32_t OFF_ADDON_WAITING  = 384;
+
+// Polls before falling asleep - a reply to a small command usually arrives
+// within a few microseconds, far less than a sleep/wake round trip. After
+// a short busy spin the thread yields; on a single core the busy spin is
+// skipped, since the peer can't make progress while we hold the CPU.
+static constexpr int SPIN_COUNT = 200;
+static constexpr int YIELD_COUNT = 50;
+static const int s_spinCount = std::thread::hardware_concurrency() > 1 ? SPIN_COUNT : 0;
+
+static inline void CpuRelax()
+{
+#ifdef _WIN32
+    YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static inline void YieldThread()
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+static bool IsPowerOfTwo(uint32_t n)
+{
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+//=============================================================================
+// Constructor / Destructor
+//=============================================================================
+
+SharedMemoryLink::SharedMemoryLink()
+    : m_base(nullptr)
+    , m_mappedSize(0)
+    , m_server(false)
+    , m_ownWaiting(nullptr)
+    , m_peerWaiting(nullptr)
+#ifdef _WIN32
+    , m_mapping(NULL)
+    , m_ownEvent(NULL)
+    , m_peerEvent(NULL)
+#else
+    , m_fd(-1)
+#endif
+{
+    m_name[0] = '\0';
+}
+
+SharedMemoryLink::~SharedMemoryLink()
+{
+    Close();
+}
+
+//=============================================================================
+// Mapping
+//=============================================================================
+
+bool SharedMemoryLink::Open(const char* name)
+{
+    Close();
+    if (!name || strlen(name) >= MAX_NAME_LENGTH) {
+        return false;
+    }
+
+    snprintf(m_name, sizeof(m_name), "%s", name);
+    m_server = false;
+    return Map(false, 0, 0);
+}
+
+bool SharedMemoryLink::Create(const char* name, uint32_t requestSize, uint32_t replySize)
+{
+    Close();
+    if (!name || strlen(name) >= MAX_NAME_LENGTH ||
+        !IsPowerOfTwo(requestSize) || !IsPowerOfTwo(replySize)) {
+        return false;
+    }
+
+    snprintf(m_name, sizeof(m_name), "%s", name);
+    m_server = true;
+    return Map(true, requestSize, replySize);
+}
+
+bool SharedMemoryLink::Map(bool create, uint32_t requestSize, uint32_t replySize)
+{
+    size_t total = (size_t)HEADER_SIZE + requestSize + replySize;
+
+#ifdef _WIN32
+    // Event names: "<name>_Plugin" wakes the plugin, "<name>_AddOn" the AddOn
+    char pluginEvent[MAX_NAME_LENGTH + 8], addonEvent[MAX_NAME_LENGTH + 8];
+    sprintf_s(pluginEvent, sizeof(pluginEvent), "%s_Plugin", m_name);
+    sprintf_s(addonEvent, sizeof(addonEvent), "%s_AddOn", m_name);
+
+    if (create) {
+        m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                       0, (DWORD)total, m_name);
+        m_ownEvent = CreateEventA(NULL, FALSE, FALSE, addonEvent);
+        m_peerEvent = CreateEventA(NULL, FALSE, FALSE, pluginEvent);
+    } else {
+        m_mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, m_name);
+        m_ownEvent = OpenEventA(SYNCHRONIZE | EVENT_MODIFY_STATE, FALSE, pluginEvent);
+        m_peerEvent = OpenEventA(SYNCHRONIZE | EVENT_MODIFY_STATE, FALSE, addonEvent);
+    }
+    if (!m_mapping || !m_ownEvent || !m_peerEvent) {
+        Close();
+        return false;
+    }
+
+    // Size 0 maps the whole object - the client learns the size from the header
+    m_base = (char*)MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, create ? total : 0);
+    if (!m_base) {
+        Close();
+        return false;
+    }
+#else
+    if (create) {
+        m_fd = shm_open(m_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (m_fd >= 0 && ftruncate(m_fd, (off_t)total) != 0) {
+            Close();
+            return false;
+        }
+    } else {
+        m_fd = shm_open(m_name, O_RDWR, 0);
+        struct stat st;
+        total = (m_fd >= 0 && fstat(m_fd, &st) == 0) ? (size_t)st.st_size : 0;
+    }
+    if (m_fd < 0 || total < HEADER_SIZE) {
+        Close();
+        return false;
+    }
+
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (base == MAP_FAILED) {
+        Close();
+        return false;
+    }
+    m_base = (char*)base;
+#endif
+
+    m_mappedSize = total;
+
+    if (create) {
+        memset(m_base, 0, HEADER_SIZE);
+        *Field(OFF_VERSION) = VERSION;
+        *Field(OFF_REQUEST_SIZE) = requestSize;
+        *Field(OFF_REPLY_SIZE) = replySize;
+        std::atomic_thread_fence(std::memory_order_release);
+        *Field(OFF_MAGIC) = MAGIC;
+    } else {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        requestSize = *Field(OFF_REQUEST_SIZE);
+        replySize = *Field(OFF_REPLY_SIZE);
+        if (*Field(OFF_MAGIC) != MAGIC || *Field(OFF_VERSION) != VERSION ||
+            !IsPowerOfTwo(requestSize) || !IsPowerOfTwo(replySize)) {
+            Close();
+            return false;
+        }
+#ifndef _WIN32
+        if ((size_t)HEADER_SIZE + requestSize + replySize > m_mappedSize) {
+            Close();
+            return false;
+        }
+#endif
+    }
+
+    Attach();
+    return true;
+}
+
+// Point the rings and waiting flags at the mapping, from this side's view
+void SharedMemoryLink::Attach()
+{
+    Ring request, reply;
+    request.head = (std::atomic<uint32_t>*)Field(OFF_REQUEST_HEAD);
+    request.tail = (std::atomic<uint32_t>*)Field(OFF_REQUEST_TAIL);
+    request.size = *Field(OFF_REQUEST_SIZE);
+    request.data = m_base + HEADER_SIZE;
+
+    reply.head = (std::atomic<uint32_t>*)Field(OFF_REPLY_HEAD);
+    reply.tail = (std::atomic<uint32_t>*)Field(OFF_REPLY_TAIL);
+    reply.size = *Field(OFF_REPLY_SIZE);
+    reply.data = request.data + request.size;
+
+    std::atomic<uint32_t>* pluginWaiting = (std::atomic<uint32_t>*)Field(OFF_PLUGIN_WAITING);
+    std::atomic<uint32_t>* addonWaiting = (std::atomic<uint32_t>*)Field(OFF_ADDON_WAITING);
+
+    m_outgoing = m_server ? reply : request;
+    m_incoming = m_server ? request : reply;
+    m_ownWaiting = m_server ? addonWaiting : pluginWaiting;
+    m_peerWaiting = m_server ? pluginWaiting : addonWaiting;
+}
+
+void SharedMemoryLink::Close()
+{
+    if (m_base && m_peerWaiting) {
+        // Tell the peer, and wake it in case it is sleeping on us
+        ((std::atomic<uint32_t>*)Field(OFF_CLOSED))->store(1, std::memory_order_seq_cst);
+        WakePeer();
+    }
+
+#ifdef _WIN32
+    if (m_base) UnmapViewOfFile(m_base);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_ownEvent) CloseHandle(m_ownEvent);
+    if (m_peerEvent) CloseHandle(m_peerEvent);
+    m_mapping = m_ownEvent = m_peerEvent = NULL;
+#else
+    if (m_base) munmap(m_base, m_mappedSize);
+    if (m_fd >= 0) {
+        close(m_fd);
+        if (m_server) shm_unlink(m_name);
+    }
+    m_fd = -1;
+#endif
+
+    m_base = nullptr;
+    m_mappedSize = 0;
+    m_outgoing = Ring();
+    m_incoming = Ring();
+    m_ownWaiting = m_peerWaiting = nullptr;
+}
+
+bool SharedMemoryLink::PeerClosed() const
+{
+    return !m_base || ((std::atomic<uint32_t>*)Field(OFF_CLOSED))->load(std::memory_order_acquire) != 0;
+}
+
+//=============================================================================
+// Wakeup
+//=============================================================================
+
+bool SharedMemoryLink::CanRead() const
+{
+    return m_incoming.head->load(std::memory_order_acquire) !=
+           m_incoming.tail->load(std::memory_order_relaxed);
+}
+
+uint32_t SharedMemoryLink::WriteSpace() const
+{
+    uint32_t used = m_outgoing.head->load(std::memory_order_relaxed) -
+                    m_outgoing.tail->load(std::memory_order_acquire);
+    return m_outgoing.size - used;
+}
+
+// Spin, then sleep until 'ready' holds, the peer closes or the timeout ends.
+// The flag is raised before the final check, and the peer checks the flag
+// after publishing, so a wakeup can't fall between the two (both seq_cst).
+template <typename Ready>
+bool SharedMemoryLink::Wait(Ready ready, int timeoutMs)
+{
+    for (int i = 0; i < s_spinCount + YIELD_COUNT; i++) {
+        if (ready()) return true;
+        if (i < s_spinCount) CpuRelax(); else YieldThread();
+    }
+
+    m_ownWaiting->store(1, std::memory_order_seq_cst);
+    if (!ready() && !PeerClosed()) {
+#ifdef _WIN32
+        WaitForSingleObject(m_ownEvent, (DWORD)timeoutMs);
+#else
+        struct timespec timeout;
+        timeout.tv_sec = timeoutMs / 1000;
+        timeout.tv_nsec = (long)(timeoutMs % 1000) * 1000000L;
+        syscall(SYS_futex, (uint32_t*)m_ownWaiting, FUTEX_WAIT, 1, &timeout, nullptr, 0);
+#endif
+    }
+    m_ownWaiting->store(0, std::memory_order_relaxed);
+
+    return ready();
+}
+
+void SharedMemoryLink::WakePeer()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_peerWaiting->load(std::memory_order_relaxed) == 0 ||
+        m_peerWaiting->exchange(0, std::memory_order_seq_cst) == 0) {
+        return;  // Peer is running - no system call needed
+    }
+
+#ifdef _WIN32
+    SetEvent(m_peerEvent);
+#else
+    syscall(SYS_futex, (uint32_t*)m_peerWaiting, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#endif
+}
+
+//=============================================================================
+// Byte Stream
+//=============================================================================
+
+int SharedMemoryLink::Send(const char* data, size_t length, int timeoutMs)
+{
+    if (!m_base) return -1;
+
+    Ring& ring = m_outgoing;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    size_t written = 0;
+    while (written < length) {
+        if (PeerClosed()) {
+            return -1;
+        }
+
+        // Wait for room for the whole message if it can fit at all, so a
+        // timeout never leaves half a request in the ring
+        size_t left = length - written;
+        uint32_t needed = (written == 0 && left <= ring.size) ? (uint32_t)left : 1;
+        uint32_t space = WriteSpace();
+        if (space < needed) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) {
+                return written == 0 ? 0 : -1;
+            }
+            Wait([&] { return WriteSpace() >= needed; }, (int)remaining);
+            continue;
+        }
+
+        // Copy in up to two pieces when the write wraps around the end
+        uint32_t head = ring.head->load(std::memory_order_relaxed);
+        uint32_t n = (uint32_t)(left < space ? left : space);
+        uint32_t offset = head & (ring.size - 1);
+        uint32_t first = (n < ring.size - offset) ? n : ring.size - offset;
+        memcpy(ring.data + offset, data + written, first);
+        memcpy(ring.data, data + written + first, n - first);
+
+        ring.head->store(head + n, std::memory_order_release);
+        WakePeer();
+
+        written += n;
+    }
+    return (int)length;
+}
+
+int SharedMemoryLink::Recv(char* buffer, size_t length, bool waitAll, int timeoutMs)
+{
+    if (!m_base) return -1;
+
+    Ring& ring = m_incoming;
+    size_t received = 0;
+    while (received < length) {
+        uint32_t tail = ring.tail->load(std::memory_order_relaxed);
+        uint32_t available = ring.head->load(std::memory_order_acquire) - tail;
+        if (available == 0) {
+            if (received > 0 && !waitAll) {
+                break;
+            }
+            if (PeerClosed()) {
+                return -1;
+            }
+            if (!Wait([this] { return CanRead(); }, timeoutMs) && !PeerClosed()) {
+                break;  // Timed out - the caller decides whether to keep waiting
+            }
+            continue;
+        }
+
+        size_t wanted = length - received;
+        uint32_t n = (uint32_t)(wanted < available ? wanted : available);
+        uint32_t offset = tail & (ring.size - 1);
+        uint32_t first = (n < ring.size - offset) ? n : ring.size - offset;
+        memcpy(buffer + received, ring.data + offset, first);
+        memcpy(buffer + received + first, ring.data, n - first);
+
+        ring.tail->store(tail + n, std::memory_order_release);
+        WakePeer();
+
+        received += n;
+    }
+    return (int)received;
+}
@@ -0,0 +1,80 @@
+// SubscriptionRegistry.cpp - Market data subscriptions of the plugin
+// Copyright (c) 2025
+
+#include "SubscriptionRegistry.h"
+
+SubscriptionRegistry::SubscriptionRegistry(size_t capacity)
+    : m_capacity(capacity > 0 ? capacity : 1)
+{
+}
+
+Subscription* SubscriptionRegistry::Use(std::string_view symbol)
+{
+    auto it = m_index.find(symbol);
+    if (it == m_index.end()) {
+        return nullptr;
+    }
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second);   // Iterators stay valid
+    return &*it->second;
+}
+
+const Subscription* SubscriptionRegistry::Find(std::string_view symbol) const
+{
+    auto it = m_index.find(symbol);
+    return (it != m_index.end()) ? &*it->second : nullptr;
+}
+
+Subscription& SubscriptionRegistry::Add(std::string_view symbol, const AssetSpec& spec,
+                                        std::vector<std::string>& evicted)
+{
+    Subscription* existing = Use(symbol);
+    if (existing) {
+        existing->spec = spec;
+        return *existing;
+    }
+
+    m_lru.emplace_front();
+    Subscription& entry = m_lru.front();
+    entry.symbol.assign(symbol);
+    entry.spec = spec;
+    m_index.emplace(entry.symbol, m_lru.begin());
+
+    Trim(evicted);
+    return entry;
+}
+
+bool SubscriptionRegistry::Remove(std::string_view symbol)
+{
+    auto it = m_index.find(symbol);
+    if (it == m_index.end()) {
+        return false;
+    }
+
+    m_lru.erase(it->second);
+    m_index.erase(it);
+    return true;
+}
+
+void SubscriptionRegistry::SetCapacity(size_t capacity, std::vector<std::string>& evicted)
+{
+    m_capacity = capacity > 0 ? capacity : 1;
+    Trim(evicted);
+}
+
+void SubscriptionRegistry::Clear()
+{
+    m_index.clear();
+    m_lru.clear();
+}
+
+// Evict from the back until the capacity is met
+void SubscriptionRegistry::Trim(std::vector<std::string>& evicted)
+{
+    while (m_index.size() > m_capacity) {
+        Subscription& oldest = m_lru.back();
+        m_index.erase(oldest.symbol);
+        evicted.push_back(std::move(oldest.symbol));
+        m_lru.pop_back();
+    }
+}
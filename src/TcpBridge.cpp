@@ -2,189 +2,234 @@
 // Copyright (c) 2025
 
 #include "TcpBridge.h"
-#include <sstream>
-#include <vector>
+#include <cstdio>
+#include <cstring>
 
 //=============================================================================
 // Constructor / Destructor
 //=============================================================================
 
-TcpBridge::TcpBridge()
-    : m_socket(INVALID_SOCKET)
-    , m_connected(false)
+template <typename Transport, typename CodecPolicy>
+BasicTcpBridge<Transport, CodecPolicy>::BasicTcpBridge()
+    : m_orderChannel(4 * 1024)    // Order replies are a few dozen bytes
+    , m_sharedMemory(true)
+    , m_port(0)
+    , m_streamWanted(false)
     , m_nextOrderId(1000)
 {
-    InitializeWinsock();
+    Transport::Startup();
 }
 
-TcpBridge::~TcpBridge()
+template <typename Transport, typename CodecPolicy>
+BasicTcpBridge<Transport, CodecPolicy>::~BasicTcpBridge()
 {
     Disconnect();
-    CleanupWinsock();
+    Transport::Cleanup();
 }
 
 //=============================================================================
 // Connection Management
 //=============================================================================
 
-bool TcpBridge::InitializeWinsock()
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::Connect(const char* host, int port)
 {
-    WSADATA wsaData;
-    int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
-    return (result == 0);
-}
-
-void TcpBridge::CleanupWinsock()
-{
-    WSACleanup();
-}
-
-bool TcpBridge::Connect(const char* host, int port)
-{
-    if (m_connected) {
+    if (IsConnected()) {
         return true;  // Already connected
     }
     
-    // Create socket
-    m_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-    if (m_socket == INVALID_SOCKET) {
+    // The data channel is required - it also carries login and subscriptions
+    if (!OpenChannel(m_dataChannel, host, port)) {
         return false;
     }
     
-    // Setup address
-    sockaddr_in serverAddr;
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_port = htons(port);
+    // Dedicated order and history connections. If the AddOn refuses them,
+    // their traffic falls back to the data channel (see Route).
+    OpenChannel(m_orderChannel, host, port);
+    OpenChannel(m_historyChannel, host, port);
     
-    // Convert host to address
-    inet_pton(AF_INET, host, &serverAddr.sin_addr);
+    // Open the quote push channel. Without it, prices are polled.
+    m_host = host;
+    m_port = port;
+    m_streamWanted = m_quoteStream.Start(host, port, m_timeouts.data);
+    m_streamRetry = std::chrono::steady_clock::now();
     
-    // Connect
-    if (connect(m_socket, (sockaddr*)&serverAddr, sizeof(serverAddr)) == SOCKET_ERROR) {
-        closesocket(m_socket);
-        m_socket = INVALID_SOCKET;
+    return true;
+}
+
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::ResumeStreaming()
+{
+    if (!m_streamWanted || m_quoteStream.IsRunning() || !IsConnected()) {
         return false;
     }
     
-    m_connected = true;
+    auto now = std::chrono::steady_clock::now();
+    if (now < m_streamRetry) {
+        return false;
+    }
+    m_streamRetry = now + std::chrono::milliseconds(STREAM_RETRY_MS);
     
-    // Test connection with PING
-    std::string response = SendCommand("PING");
-    if (response != "PONG") {
-        Disconnect();
+    return m_quoteStream.Start(m_host.c_str(), m_port, m_timeouts.data);
+}
+
+// A strict codec policy can't decode anything else, so a connection that
+// didn't negotiate its codec is not usable
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::OpenChannel(Channel& channel, const char* host, int port)
+{
+    if (!channel.Open(host, port, CodecPolicy::PREFERRED, m_sharedMemory)) {
         return false;
     }
     
+    if (CodecPolicy::STRICT && channel.GetCodec() != CodecPolicy::PREFERRED) {
+        channel.Close();
+        return false;
+    }
     return true;
 }
 
-void TcpBridge::Disconnect()
+template <typename Transport, typename CodecPolicy>
+void BasicTcpBridge<Transport, CodecPolicy>::Disconnect()
 {
-    if (m_socket != INVALID_SOCKET) {
-        closesocket(m_socket);
-        m_socket = INVALID_SOCKET;
-    }
-    m_connected = false;
+    m_streamWanted = false;
+    m_quoteStream.Stop();
+    
+    m_historyChannel.Close();
+    m_orderChannel.Close();
+    m_dataChannel.Close();
 }
 
 //=============================================================================
 // Communication Helper
 //=============================================================================
 
-std::string TcpBridge::SendCommand(const std::string& command)
+template <typename Transport, typename CodecPolicy>
+std::string_view BasicTcpBridge<Transport, CodecPolicy>::SendCommand(std::string_view command)
+{
+    TrafficClass traffic = Classify(command);
+    return Route(traffic).SendCommand(command, TimeoutFor(traffic, command));
+}
+
+template <typename Transport, typename CodecPolicy>
+std::string_view BasicTcpBridge<Transport, CodecPolicy>::SendCommand(TrafficClass traffic, std::string_view command)
 {
-    if (!m_connected || m_socket == INVALID_SOCKET) {
-        return "ERROR:Not connected";
+    return Route(traffic).SendCommand(command, TimeoutFor(traffic, command));
+}
+
+template <typename Transport, typename CodecPolicy>
+size_t BasicTcpBridge<Transport, CodecPolicy>::SendBatch(const std::string_view* commands, size_t count,
+                                                         std::string_view* replies)
+{
+    if (count == 0) {
+        return 0;
     }
     
-    // Send command
-    std::string fullCommand = command + "\n";
-    int sent = send(m_socket, fullCommand.c_str(), (int)fullCommand.length(), 0);
-    if (sent == SOCKET_ERROR) {
-        m_connected = false;
-        return "ERROR:Send failed";
+    // A batch is answered in order on one connection, so it goes wherever
+    // its first command belongs
+    TrafficClass traffic = Classify(commands[0]);
+    int timeoutMs = 0;
+    for (size_t i = 0; i < count; i++) {
+        int commandTimeout = TimeoutFor(traffic, commands[i]);
+        if (commandTimeout > timeoutMs) {
+            timeoutMs = commandTimeout;
+        }
     }
     
-    // Receive response - use LARGE buffer for historical data
-    // Historical data can be VERY large (10,000 bars = ~600KB)
-    const int BUFFER_SIZE = 1048576;  // 1MB buffer for large historical responses
-    std::string response;
-    char* buffer = new char[BUFFER_SIZE];  // Allocate on heap for large size
+    return Route(traffic).SendBatch(commands, count, replies, timeoutMs);
+}
+
+// Order entry and bulk downloads get their own connections; everything
+// else (login, subscriptions, prices, account, positions, order status)
+// shares the data channel.
+template <typename Transport, typename CodecPolicy>
+typename BasicTcpBridge<Transport, CodecPolicy>::TrafficClass
+BasicTcpBridge<Transport, CodecPolicy>::Classify(std::string_view command)
+{
+    std::string_view verb = command.substr(0, command.find(':'));
     
-    try {
-        // Read all available data (may need multiple recv calls)
-        bool hasMoreData = true;
-        while (hasMoreData) {
-            int received = recv(m_socket, buffer, BUFFER_SIZE - 1, 0);
-            
-            if (received == SOCKET_ERROR || received == 0) {
-                m_connected = false;
-                delete[] buffer;
-                return "ERROR:Receive failed";
-            }
-            
-            buffer[received] = '\0';
-            response += std::string(buffer);
-            
-            // Check if we got a complete response (ends with newline)
-            if (received < (BUFFER_SIZE - 1) || response.back() == '\n') {
-                hasMoreData = false;
-            }
-        }
-        
-        delete[] buffer;
-        
-        m_lastResponse = response;
-        
-        // Remove trailing newline
-        if (!m_lastResponse.empty() && m_lastResponse.back() == '\n') {
-            m_lastResponse.pop_back();
-        }
-        
-        return m_lastResponse;
+    if (verb == "PLACEORDER" || verb == "CANCELORDER") {
+        return TrafficClass::Orders;
     }
-    catch (...) {
-        delete[] buffer;
-        m_connected = false;
-        return "ERROR:Exception in receive";
+    if (verb == "GETHISTORY" || verb == "GETINSTRUMENTS") {
+        return TrafficClass::History;
     }
+    return TrafficClass::Data;
 }
 
-std::vector<std::string> TcpBridge::SplitResponse(const std::string& response, char delimiter)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::TimeoutFor(TrafficClass traffic, std::string_view command) const
 {
-    std::vector<std::string> parts;
-    std::stringstream ss(response);
-    std::string item;
+    switch (traffic) {
+        case TrafficClass::Orders:  return m_timeouts.order;
+        case TrafficClass::History: return m_timeouts.history;
+        default: break;
+    }
     
-    while (std::getline(ss, item, delimiter)) {
-        parts.push_back(item);
+    bool quote = command.compare(0, 9, "GETPRICE:") == 0 || command.compare(0, 10, "GETPRICES:") == 0;
+    return quote ? m_timeouts.quote : m_timeouts.data;
+}
+
+template <typename Transport, typename CodecPolicy>
+typename BasicTcpBridge<Transport, CodecPolicy>::Channel&
+BasicTcpBridge<Transport, CodecPolicy>::Route(TrafficClass traffic)
+{
+    Channel* channel = &m_dataChannel;
+    switch (traffic) {
+        case TrafficClass::Orders:  channel = &m_orderChannel; break;
+        case TrafficClass::History: channel = &m_historyChannel; break;
+        default: break;
     }
     
-    return parts;
+    return channel->IsOpen() ? *channel : m_dataChannel;
+}
+
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::HasChannel(TrafficClass traffic) const
+{
+    switch (traffic) {
+        case TrafficClass::Orders:  return m_orderChannel.IsOpen();
+        case TrafficClass::History: return m_historyChannel.IsOpen();
+        default:                    return m_dataChannel.IsOpen();
+    }
+}
+
+// Build "VERB:argument" in the command writer (no allocation)
+template <typename Transport, typename CodecPolicy>
+std::string_view BasicTcpBridge<Transport, CodecPolicy>::BuildCommand(const char* verb, const char* argument)
+{
+    return m_command.Begin(verb).Arg(argument).View();
 }
 
 //=============================================================================
 // Connection
 //=============================================================================
 
-int TcpBridge::Connected(int showMessage)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::Connected(int showMessage)
 {
-    if (!m_connected) {
+    if (!IsConnected()) {
         // Try to connect
         if (!Connect()) {
             return -1;  // Failed to connect
         }
     }
     
-    std::string response = SendCommand("CONNECTED");
-    if (response.find("CONNECTED:1") != std::string::npos) {
+    std::string_view response = SendCommand("CONNECTED");
+    if (response.find("CONNECTED:1") != std::string_view::npos) {
         return 0;  // Connected
     }
     
+    // A busy AddOn is still there - don't drop the session over it
+    if (IsTimeout(response) && IsConnected()) {
+        return 0;
+    }
+    
     return -1;  // Not connected
 }
 
-int TcpBridge::TearDown()
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::TearDown()
 {
     SendCommand("LOGOUT");
     Disconnect();
@@ -195,45 +240,118 @@ int TcpBridge::TearDown()
 // Market Data
 //=============================================================================
 
-int TcpBridge::SubscribeMarketData(const char* instrument)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::SubscribeMarketData(const char* instrument)
 {
     if (!instrument) return -1;
     
-    std::string cmd = std::string("SUBSCRIBE:") + instrument;
-    std::string response = SendCommand(cmd);
+    std::string_view response = SendCommand(BuildCommand("SUBSCRIBE", instrument));
     
-    return (response.find("OK") != std::string::npos) ? 0 : -1;
+    return (response.find("OK") != std::string_view::npos) ? 0 : -1;
 }
 
-int TcpBridge::UnSubscribeMarketData(const char* instrument)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::UnSubscribeMarketData(const char* instrument)
 {
     if (!instrument) return -1;
     
-    std::string cmd = std::string("UNSUBSCRIBE:") + instrument;
-    std::string response = SendCommand(cmd);
+    std::string_view response = SendCommand(BuildCommand("UNSUBSCRIBE", instrument));
     
-    return (response.find("OK") != std::string::npos) ? 0 : -1;
+    return (response.find("OK") != std::string_view::npos) ? 0 : -1;
 }
 
-double TcpBridge::MarketData(const char* instrument, int dataType)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::SubscribeDepth(const char* instrument)
+{
+    if (!instrument) return -1;
+    
+    std::string_view response = SendCommand(BuildCommand("SUBSCRIBEDEPTH", instrument));
+    
+    return (response.find("OK") != std::string_view::npos) ? 0 : -1;
+}
+
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::MarketData(const char* instrument, int dataType)
 {
     if (!instrument) return 0.0;
     
-    std::string cmd = std::string("GETPRICE:") + instrument;
-    std::string response = SendCommand(cmd);
+    return ParseMarketData(SendCommand(BuildCommand("GETPRICE", instrument)), dataType);
+}
+
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::GetQuote(const char* instrument, Quote& quote)
+{
+    if (!instrument) return false;
     
-    // Parse response: PRICE:last:bid:ask:volume
-    auto parts = SplitResponse(response, ':');
-    if (parts.size() < 5 || parts[0] != "PRICE") {
+    // Latest pushed quote - no network I/O. Once the push channel has
+    // stopped there is none, and the quote is polled.
+    if (m_quoteStream.Latest(instrument, quote)) {
+        return true;
+    }
+    
+    return ParseQuote(SendCommand(BuildCommand("GETPRICE", instrument)), quote);
+}
+
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::Quotes(const std::string* instruments, size_t count,
+                                                    Tokenizer& entries)
+{
+    // GETPRICES:sym1,sym2,... -> PRICES:n|sym,last,bid,ask,volume|...
+    m_commandBuffer.assign("GETPRICES:");
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) m_commandBuffer += ',';
+        m_commandBuffer += instruments[i];
+    }
+    
+    std::string_view response = SendCommand(m_commandBuffer);
+    
+    Tokenizer list(response, '|');
+    std::string_view header;
+    if (!list.Next(header) || header.compare(0, 7, "PRICES:") != 0) {
+        entries = Tokenizer(response, '|');   // Error text, for the caller
+        return false;
+    }
+    
+    entries = list;
+    return true;
+}
+
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::NextQuote(Tokenizer& entries, std::string_view& instrument,
+                                                       Quote& quote)
+{
+    // Malformed entries are skipped; the caller falls back to GETPRICE for those
+    std::string_view entry;
+    while (entries.Next(entry)) {
+        if (TextCodec::DecodeQuoteEntry(entry, instrument, quote)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::ParseQuote(std::string_view response, Quote& quote)
+{
+    // PRICE:last:bid:ask:volume or binary QUOTE record
+    quote = Quote();
+    return CodecPolicy::DecodeQuote(response, quote);
+}
+
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::ParseMarketData(std::string_view response, int dataType)
+{
+    Quote quote;
+    if (!ParseQuote(response, quote)) {
         return 0.0;
     }
     
     // dataType: 0=Last, 1=Bid, 2=Ask, 3=Volume
     switch (dataType) {
-        case 0: return std::stod(parts[1]);  // Last
-        case 1: return std::stod(parts[2]);  // Bid
-        case 2: return std::stod(parts[3]);  // Ask
-        case 3: return std::stod(parts[4]);  // Volume
+        case 0: return quote.last;
+        case 1: return quote.bid;
+        case 2: return quote.ask;
+        case 3: return quote.volume;
         default: return 0.0;
     }
 }
@@ -242,154 +360,199 @@ double TcpBridge::MarketData(const char* instrument, int dataType)
 // Account
 //=============================================================================
 
-double TcpBridge::CashValue(const char* account)
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::GetAccount(const char* account, AccountRecord& record)
 {
-    std::string response = SendCommand("GETACCOUNT");
-    
-    // Parse response: ACCOUNT:cashValue:buyingPower:realizedPnL
-    auto parts = SplitResponse(response, ':');
-    if (parts.size() < 4 || parts[0] != "ACCOUNT") {
-        return 0.0;
-    }
-    
-    return std::stod(parts[1]);
+    return ParseAccount(SendCommand("GETACCOUNT"), record);
 }
 
-double TcpBridge::BuyingPower(const char* account)
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::CashValue(const char* account)
 {
-    std::string response = SendCommand("GETACCOUNT");
-    
-    auto parts = SplitResponse(response, ':');
-    if (parts.size() < 4 || parts[0] != "ACCOUNT") {
+    return ParseAccount(SendCommand("GETACCOUNT"), 0);
+}
+
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::BuyingPower(const char* account)
+{
+    return ParseAccount(SendCommand("GETACCOUNT"), 1);
+}
+
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::RealizedPnL(const char* account)
+{
+    return ParseAccount(SendCommand("GETACCOUNT"), 2);
+}
+
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::UnrealizedPnL(const char* account)
+{
+    return ParseAccount(SendCommand("GETACCOUNT"), 3);
+}
+
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::ParseAccount(std::string_view response, AccountRecord& record)
+{
+    // ACCOUNT:cashValue:buyingPower:realizedPnL:unrealizedPnL or binary record
+    record = AccountRecord();
+    return CodecPolicy::DecodeAccount(response, record);
+}
+
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::ParseAccount(std::string_view response, int field)
+{
+    AccountRecord account;
+    if (!ParseAccount(response, account)) {
         return 0.0;
     }
     
-    return std::stod(parts[2]);
+    // field: 0=CashValue, 1=BuyingPower, 2=RealizedPnL, 3=UnrealizedPnL
+    switch (field) {
+        case 0: return account.cashValue;
+        case 1: return account.buyingPower;
+        case 2: return account.realizedPnL;
+        case 3: return account.unrealizedPnL;
+        default: return 0.0;
+    }
 }
 
-double TcpBridge::RealizedPnL(const char* account)
+//=============================================================================
+// Position
+//=============================================================================
+
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::Positions(Tokenizer& entries)
 {
-    std::string response = SendCommand("GETACCOUNT");
+    // GETPOSITIONS -> POSITIONS:n|instrument,quantity,avgPrice|...
+    std::string_view response = SendCommand("GETPOSITIONS");
     
-    auto parts = SplitResponse(response, ':');
-    if (parts.size() < 4 || parts[0] != "ACCOUNT") {
-        return 0.0;
+    Tokenizer list(response, '|');
+    std::string_view header;
+    if (!list.Next(header) || header.compare(0, 10, "POSITIONS:") != 0) {
+        entries = Tokenizer(response, '|');   // Error text, for the caller
+        return false;
     }
     
-    return std::stod(parts[3]);
+    entries = list;
+    return true;
 }
 
-double TcpBridge::UnrealizedPnL(const char* account)
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::NextPosition(Tokenizer& entries, std::string_view& instrument,
+                                                          PositionRecord& position)
 {
-    std::string response = SendCommand("GETACCOUNT");
-    
-    // Parse response: ACCOUNT:cashValue:buyingPower:realizedPnL:unrealizedPnL
-    auto parts = SplitResponse(response, ':');
-    if (parts.size() < 5 || parts[0] != "ACCOUNT") {
-        return 0.0;
+    std::string_view entry;
+    while (entries.Next(entry)) {
+        if (TextCodec::DecodePositionEntry(entry, instrument, position)) {
+            return true;
+        }
     }
-    
-    return std::stod(parts[4]);  // unrealized P&L
+    return false;
 }
 
-//=============================================================================
-// Position
-//=============================================================================
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::GetPosition(const char* instrument, PositionRecord& position)
+{
+    if (!instrument) return false;
+    
+    position = PositionRecord();
+    return CodecPolicy::DecodePosition(SendCommand(BuildCommand("GETPOSITION", instrument)), position);
+}
 
-int TcpBridge::MarketPosition(const char* instrument, const char* account)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::MarketPosition(const char* instrument, const char* account)
 {
     if (!instrument) return 0;
     
-    std::string cmd = std::string("GETPOSITION:") + instrument;
-    std::string response = SendCommand(cmd);
+    std::string_view response = SendCommand(BuildCommand("GETPOSITION", instrument));
     
     // Log to file for debugging
     FILE* log = fopen("C:\\Zorro_2.66\\TcpBridge_debug.log", "a");
     if (log) {
-        fprintf(log, "[MarketPosition] query: %s\n", cmd.c_str());
-        fprintf(log, "[MarketPosition] response: '%s'\n", response.c_str());
-        fflush(log);
-    }
-    
-    // Parse response: POSITION:quantity:avgPrice
-    auto parts = SplitResponse(response, ':');
-    
-    if (log) {
-        fprintf(log, "[MarketPosition] Parsed %zu parts:", parts.size());
-        for (size_t i = 0; i < parts.size(); i++) {
-            fprintf(log, " [%zu]='%s'", i, parts[i].c_str());
+        fprintf(log, "[MarketPosition] query: GETPOSITION:%s\n", instrument);
+        if (BinaryCodec::IsRecord(response)) {
+            fprintf(log, "[MarketPosition] response: binary record (%zu bytes)\n", response.size());
+        } else {
+            fprintf(log, "[MarketPosition] response: '%.*s'\n", (int)response.size(), response.data());
         }
-        fprintf(log, "\n");
+        fflush(log);
     }
     
-    if (parts.size() < 3 || parts[0] != "POSITION") {
+    // Parse response: POSITION:quantity:avgPrice (or binary POSITION record)
+    PositionRecord record;
+    if (!CodecPolicy::DecodePosition(response, record)) {
         if (log) {
-            fprintf(log, "[MarketPosition] Parse FAILED: size=%zu, parts[0]='%s'\n", 
-                parts.size(), parts.size() > 0 ? parts[0].c_str() : "NONE");
+            fprintf(log, "[MarketPosition] Parse FAILED\n");
             fclose(log);
         }
         return 0;
     }
     
-    int position = std::stoi(parts[1]);
-    
     if (log) {
-        fprintf(log, "[MarketPosition] Returning position: %d\n", position);
+        fprintf(log, "[MarketPosition] Returning position: %d\n", record.quantity);
         fclose(log);
     }
     
-    return position;
+    return record.quantity;
 }
 
-double TcpBridge::AvgEntryPrice(const char* instrument, const char* account)
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::AvgEntryPrice(const char* instrument, const char* account)
 {
     if (!instrument) return 0.0;
     
-    std::string cmd = std::string("GETPOSITION:") + instrument;
-    std::string response = SendCommand(cmd);
+    std::string_view response = SendCommand(BuildCommand("GETPOSITION", instrument));
     
-    auto parts = SplitResponse(response, ':');
-    if (parts.size() < 3 || parts[0] != "POSITION") {
+    PositionRecord record;
+    if (!CodecPolicy::DecodePosition(response, record)) {
         return 0.0;
     }
     
-    return std::stod(parts[2]);
+    return record.avgPrice;
 }
 
 //=============================================================================
 // Orders
 //=============================================================================
 
-const char* TcpBridge::NewOrderId()
+template <typename Transport, typename CodecPolicy>
+const char* BasicTcpBridge<Transport, CodecPolicy>::NewOrderId()
 {
-    sprintf_s(m_orderIdBuffer, sizeof(m_orderIdBuffer), "ZORRO_%d", m_nextOrderId++);
+    snprintf(m_orderIdBuffer, sizeof(m_orderIdBuffer), "ZORRO_%d", m_nextOrderId++);
     return m_orderIdBuffer;
 }
 
-int TcpBridge::Command(const char* command, const char* account, const char* instrument,
-                       const char* action, int quantity, const char* orderType,
-                       double limitPrice, double stopPrice, const char* timeInForce,
-                       const char* oco, const char* orderId, const char* strategyId,
-                       const char* strategyName)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::Command(const char* command, const char* account, const char* instrument,
+                                                    const char* action, int quantity, const char* orderType,
+                                                    double limitPrice, double stopPrice, const char* timeInForce,
+                                                    const char* oco, const char* orderId, const char* strategyId,
+                                                    const char* strategyName)
 {
-    // Build command based on type
-    std::ostringstream cmd;
-    
     if (strcmp(command, "PLACE") == 0) {
         // PLACEORDER:BUY/SELL:INSTRUMENT:QUANTITY:ORDERTYPE:LIMITPRICE:STOPPRICE
-        cmd << "PLACEORDER:" << action << ":" << instrument << ":" << quantity 
-            << ":" << orderType << ":" << limitPrice << ":" << stopPrice;
+        // Prices go out in shortest round-trip form, never rounded
+        if (strcmp(action, "BUY") == 0 || strcmp(action, "SELL") == 0) {
+            CommandPrefixes::Kind side = (action[0] == 'B') ? CommandPrefixes::Buy : CommandPrefixes::Sell;
+            m_command.Begin(m_orderPrefixes.Get(side, instrument));
+        } else {
+            m_command.Begin("PLACEORDER").Arg(action).Arg(instrument);
+        }
+        m_command.Arg(quantity).Arg(orderType).Arg(limitPrice).Arg(stopPrice);
+        if (m_command.Overflow()) {
+            return -1;
+        }
         
-        std::string response = SendCommand(cmd.str());
+        std::string_view response = SendCommand(m_command.View());
         
         // Extract NT order ID from response: "ORDER:fa41b14fff514c69b5749bba57471eb8"
-        auto parts = SplitResponse(response, ':');
-        if (parts.size() >= 2 && parts[0] == "ORDER") {
+        Fields<2> parts(response, ':');
+        if (parts.Size() >= 2 && parts[0] == "ORDER") {
             m_lastNtOrderId = parts[1];  // Store the NT GUID
             
             FILE* log = fopen("C:\\Zorro_2.66\\TcpBridge_debug.log", "a");
             if (log) {
-                fprintf(log, "[Command] PLACEORDER response: %s\n", response.c_str());
+                fprintf(log, "[Command] PLACEORDER response: %.*s\n", (int)response.size(), response.data());
                 fprintf(log, "[Command] Extracted NT order ID: %s\n", m_lastNtOrderId.c_str());
                 fclose(log);
             }
@@ -400,77 +563,128 @@ int TcpBridge::Command(const char* command, const char* account, const char* ins
         return -1;  // Failed
     }
     else if (strcmp(command, "CANCEL") == 0) {
-        cmd << "CANCELORDER:" << orderId;
-        std::string response = SendCommand(cmd.str());
-        return (response.find("OK") != std::string::npos) ? 0 : -1;
+        std::string_view response = SendCommand(BuildCommand("CANCELORDER", orderId));
+        return (response.find("OK") != std::string_view::npos) ? 0 : -1;
     }
     
     return -1;
 }
 
-int TcpBridge::Filled(const char* orderId)
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::OrderStatuses(const std::string* orderIds, size_t count,
+                                                           Tokenizer& entries)
 {
-    if (!orderId) return 0;
+    // GETORDERSTATUSES:id1,id2,... -> ORDERSTATUSES:n|id,state,filled,avgFill|...
+    m_commandBuffer.assign("GETORDERSTATUSES:");
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) m_commandBuffer += ',';
+        m_commandBuffer += orderIds[i];
+    }
     
-    std::string cmd = std::string("GETORDERSTATUS:") + orderId;
-    std::string response = SendCommand(cmd);
+    std::string_view response = SendCommand(m_commandBuffer);
     
-    // Parse response: ORDERSTATUS:orderId:state:filled:avgFillPrice
-    auto parts = SplitResponse(response, ':');
-    if (parts.size() < 4 || parts[0] != "ORDERSTATUS") {
-        return 0;
+    Tokenizer list(response, '|');
+    std::string_view header;
+    if (!list.Next(header) || header.compare(0, 14, "ORDERSTATUSES:") != 0) {
+        entries = Tokenizer(response, '|');   // Error text, for the caller
+        return false;
     }
     
-    return std::stoi(parts[3]);  // filled quantity
+    entries = list;
+    return true;
 }
 
-double TcpBridge::AvgFillPrice(const char* orderId)
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::NextOrderStatus(Tokenizer& entries, std::string_view& orderId,
+                                                             OrderStatusRecord& status)
 {
-    if (!orderId) return 0.0;
+    // Malformed entries are skipped; the caller treats those orders as unknown
+    std::string_view entry;
+    while (entries.Next(entry)) {
+        if (TextCodec::DecodeOrderStatusEntry(entry, orderId, status)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Transport, typename CodecPolicy>
+bool BasicTcpBridge<Transport, CodecPolicy>::GetOrderStatus(const char* orderId, OrderStatusRecord& status)
+{
+    if (!orderId) return false;
     
-    std::string cmd = std::string("GETORDERSTATUS:") + orderId;
-    std::string response = SendCommand(cmd);
+    status = OrderStatusRecord();
+    return CodecPolicy::DecodeOrderStatus(SendCommand(BuildCommand("GETORDERSTATUS", orderId)), status);
+}
+
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::Filled(const char* orderId)
+{
+    if (!orderId) return 0;
     
-    // Parse response: ORDERSTATUS:orderId:state:filled:avgFillPrice
-    auto parts = SplitResponse(response, ':');
-    if (parts.size() < 5 || parts[0] != "ORDERSTATUS") {
-        return 0.0;
-    }
+    return ParseFilled(SendCommand(BuildCommand("GETORDERSTATUS", orderId)));
+}
+
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::AvgFillPrice(const char* orderId)
+{
+    if (!orderId) return 0.0;
     
-    return std::stod(parts[4]);  // avg fill price
+    return ParseAvgFillPrice(SendCommand(BuildCommand("GETORDERSTATUS", orderId)));
 }
 
-const char* TcpBridge::OrderStatus(const char* orderId)
+template <typename Transport, typename CodecPolicy>
+const char* BasicTcpBridge<Transport, CodecPolicy>::OrderStatus(const char* orderId)
 {
     if (!orderId) return "Unknown";
     
-    std::string cmd = std::string("GETORDERSTATUS:") + orderId;
-    std::string response = SendCommand(cmd);
-    
-    // Parse response: ORDERSTATUS:orderId:state:filled:avgFillPrice
-    auto parts = SplitResponse(response, ':');
-    if (parts.size() < 3 || parts[0] != "ORDERSTATUS") {
+    return ParseOrderStatus(SendCommand(BuildCommand("GETORDERSTATUS", orderId)));
+}
+
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::ParseFilled(std::string_view response)
+{
+    // ORDERSTATUS:orderId:state:filled:avgFillPrice or binary record
+    OrderStatusRecord status;
+    return CodecPolicy::DecodeOrderStatus(response, status) ? status.filled : 0;
+}
+
+template <typename Transport, typename CodecPolicy>
+double BasicTcpBridge<Transport, CodecPolicy>::ParseAvgFillPrice(std::string_view response)
+{
+    OrderStatusRecord status;
+    return CodecPolicy::DecodeOrderStatus(response, status) ? status.avgFillPrice : 0.0;
+}
+
+template <typename Transport, typename CodecPolicy>
+const char* BasicTcpBridge<Transport, CodecPolicy>::ParseOrderStatus(std::string_view response)
+{
+    OrderStatusRecord status;
+    if (!CodecPolicy::DecodeOrderStatus(response, status)) {
         return "Unknown";
     }
     
     // Store in static buffer (not thread-safe but OK for single-threaded Zorro)
     static char statusBuffer[64];
-    strncpy_s(statusBuffer, sizeof(statusBuffer), parts[2].c_str(), _TRUNCATE);
+    snprintf(statusBuffer, sizeof(statusBuffer), "%s", status.state);
     return statusBuffer;
 }
 
-int TcpBridge::ConfirmOrders(int confirm)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::ConfirmOrders(int confirm)
 {
     // Not applicable for TCP bridge
     return 0;
 }
 
-const char* TcpBridge::Orders(const char* account)
+template <typename Transport, typename CodecPolicy>
+const char* BasicTcpBridge<Transport, CodecPolicy>::Orders(const char* account)
 {
     return "";
 }
 
-const char* TcpBridge::Strategies(const char* account)
+template <typename Transport, typename CodecPolicy>
+const char* BasicTcpBridge<Transport, CodecPolicy>::Strategies(const char* account)
 {
     return "";
 }
@@ -479,29 +693,44 @@ const char* TcpBridge::Strategies(const char* account)
 // Convenience Order Functions
 //=============================================================================
 
-int TcpBridge::PlaceMarketOrder(const char* account, const char* instrument,
-                                 const char* action, int quantity, const char* orderId)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::PlaceMarketOrder(const char* account, const char* instrument,
+                                                             const char* action, int quantity, const char* orderId)
 {
     return Command("PLACE", account, instrument, action, quantity,
                    "MARKET", 0.0, 0.0, "GTC", "", orderId, "", "");
 }
 
-int TcpBridge::PlaceLimitOrder(const char* account, const char* instrument,
-                                const char* action, int quantity, double limitPrice,
-                                const char* orderId)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::PlaceLimitOrder(const char* account, const char* instrument,
+                                                            const char* action, int quantity, double limitPrice,
+                                                            const char* orderId)
 {
     return Command("PLACE", account, instrument, action, quantity,
                    "LIMIT", limitPrice, 0.0, "GTC", "", orderId, "", "");
 }
 
-int TcpBridge::CancelOrder(const char* orderId)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::CancelOrder(const char* orderId)
 {
     return Command("CANCEL", "", "", "", 0, "", 0.0, 0.0, "", "", orderId, "", "");
 }
 
-int TcpBridge::ClosePosition(const char* account, const char* instrument)
+template <typename Transport, typename CodecPolicy>
+int BasicTcpBridge<Transport, CodecPolicy>::ClosePosition(const char* account, const char* instrument)
 {
     // Would need to get current position and place opposite order
     // Not implemented yet
     return -1;
 }
+
+//=============================================================================
+// Instantiations
+//=============================================================================
+
+template class BasicTcpBridge<DefaultTransport, AdaptiveCodec>;   // TcpBridge
+template class BasicTcpBridge<DefaultTransport, TextCodec>;
+template class BasicTcpBridge<DefaultTransport, BinaryCodec>;
+template class BasicTcpBridge<LoopbackTransport, AdaptiveCodec>;
+template class BasicTcpBridge<LoopbackTransport, TextCodec>;
+template class BasicTcpBridge<LoopbackTransport, BinaryCodec>;
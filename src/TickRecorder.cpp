@@ -0,0 +1,392 @@
+// TickRecorder.cpp - Recording of observed quotes to Zorro T1 files
+// Copyright (c) 2025
+
+#include "TickRecorder.h"
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(T1) == 12, "T1 must match Zorro's packed .t1 layout");
+
+static constexpr auto WRITER_SLEEP = std::chrono::milliseconds(5);   // When the queue is empty
+
+// Current UTC time as DATE, millisecond resolution
+static DATE NowDate()
+{
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return (double)ms / (24.0 * 60.0 * 60.0 * 1000.0) + 25569.0;
+}
+
+// UTC day of a DATE as YYYYMMDD (civil-from-days on the Unix day number)
+static int DayOf(DATE time)
+{
+    long long z = (long long)time - 25569 + 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    long long doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    long long d = doy - (153 * mp + 2) / 5 + 1;
+    long long m = mp < 10 ? mp + 3 : mp - 9;
+    long long y = yoe + era * 400 + (m <= 2);
+    return (int)(y * 10000 + m * 100 + d);
+}
+
+// Asset name as a file name: path and wildcard characters dropped, the
+// way Zorro turns "EUR/USD" into "EURUSD"
+static std::string FileName(std::string_view symbol)
+{
+    std::string name;
+    for (char c : symbol) {
+        if (!strchr("/\\:*?\"<>|", c)) {
+            name += c;
+        }
+    }
+    return name;
+}
+
+//=============================================================================
+// Constructor / Destructor
+//=============================================================================
+
+TickRecorder::TickRecorder()
+    : m_queue(new Update[QUEUE_CAPACITY])
+    , m_head(0)
+    , m_tail(0)
+    , m_running(false)
+    , m_dropped(0)
+{
+}
+
+TickRecorder::~TickRecorder()
+{
+    Stop();
+}
+
+//=============================================================================
+// Control
+//=============================================================================
+
+bool TickRecorder::Start(const char* folder)
+{
+    Stop();
+    if (!folder || !*folder) {
+        return false;
+    }
+
+    m_folder = folder;
+    while (!m_folder.empty() && (m_folder.back() == '/' || m_folder.back() == '\\')) {
+        m_folder.pop_back();
+    }
+
+#ifdef _WIN32
+    if (!CreateDirectoryA(m_folder.c_str(), NULL) && GetLastError() != ERROR_ALREADY_EXISTS) {
+        return false;
+    }
+#else
+    struct stat st;
+    if (mkdir(m_folder.c_str(), 0755) != 0 && (stat(m_folder.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))) {
+        return false;
+    }
+#endif
+
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_running.store(true, std::memory_order_release);
+    m_writer = std::thread(&TickRecorder::WriterLoop, this);
+    return true;
+}
+
+void TickRecorder::Stop()
+{
+    m_running.store(false, std::memory_order_release);
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+}
+
+//=============================================================================
+// Producer side (trading thread)
+//=============================================================================
+
+bool TickRecorder::Record(std::string_view symbol, DATE time, double bid, double ask)
+{
+    if (!IsRunning() || symbol.empty() || symbol.size() >= MAX_SYMBOL_LENGTH) {
+        return false;
+    }
+
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) >= QUEUE_CAPACITY) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Update& update = m_queue[head & (QUEUE_CAPACITY - 1)];
+    memcpy(update.symbol, symbol.data(), symbol.size());
+    update.symbol[symbol.size()] = '\0';
+    update.time = time > 0 ? time : NowDate();
+    update.bid = (float)bid;
+    update.ask = (float)ask;
+
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+//=============================================================================
+// Writer thread
+//=============================================================================
+
+void TickRecorder::WriterLoop()
+{
+    while (m_running.load(std::memory_order_acquire)) {
+        if (!Drain()) {
+            FinalizeIdle();
+            std::this_thread::sleep_for(WRITER_SLEEP);
+        }
+    }
+
+    // Updates queued before Stop() still go to disk
+    Drain();
+    for (auto& entry : m_files) {
+        Finalize(entry.second);
+    }
+    m_files.clear();
+}
+
+// Append everything queued so far. Returns false if the queue was empty.
+bool TickRecorder::Drain()
+{
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t head = m_head.load(std::memory_order_acquire);
+    if (tail == head) {
+        return false;
+    }
+
+    for (; tail != head; tail++) {
+        Append(m_queue[tail & (QUEUE_CAPACITY - 1)]);
+    }
+    m_tail.store(tail, std::memory_order_release);
+    return true;
+}
+
+void TickRecorder::Append(const Update& update)
+{
+    std::string_view symbol(update.symbol);
+    auto it = m_files.find(symbol);
+    if (it == m_files.end()) {
+        it = m_files.emplace(std::string(symbol), TickFile()).first;
+    }
+    TickFile& file = it->second;
+    file.used = std::chrono::steady_clock::now();
+
+    int day = DayOf(update.time);
+    if (file.ticks && file.day != day) {
+        Finalize(file);    // New UTC day, new file
+    }
+    if (!file.ticks && !OpenFile(file, symbol, day)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Ticks of one file stay in time order, even if sources interleave
+    DATE time = std::max(update.time, file.lastTime);
+
+    T1 sides[2];
+    int count = 0;
+    if (update.ask > 0 && update.ask != file.lastAsk) {
+        sides[count++] = { time, update.ask };
+        file.lastAsk = update.ask;
+    }
+    if (update.bid > 0 && update.bid != file.lastBid) {
+        sides[count++] = { time, -update.bid };
+        file.lastBid = update.bid;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    if (file.count + count > file.capacity && !Grow(file, file.capacity * 2)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    memcpy(file.ticks + file.count, sides, count * sizeof(T1));
+    file.count += count;
+    file.lastTime = time;
+}
+
+// Close the files of assets that stopped updating, so they are complete
+// on disk while the session goes on
+void TickRecorder::FinalizeIdle()
+{
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = m_files.begin(); it != m_files.end();) {
+        if (now - it->second.used > std::chrono::seconds(IDLE_FINALIZE_SECONDS)) {
+            Finalize(it->second);
+            it = m_files.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+//=============================================================================
+// Mapped files
+//=============================================================================
+
+bool TickRecorder::OpenFile(TickFile& file, std::string_view symbol, int day)
+{
+    std::string path = m_folder + "/" + FileName(symbol) + "_" + std::to_string(day) + ".t1";
+
+    size_t existing = 0;
+#ifdef _WIN32
+    file.file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                            OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER size;
+    if (file.file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file.file, &size)) {
+        Unmap(file);
+        return false;
+    }
+    existing = (size_t)size.QuadPart / sizeof(T1);
+#else
+    file.fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat st;
+    if (file.fd < 0 || fstat(file.fd, &st) != 0) {
+        Unmap(file);
+        return false;
+    }
+    existing = (size_t)st.st_size / sizeof(T1);
+#endif
+
+    size_t capacity = INITIAL_FILE_TICKS;
+    while (capacity < existing + 2) {
+        capacity *= 2;
+    }
+    if (!Map(file, capacity)) {
+        Unmap(file);
+        return false;
+    }
+
+    // Reopened within the day: a finalized file is newest first, one left
+    // by a crash is oldest first with a zero-filled tail. Continue both.
+    file.count = existing;
+    while (file.count > 0 && file.ticks[file.count - 1].time == 0) {
+        file.count--;
+    }
+    if (file.count > 1 && file.ticks[0].time > file.ticks[file.count - 1].time) {
+        std::reverse(file.ticks, file.ticks + file.count);
+    }
+
+    file.day = day;
+    file.lastTime = file.count > 0 ? file.ticks[file.count - 1].time : 0;
+    file.lastBid = 0;
+    file.lastAsk = 0;
+    return true;
+}
+
+bool TickRecorder::Grow(TickFile& file, size_t capacity)
+{
+    // The ticks are in the file; remapping a larger view keeps them
+#ifdef _WIN32
+    UnmapViewOfFile(file.ticks);
+    CloseHandle(file.mapping);
+    file.mapping = NULL;
+#else
+    munmap(file.ticks, file.capacity * sizeof(T1));
+#endif
+    file.ticks = nullptr;
+    if (!Map(file, capacity)) {
+        Unmap(file);    // Closed unfinalized; repaired when reopened
+        return false;
+    }
+    return true;
+}
+
+// Extend the file to 'capacity' ticks and map all of it
+bool TickRecorder::Map(TickFile& file, size_t capacity)
+{
+    uint64_t bytes = (uint64_t)capacity * sizeof(T1);
+
+#ifdef _WIN32
+    // A mapping larger than the file extends it (zero-filled)
+    file.mapping = CreateFileMappingA(file.file, NULL, PAGE_READWRITE,
+                                      (DWORD)(bytes >> 32), (DWORD)bytes, NULL);
+    void* base = file.mapping ? MapViewOfFile(file.mapping, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)bytes) : NULL;
+    if (!base) {
+        return false;
+    }
+#else
+    if (ftruncate(file.fd, (off_t)bytes) != 0) {
+        return false;
+    }
+    void* base = mmap(nullptr, (size_t)bytes, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+#endif
+
+    file.ticks = (T1*)base;
+    file.capacity = capacity;
+    return true;
+}
+
+// Release mapping and file without finalizing (open failures)
+void TickRecorder::Unmap(TickFile& file)
+{
+#ifdef _WIN32
+    if (file.ticks) UnmapViewOfFile(file.ticks);
+    if (file.mapping) CloseHandle(file.mapping);
+    if (file.file != INVALID_HANDLE_VALUE) CloseHandle(file.file);
+    file.mapping = NULL;
+    file.file = INVALID_HANDLE_VALUE;
+#else
+    if (file.ticks) munmap(file.ticks, file.capacity * sizeof(T1));
+    if (file.fd >= 0) close(file.fd);
+    file.fd = -1;
+#endif
+    file.ticks = nullptr;
+    file.count = 0;
+    file.capacity = 0;
+}
+
+// Reverse to newest first, cut the preallocated tail off, close
+void TickRecorder::Finalize(TickFile& file)
+{
+    if (!file.ticks) {
+        return;
+    }
+
+    std::reverse(file.ticks, file.ticks + file.count);
+    uint64_t bytes = (uint64_t)file.count * sizeof(T1);
+
+#ifdef _WIN32
+    UnmapViewOfFile(file.ticks);
+    CloseHandle(file.mapping);
+    file.ticks = nullptr;
+    file.mapping = NULL;
+
+    LARGE_INTEGER end;
+    end.QuadPart = (LONGLONG)bytes;
+    if (SetFilePointerEx(file.file, end, NULL, FILE_BEGIN)) {
+        SetEndOfFile(file.file);
+    }
+#else
+    munmap(file.ticks, file.capacity * sizeof(T1));
+    file.ticks = nullptr;
+    if (ftruncate(file.fd, (off_t)bytes) != 0) {
+        // Left at capacity; the zero tail is trimmed when the file is reopened
+    }
+#endif
+
+    Unmap(file);
+    file.day = 0;
+    file.lastTime = 0;
+    file.lastBid = 0;
+    file.lastAsk = 0;
+}
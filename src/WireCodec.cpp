@@ -0,0 +1,335 @@
+// WireCodec.cpp - Reply codecs for the NinjaTrader bridge protocol
+// Copyright (c) 2025
+
+#include "WireCodec.h"
+#include "DelimiterScan.h"
+#include <cstdio>
+#include <cstring>
+
+//=============================================================================
+// TextCodec
+//=============================================================================
+//
+// The layouts are the schemas in WireCodec.h: fields are views into the
+// reply and numbers are parsed in place in a single pass. A missing
+// required field or a malformed number rejects the reply.
+
+bool TextCodec::DecodeQuote(std::string_view response, Quote& quote)
+{
+    return QuoteSchema::Parse(response, quote);
+}
+
+bool TextCodec::DecodeAccount(std::string_view response, AccountRecord& account)
+{
+    return AccountSchema::Parse(response, account);
+}
+
+bool TextCodec::DecodeOrderStatus(std::string_view response, OrderStatusRecord& status)
+{
+    return OrderStatusSchema::Parse(response, status);
+}
+
+bool TextCodec::DecodeQuoteEntry(std::string_view entry, std::string_view& instrument, Quote& quote)
+{
+    QuoteEntry parsed;
+    if (!QuoteEntrySchema::Parse(entry, parsed) || parsed.instrument.empty()) {
+        return false;
+    }
+
+    instrument = parsed.instrument;
+    quote = parsed;
+    return true;
+}
+
+bool TextCodec::DecodeOrderStatusEntry(std::string_view entry, std::string_view& orderId,
+                                       OrderStatusRecord& status)
+{
+    OrderStatusEntry parsed;
+    if (!OrderStatusEntrySchema::Parse(entry, parsed) || parsed.orderId.empty()) {
+        return false;
+    }
+
+    orderId = parsed.orderId;
+    status = parsed;
+    return true;
+}
+
+bool TextCodec::DecodePositionEntry(std::string_view entry, std::string_view& instrument,
+                                    PositionRecord& position)
+{
+    PositionEntry parsed;
+    if (!PositionEntrySchema::Parse(entry, parsed) || parsed.instrument.empty()) {
+        return false;
+    }
+
+    instrument = parsed.instrument;
+    position = parsed;
+    return true;
+}
+
+bool TextCodec::DecodePosition(std::string_view response, PositionRecord& position)
+{
+    return PositionSchema::Parse(response, position);
+}
+
+//=============================================================================
+// TextCodec - HISTORY
+//=============================================================================
+//
+// HISTORY:{n}|time,o,h,l,c,v|... can be megabytes long. The offsets of all
+// '|' and ',' come from ScanDelimiters() in batches, and each field between
+// two of them is parsed straight into the caller's T6. The rules are those
+// of HistoryBarSchema: a bar needs all six fields (extra ones are ignored),
+// a malformed bar is dropped and empty bars are skipped.
+
+namespace {
+
+constexpr size_t HISTORY_SCAN_BATCH = 1024;     // Delimiter offsets per ScanDelimiters() call
+
+class HistoryBarDecoder
+{
+public:
+    HistoryBarDecoder(const char* text, size_t firstBar, DATE tStart, DATE tEnd,
+                      T6* ticks, int nTicks, HistoryResult& result)
+        : m_text(text)
+        , m_fieldStart(firstBar)
+        , m_field(0)
+        , m_valid(true)
+        , m_tStart(tStart)
+        , m_tEnd(tEnd)
+        , m_ticks(ticks)
+        , m_nTicks(nTicks)
+        , m_result(result)
+    {
+    }
+
+    // The field ending at offset 'end' (a delimiter or the end of the
+    // reply); 'barEnd' if it is the last field of its bar. Returns false
+    // once no more bars are wanted (buffer full or past tEnd).
+    bool EndField(size_t end, bool barEnd)
+    {
+        size_t start = m_fieldStart;
+        m_fieldStart = end + 1;
+
+        if (m_field < 6 && m_valid) {
+            std::string_view value(m_text + start, end - start);
+            T6& tick = m_ticks[m_result.loaded];
+            if (m_field == 0) {
+                tick = T6();
+                m_valid = (ParseDouble(value, tick.time) == ParseStatus::Ok);
+            } else {
+                m_valid = (ParseFloat(value, tick.*PRICE_FIELDS[m_field - 1]) == ParseStatus::Ok);
+            }
+        }
+        if (!barEnd) {
+            m_field++;
+            return true;
+        }
+
+        // Short, malformed and empty bars ("||") are dropped; the slot is
+        // reused by the next bar
+        bool complete = m_valid && m_field >= 5;
+        m_field = 0;
+        m_valid = true;
+        return complete ? AcceptBar() : true;
+    }
+
+private:
+    static constexpr float T6::* PRICE_FIELDS[5] = {
+        &T6::fOpen, &T6::fHigh, &T6::fLow, &T6::fClose, &T6::fVol
+    };
+
+    const char* m_text;
+    size_t m_fieldStart;      // Offset of the field being read
+    int m_field;              // Its index within the bar
+    bool m_valid;             // All fields of the bar so far parsed
+    DATE m_tStart;
+    DATE m_tEnd;
+    T6* m_ticks;
+    int m_nTicks;
+    HistoryResult& m_result;
+
+    // Filter a complete bar by time, exactly like the binary decoder
+    bool AcceptBar()
+    {
+        DATE barTime = m_ticks[m_result.loaded].time;
+        if (barTime < m_tStart) {
+            m_result.skipped++;
+            return true;
+        }
+        if (barTime > m_tEnd) {
+            m_result.endReached = true;
+            return false;   // Bars are in time order
+        }
+        return ++m_result.loaded < m_nTicks;
+    }
+};
+
+} // namespace
+
+bool TextCodec::DecodeHistory(std::string_view response, DATE tStart, DATE tEnd,
+                              T6* ticks, int nTicks, HistoryResult& result)
+{
+    result = HistoryResult();
+
+    std::string_view bars;
+    if (!DecodeHistoryHeader(response, result.barCount, bars)) {
+        return false;
+    }
+    DecodeHistoryBars(bars, tStart, tEnd, ticks, nTicks, result);
+    return true;
+}
+
+bool TextCodec::DecodeHistoryHeader(std::string_view response, int& barCount, std::string_view& bars)
+{
+    size_t headerEnd = response.find('|');
+    std::string_view header = response.substr(0, headerEnd);
+    if (header.substr(0, 8) != "HISTORY:" || ParseInt(header.substr(8), barCount) != ParseStatus::Ok) {
+        return false;
+    }
+
+    bars = (headerEnd == std::string_view::npos) ? std::string_view() : response.substr(headerEnd + 1);
+    return true;
+}
+
+void TextCodec::DecodeHistoryBars(std::string_view bars, DATE tStart, DATE tEnd,
+                                  T6* ticks, int nTicks, HistoryResult& result)
+{
+    result.loaded = 0;
+    result.skipped = 0;
+    result.endReached = false;
+    if (bars.empty() || nTicks <= 0) {
+        return;
+    }
+
+    HistoryBarDecoder decoder(bars.data(), 0, tStart, tEnd, ticks, nTicks, result);
+    uint32_t positions[HISTORY_SCAN_BATCH];
+    size_t next = 0;
+    while (next < bars.size()) {
+        size_t count = ScanDelimiters(bars, next, '|', ',', positions, HISTORY_SCAN_BATCH, next);
+        for (size_t i = 0; i < count; i++) {
+            size_t at = positions[i];
+            if (!decoder.EndField(at, bars[at] == '|')) {
+                return;
+            }
+        }
+    }
+    decoder.EndField(bars.size(), true);   // Last bar has no trailing '|'
+}
+
+//=============================================================================
+// BinaryCodec
+//=============================================================================
+//
+// Fields are read with memcpy: records are unaligned and the layouts are
+// little-endian, which matches every target Zorro runs on (x86/x64).
+
+template <typename T>
+static T ReadField(const char*& p)
+{
+    T value;
+    memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return value;
+}
+
+static bool HasRecord(std::string_view response, unsigned char tag, size_t size)
+{
+    return response.size() >= size && (unsigned char)response[0] == tag;
+}
+
+bool BinaryCodec::DecodeQuote(std::string_view response, Quote& quote)
+{
+    if (!HasRecord(response, TAG_QUOTE, QUOTE_SIZE)) {
+        return false;
+    }
+
+    const char* p = response.data() + 1;
+    quote.last = ReadField<double>(p);
+    quote.bid = ReadField<double>(p);
+    quote.ask = ReadField<double>(p);
+    quote.volume = ReadField<double>(p);
+    return true;
+}
+
+bool BinaryCodec::DecodeAccount(std::string_view response, AccountRecord& account)
+{
+    if (!HasRecord(response, TAG_ACCOUNT, ACCOUNT_SIZE)) {
+        return false;
+    }
+
+    const char* p = response.data() + 1;
+    account.cashValue = ReadField<double>(p);
+    account.buyingPower = ReadField<double>(p);
+    account.realizedPnL = ReadField<double>(p);
+    account.unrealizedPnL = ReadField<double>(p);
+    return true;
+}
+
+bool BinaryCodec::DecodeOrderStatus(std::string_view response, OrderStatusRecord& status)
+{
+    if (!HasRecord(response, TAG_ORDERSTATUS, ORDERSTATUS_SIZE)) {
+        return false;
+    }
+
+    const char* p = response.data() + 1;
+    memcpy(status.state, p, sizeof(status.state));
+    status.state[sizeof(status.state) - 1] = '\0';  // Zero padded, but be safe
+    p += sizeof(status.state);
+    status.filled = ReadField<int32_t>(p);
+    status.avgFillPrice = ReadField<double>(p);
+    return true;
+}
+
+bool BinaryCodec::DecodePosition(std::string_view response, PositionRecord& position)
+{
+    if (!HasRecord(response, TAG_POSITION, POSITION_SIZE)) {
+        return false;
+    }
+
+    const char* p = response.data() + 1;
+    position.quantity = ReadField<int32_t>(p);
+    position.avgPrice = ReadField<double>(p);
+    return true;
+}
+
+bool BinaryCodec::DecodeHistory(std::string_view response, DATE tStart, DATE tEnd,
+                                T6* ticks, int nTicks, HistoryResult& result)
+{
+    result = HistoryResult();
+    if (!HasRecord(response, TAG_HISTORY, HISTORY_HEADER)) {
+        return false;
+    }
+
+    const char* p = response.data() + 1;
+    int32_t count = ReadField<int32_t>(p);
+    if (count < 0 || (response.size() - HISTORY_HEADER) / HISTORY_BAR_SIZE < (size_t)count) {
+        return false;  // Truncated record
+    }
+    result.barCount = count;
+
+    for (int32_t i = 0; i < count && result.loaded < nTicks; i++) {
+        double barTime = ReadField<double>(p);
+
+        // Skip bars outside the requested range (bars are in time order)
+        if (barTime < tStart) {
+            result.skipped++;
+            p += HISTORY_BAR_SIZE - sizeof(double);
+            continue;
+        }
+        if (barTime > tEnd) {
+            result.endReached = true;
+            break;
+        }
+
+        T6& tick = ticks[result.loaded++];
+        tick.time = barTime;
+        tick.fOpen = ReadField<float>(p);
+        tick.fHigh = ReadField<float>(p);
+        tick.fLow = ReadField<float>(p);
+        tick.fClose = ReadField<float>(p);
+        tick.fVol = ReadField<float>(p);
+    }
+
+    return true;
+}
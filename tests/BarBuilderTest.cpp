@@ -0,0 +1,242 @@
+// BarBuilderTest.cpp - Local bars from the pushed quotes
+// Copyright (c) 2025
+//
+// BarBuilder against hand-placed quotes - the discarded partial first bar,
+// the covered window and its reset after a gap, the bounds of Copy(), the
+// merge behind AddOn bars - and against a plain reference aggregation of
+// 4200 quotes in two periods.
+
+#include "BarBuilder.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+static const char SYMBOL[] = "MES 03-26";
+static const DATE DAY = 46000.0;                 // Midnight UTC, OLE date
+static const double SECONDS_PER_DAY = 86400.0;
+
+// Time 'seconds' after DAY
+static DATE At(double seconds) { return DAY + seconds / SECONDS_PER_DAY; }
+
+static bool SameTime(DATE a, DATE b) { return std::fabs(a - b) * SECONDS_PER_DAY < 0.001; }
+
+// One quote per second from 'from' to 'to' (exclusive), price rising by 0.25
+static void Feed(BarBuilder& bars, int from, int to, double price = 5000.0)
+{
+    for (int s = from; s < to; s++) {
+        bars.Update(SYMBOL, At(s), price + (s - from) * 0.25, 1000.0 + s);
+    }
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+// Quotes from 0:30 on: the 0:00-1:00 bar is partial and never served, the
+// 1:00-2:00 bar is the first complete one
+static void TestPartialFirstBar()
+{
+    BarBuilder bars;
+    Feed(bars, 30, 60);
+    T6 ticks[8];
+    CHECK(bars.CoveredFrom(SYMBOL, 1, At(59)) == 0);
+    CHECK(bars.Copy(SYMBOL, 1, 0, At(3600), At(600), ticks, 8) == 0);
+
+    // 1:00-2:00 is being built; complete once 'now' is past its end
+    Feed(bars, 60, 90, 6000.0);
+    CHECK(bars.CoveredFrom(SYMBOL, 1, At(90)) == 0);
+    CHECK(bars.Copy(SYMBOL, 1, 0, At(3600), At(90), ticks, 8) == 0);
+    CHECK(SameTime(bars.CoveredFrom(SYMBOL, 1, At(120)), At(120)));
+    CHECK(bars.Copy(SYMBOL, 1, 0, At(3600), At(120), ticks, 8) == 1);
+    CHECK(SameTime(ticks[0].time, At(120)));
+    CHECK(ticks[0].fOpen == 6000.0f);
+    CHECK(ticks[0].fHigh == 6007.25f);
+    CHECK(ticks[0].fLow == 6000.0f);
+    CHECK(ticks[0].fClose == 6007.25f);
+    CHECK(ticks[0].fVol == 30.0f);     // One per quote, the 1:00 one included
+
+    // The next bar closes it for good
+    Feed(bars, 120, 130);
+    CHECK(SameTime(bars.CoveredFrom(SYMBOL, 1, At(130)), At(120)));
+    CHECK(bars.Copy(SYMBOL, 1, 0, At(3600), At(130), ticks, 8) == 1);
+
+    // Other assets and periods have no bars
+    CHECK(bars.CoveredFrom("ES 03-26", 1, At(130)) == 0);
+    CHECK(bars.CoveredFrom(SYMBOL, 5, At(130)) == 0);
+    CHECK(bars.Copy(SYMBOL, 5, 0, At(3600), At(130), ticks, 8) == 0);
+}
+
+// Coverage lapses after MAX_GAP_SECONDS without quotes, and a quote after
+// such a gap restarts the series with a new partial bar
+static void TestGapReset()
+{
+    const int GAP = BarBuilder::MAX_GAP_SECONDS;
+    BarBuilder bars;
+    Feed(bars, 30, 300);
+    CHECK(SameTime(bars.CoveredFrom(SYMBOL, 1, At(299 + GAP)), At(120)));
+    CHECK(bars.CoveredFrom(SYMBOL, 1, At(300 + GAP)) == 0);
+
+    // Resumes at 7:10 - 7:00-8:00 is partial, 8:00-9:00 the first complete bar
+    Feed(bars, 430, 600);
+    T6 ticks[16];
+    CHECK(SameTime(bars.CoveredFrom(SYMBOL, 1, At(600)), At(540)));
+    int count = bars.Copy(SYMBOL, 1, 0, At(3600), At(600), ticks, 16);
+    CHECK(count == 2);
+    CHECK(SameTime(ticks[0].time, At(540)));
+    CHECK(SameTime(ticks[count - 1].time, At(600)));
+
+    // A gap just inside the limit keeps the series
+    bars.Update(SYMBOL, At(599 + GAP), 5100.0, 5000.0);
+    CHECK(SameTime(bars.CoveredFrom(SYMBOL, 1, At(599 + GAP)), At(540)));
+
+    // Clear() drops the bars, the periods stay
+    bars.Clear();
+    CHECK(bars.CoveredFrom(SYMBOL, 1, At(599 + GAP)) == 0);
+    CHECK(bars.HasPeriod(1));
+}
+
+// tStart and tEnd are inclusive, bars come oldest first, at most nTicks
+static void TestCopyBounds()
+{
+    BarBuilder bars;
+    Feed(bars, 30, 12 * 60 + 10);    // Complete bars ending 2:00 .. 12:00
+
+    T6 ticks[16];
+    CHECK(bars.Copy(SYMBOL, 1, 0, At(3600), At(12 * 60 + 10), ticks, 16) == 11);
+    for (int i = 0; i < 11; i++) {
+        CHECK(SameTime(ticks[i].time, At((i + 2) * 60)));
+    }
+
+    CHECK(bars.Copy(SYMBOL, 1, At(300), At(420), At(800), ticks, 16) == 3);
+    CHECK(SameTime(ticks[0].time, At(300)));
+    CHECK(SameTime(ticks[2].time, At(420)));
+
+    CHECK(bars.Copy(SYMBOL, 1, At(300.5), At(419.5), At(800), ticks, 16) == 1);
+    CHECK(SameTime(ticks[0].time, At(360)));
+
+    CHECK(bars.Copy(SYMBOL, 1, 0, At(3600), At(800), ticks, 4) == 4);
+    CHECK(SameTime(ticks[3].time, At(300)));
+
+    // The current bar (12:00-13:00) only once 'now' is past its end
+    CHECK(bars.Copy(SYMBOL, 1, At(780), At(3600), At(779), ticks, 16) == 0);
+    CHECK(bars.Copy(SYMBOL, 1, At(780), At(3600), At(780), ticks, 16) == 1);
+
+    CHECK(bars.Copy(SYMBOL, 1, At(800), At(3600), At(900), ticks, 16) == 0);
+    CHECK(bars.Copy(SYMBOL, 1, 0, At(100), At(900), ticks, 16) == 0);
+    CHECK(bars.Copy(SYMBOL, 1, 0, At(3600), At(900), ticks, 0) == 0);
+}
+
+// Local bars behind fetched AddOn bars: a bar both have is the AddOn's,
+// even if its time is a rounding error off the local one
+static void TestMergeDedupe()
+{
+    BarBuilder bars;
+    Feed(bars, 30, 10 * 60 + 10);    // Local bars ending 2:00 .. 10:00
+
+    // AddOn bars ending 1:00 .. 4:00, the last one slightly early
+    T6 ticks[16] = {};
+    int loaded = 0;
+    for (int s = 60; s <= 240; s += 60) {
+        ticks[loaded].time = At(s);
+        ticks[loaded].fClose = -1.0f;   // Marks AddOn bars
+        loaded++;
+    }
+    ticks[loaded - 1].time -= 1e-9;
+
+    int count = bars.Merge(SYMBOL, 1, At(60), At(3600), At(610), ticks, loaded, 16);
+    CHECK(count == 10);                             // 4 fetched + 5:00 .. 10:00
+    CHECK(ticks[3].fClose == -1.0f);
+    for (int i = 4; i < count; i++) {
+        CHECK(ticks[i].fClose > 0);
+        CHECK(SameTime(ticks[i].time, At((i + 1) * 60)));
+    }
+
+    // Buffer limits, and no fetched bars at all
+    T6 one[4] = {};
+    one[0].time = At(60);
+    CHECK(bars.Merge(SYMBOL, 1, At(60), At(3600), At(610), one, 1, 1) == 1);
+    CHECK(bars.Merge(SYMBOL, 1, At(60), At(3600), At(610), one, 1, 3) == 3);
+    CHECK(SameTime(one[1].time, At(120)));
+    CHECK(bars.Merge(SYMBOL, 1, At(300), At(3600), At(610), one, 0, 4) == 4);
+    CHECK(SameTime(one[0].time, At(300)));
+}
+
+// 4200 quotes one to three seconds apart, against a direct aggregation by
+// bucket: every complete bar after the partial first one, same OHLCV
+static void TestMatchesReference()
+{
+    BarBuilder bars;
+    CHECK(bars.AddPeriod(5));
+
+    struct Tick { int seconds; float price; double volume; };
+    std::vector<Tick> quotes;
+    unsigned seed = 12345;
+    int seconds = 17;
+    double price = 5000.0, volume = 100000.0;
+    for (int i = 0; i < 4200; i++) {
+        seed = seed * 1103515245u + 12345u;
+        seconds += 1 + (int)((seed >> 16) % 3);
+        price += ((int)((seed >> 8) % 9) - 4) * 0.25;
+        volume += (seed >> 4) % 20;
+        quotes.push_back({ seconds, (float)price, volume });
+        bars.Update(SYMBOL, At(seconds), price, volume);
+    }
+    DATE now = At(seconds);        // The last bucket is still being built
+
+    for (int minutes : { 1, 5 }) {
+        int period = minutes * 60;
+        std::map<int, T6> expected;    // Bucket -> bar
+        double lastVolume = 0;
+        for (const Tick& q : quotes) {
+            float traded = lastVolume > 0 ? (float)(q.volume - lastVolume) : 0.0f;
+            lastVolume = q.volume;
+            int bucket = q.seconds / period;
+            auto it = expected.find(bucket);
+            if (it == expected.end()) {
+                T6 bar = {};
+                bar.time = At((bucket + 1) * period);
+                bar.fOpen = bar.fHigh = bar.fLow = bar.fClose = q.price;
+                bar.fVol = traded;
+                expected.emplace(bucket, bar);
+                continue;
+            }
+            T6& bar = it->second;
+            bar.fHigh = std::max(bar.fHigh, q.price);
+            bar.fLow = std::min(bar.fLow, q.price);
+            bar.fClose = q.price;
+            bar.fVol += traded;
+        }
+        expected.erase(expected.begin());          // Partial first bar
+        expected.erase(std::prev(expected.end())); // Current bar
+
+        std::vector<T6> ticks(expected.size() + 8);
+        int count = bars.Copy(SYMBOL, minutes, 0, At(86400), now, ticks.data(), (int)ticks.size());
+        CHECK(count == (int)expected.size());
+        int i = 0;
+        for (const auto& entry : expected) {
+            if (i >= count) break;
+            const T6& bar = entry.second;
+            const T6& got = ticks[i++];
+            CHECK(SameTime(got.time, bar.time));
+            CHECK(got.fOpen == bar.fOpen);
+            CHECK(got.fHigh == bar.fHigh);
+            CHECK(got.fLow == bar.fLow);
+            CHECK(got.fClose == bar.fClose);
+            CHECK(got.fVol == bar.fVol);
+        }
+        CHECK(SameTime(bars.CoveredFrom(SYMBOL, minutes, now), expected.begin()->second.time));
+    }
+}
+
+int main()
+{
+    RUN_TEST(TestPartialFirstBar);
+    RUN_TEST(TestGapReset);
+    RUN_TEST(TestCopyBounds);
+    RUN_TEST(TestMergeDedupe);
+    RUN_TEST(TestMatchesReference);
+    return TestResult();
+}
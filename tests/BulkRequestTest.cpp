@@ -0,0 +1,204 @@
+// BulkRequestTest.cpp - Bulk list requests and how they fail
+// Copyright (c) 2025
+//
+// The plugin gives up on a bulk command (GETPRICES, GETORDERSTATUSES,
+// GETPOSITIONS) only for an AddOn that doesn't know it; after a timeout it tries again
+// next cycle. So a failed request must leave its reply to the caller, and a
+// timeout must stay distinguishable from "ERROR:Unknown command".
+
+#include "TcpBridge.h"
+#include "TestHarness.h"
+
+#include <string>
+
+using Bridge = BasicTcpBridge<LoopbackTransport, TextCodec>;
+
+// Current AddOn: knows the bulk commands
+static std::string Answer(std::string_view request)
+{
+    if (request == "PING") return "PONG";
+    if (request.compare(0, 17, "GETORDERSTATUSES:") == 0) {
+        return "ORDERSTATUSES:2|A1,Filled,2,5012.25|B2,Working,0,0";
+    }
+    if (request == "GETPOSITIONS") return "POSITIONS:1|MES 03-26,-2,5011.875";
+    if (request.compare(0, 10, "GETPRICES:") == 0) {
+        return "PRICES:2|MES 03-26,5012.25,5012,5012.5,123456|MNQ 03-26,21000.5,21000.25,21000.75,8000";
+    }
+    return "ERROR:Unknown command: " + std::string(request.substr(0, request.find(':')));
+}
+
+// AddOn from before the bulk commands
+static std::string OldAnswer(std::string_view request)
+{
+    if (request == "PING") return "PONG";
+    return "ERROR:Unknown command: " + std::string(request.substr(0, request.find(':')));
+}
+
+static Bridge::Timeouts ShortTimeouts()
+{
+    Bridge::Timeouts timeouts;
+    timeouts.quote = 100;
+    timeouts.data = 100;
+    return timeouts;
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+static void TestOrderStatuses()
+{
+    LoopbackServer server(9601, Answer);
+    Bridge bridge;
+    CHECK(bridge.Connect("127.0.0.1", 9601));
+
+    const std::string ids[] = { "A1", "B2" };
+    Tokenizer entries(std::string_view(), '|');
+    CHECK(bridge.OrderStatuses(ids, 2, entries));
+
+    std::string_view id;
+    OrderStatusRecord status;
+    CHECK(Bridge::NextOrderStatus(entries, id, status));
+    CHECK(id == "A1" && std::string(status.state) == "Filled" && status.filled == 2);
+    CHECK(Bridge::NextOrderStatus(entries, id, status));
+    CHECK(id == "B2" && status.filled == 0);
+    CHECK(!Bridge::NextOrderStatus(entries, id, status));
+}
+
+static void TestOrderStatusesUnknown()
+{
+    LoopbackServer server(9602, OldAnswer);
+    Bridge bridge;
+    CHECK(bridge.Connect("127.0.0.1", 9602));
+
+    const std::string ids[] = { "A1" };
+    Tokenizer entries(std::string_view(), '|');
+    CHECK(!bridge.OrderStatuses(ids, 1, entries));
+    CHECK(Bridge::IsUnknownCommand(entries.Rest()));
+    CHECK(!Bridge::IsTimeout(entries.Rest()));
+}
+
+static void TestOrderStatusesTimeout()
+{
+    LoopbackServer server(9603, Answer);
+    server.SetReplyDelay("GETORDERSTATUSES:SLOW", 300);
+    Bridge bridge;
+    bridge.SetTimeouts(ShortTimeouts());
+    CHECK(bridge.Connect("127.0.0.1", 9603));
+
+    const std::string slow[] = { "SLOW" };
+    Tokenizer entries(std::string_view(), '|');
+    CHECK(!bridge.OrderStatuses(slow, 1, entries));
+    CHECK(Bridge::IsTimeout(entries.Rest()));
+    CHECK(!Bridge::IsUnknownCommand(entries.Rest()));
+
+    // The next cycle gets its answer once the late one is in and dropped
+    const std::string ids[] = { "A1" };
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    CHECK(bridge.OrderStatuses(ids, 1, entries));
+}
+
+static void TestPositions()
+{
+    LoopbackServer server(9604, Answer);
+    Bridge bridge;
+    CHECK(bridge.Connect("127.0.0.1", 9604));
+
+    Tokenizer entries(std::string_view(), '|');
+    CHECK(bridge.Positions(entries));
+    std::string_view instrument;
+    PositionRecord position;
+    CHECK(Bridge::NextPosition(entries, instrument, position));
+    CHECK(instrument == "MES 03-26" && position.quantity == -2 && position.avgPrice == 5011.875);
+    CHECK(!Bridge::NextPosition(entries, instrument, position));
+}
+
+static void TestPositionsUnknown()
+{
+    LoopbackServer server(9605, OldAnswer);
+    Bridge bridge;
+    CHECK(bridge.Connect("127.0.0.1", 9605));
+
+    Tokenizer entries(std::string_view(), '|');
+    CHECK(!bridge.Positions(entries));
+    CHECK(Bridge::IsUnknownCommand(entries.Rest()));
+}
+
+static void TestPositionsTimeout()
+{
+    LoopbackServer server(9606, Answer);
+    server.SetReplyDelay("GETPOSITIONS", 300);
+    Bridge bridge;
+    bridge.SetTimeouts(ShortTimeouts());
+    CHECK(bridge.Connect("127.0.0.1", 9606));
+
+    Tokenizer entries(std::string_view(), '|');
+    CHECK(!bridge.Positions(entries));
+    CHECK(Bridge::IsTimeout(entries.Rest()));
+    CHECK(!Bridge::IsUnknownCommand(entries.Rest()));
+}
+
+static void TestQuotes()
+{
+    LoopbackServer server(9607, Answer);
+    Bridge bridge;
+    CHECK(bridge.Connect("127.0.0.1", 9607));
+
+    const std::string symbols[] = { "MES 03-26", "MNQ 03-26" };
+    Tokenizer entries(std::string_view(), '|');
+    CHECK(bridge.Quotes(symbols, 2, entries));
+
+    std::string_view instrument;
+    Quote quote;
+    CHECK(Bridge::NextQuote(entries, instrument, quote));
+    CHECK(instrument == "MES 03-26" && quote.last == 5012.25 && quote.volume == 123456);
+    CHECK(Bridge::NextQuote(entries, instrument, quote));
+    CHECK(instrument == "MNQ 03-26" && quote.ask == 21000.75);
+    CHECK(!Bridge::NextQuote(entries, instrument, quote));
+}
+
+static void TestQuotesUnknown()
+{
+    LoopbackServer server(9608, OldAnswer);
+    Bridge bridge;
+    CHECK(bridge.Connect("127.0.0.1", 9608));
+
+    const std::string symbols[] = { "MES 03-26" };
+    Tokenizer entries(std::string_view(), '|');
+    CHECK(!bridge.Quotes(symbols, 1, entries));
+    CHECK(Bridge::IsUnknownCommand(entries.Rest()));
+}
+
+static void TestQuotesTimeout()
+{
+    LoopbackServer server(9609, Answer);
+    server.SetReplyDelay("GETPRICES:SLOW", 300);
+    Bridge bridge;
+    bridge.SetTimeouts(ShortTimeouts());
+    CHECK(bridge.Connect("127.0.0.1", 9609));
+
+    const std::string slow[] = { "SLOW" };
+    Tokenizer entries(std::string_view(), '|');
+    CHECK(!bridge.Quotes(slow, 1, entries));
+    CHECK(Bridge::IsTimeout(entries.Rest()));
+    CHECK(!Bridge::IsUnknownCommand(entries.Rest()));
+
+    // The next sweep gets its answer once the late one is in and dropped
+    const std::string symbols[] = { "MES 03-26" };
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    CHECK(bridge.Quotes(symbols, 1, entries));
+}
+
+int main()
+{
+    RUN_TEST(TestOrderStatuses);
+    RUN_TEST(TestOrderStatusesUnknown);
+    RUN_TEST(TestOrderStatusesTimeout);
+    RUN_TEST(TestPositions);
+    RUN_TEST(TestPositionsUnknown);
+    RUN_TEST(TestPositionsTimeout);
+    RUN_TEST(TestQuotes);
+    RUN_TEST(TestQuotesUnknown);
+    RUN_TEST(TestQuotesTimeout);
+    return TestResult();
+}
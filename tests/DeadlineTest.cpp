@@ -0,0 +1,174 @@
+// DeadlineTest.cpp - Request deadlines against a stand-in AddOn that stalls
+// Copyright (c) 2025
+//
+// A command whose reply is late gets TIMEOUT_REPLY on time; the late reply
+// must then be dropped when it arrives instead of being taken for the
+// answer to the next command. Covered for newline and length-prefixed
+// replies on TCP and for the shared-memory link, where a peer that stops
+// reading also fills the request ring - sending must give up at the
+// deadline too, without leaving a partial request behind.
+
+#include "BridgeChannel.h"
+#include "ShmStandIn.h"
+#include "TestHarness.h"
+
+#include <chrono>
+#include <string>
+
+using Channel = BasicBridgeChannel<LoopbackTransport>;
+using Clock = std::chrono::steady_clock;
+
+static const int TIMEOUT_MS = 100;
+static const int DELAY_MS = 300;
+
+// "ECHO:{n}[:padding]" is answered with "REPLY:{n}"
+static std::string Answer(std::string_view request)
+{
+    if (request == "PING") return "PONG";
+    if (request.compare(0, 5, "ECHO:") == 0) {
+        std::string_view n = request.substr(5, request.find(':', 5) - 5);
+        return "REPLY:" + std::string(n);
+    }
+    return "ERROR:Unknown command";
+}
+
+static std::string Echo(int n, size_t padding = 0)
+{
+    std::string command = "ECHO:" + std::to_string(n);
+    if (padding > 0) {
+        command += ':';
+        command.append(padding, 'x');
+    }
+    return command;
+}
+
+static std::string Reply(int n)
+{
+    return "REPLY:" + std::to_string(n);
+}
+
+static long ElapsedMs(Clock::time_point start)
+{
+    return (long)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+// Time out on a slow command, then check the next ones get their own replies
+static void CheckLateReplyDropped(Channel& channel)
+{
+    auto start = Clock::now();
+    CHECK(channel.SendCommand("ECHO:1:slow", TIMEOUT_MS) == Channel::TIMEOUT_REPLY);
+    long elapsed = ElapsedMs(start);
+    CHECK(elapsed >= TIMEOUT_MS - 10 && elapsed < DELAY_MS);
+
+    // The late REPLY:1 arrives ahead of these and must be skipped
+    CHECK(channel.SendCommand(Echo(2), 2000) == Reply(2));
+    CHECK(channel.SendCommand(Echo(3)) == Reply(3));
+
+    // Several in a row, then a batch
+    CHECK(channel.SendCommand("ECHO:4:slow", TIMEOUT_MS) == Channel::TIMEOUT_REPLY);
+    CHECK(channel.SendCommand("ECHO:5:slow", TIMEOUT_MS) == Channel::TIMEOUT_REPLY);
+    std::string commands[] = { Echo(6), Echo(7), Echo(8) };
+    std::string_view views[] = { commands[0], commands[1], commands[2] };
+    std::string_view replies[3];
+    CHECK(channel.SendBatch(views, 3, replies, 2000) == 3);
+    CHECK(replies[0] == Reply(6) && replies[1] == Reply(7) && replies[2] == Reply(8));
+    CHECK(channel.IsOpen());
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+static void TestLateReplyFramed()
+{
+    LoopbackServer server(9501, Answer);
+    server.SetReplyDelay("ECHO:1:", DELAY_MS);
+    server.SetReplyDelay("ECHO:4:", DELAY_MS);
+    server.SetReplyDelay("ECHO:5:", DELAY_MS);
+    server.SetSegmentation(3, 9);
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9501, Codec::Text, false));
+    CHECK(channel.IsFramed());
+    CheckLateReplyDropped(channel);
+}
+
+static void TestLateReplyNewline()
+{
+    LoopbackServer server(9502, Answer);
+    server.SetFraming(false);
+    server.SetReplyDelay("ECHO:1:", DELAY_MS);
+    server.SetReplyDelay("ECHO:4:", DELAY_MS);
+    server.SetReplyDelay("ECHO:5:", DELAY_MS);
+    server.SetSegmentation(3, 9);
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9502, Codec::Text, false));
+    CHECK(!channel.IsFramed());
+    CheckLateReplyDropped(channel);
+}
+
+// TCP side of a shared-memory session: hands out the stand-in's mapping
+static LoopbackServer::Handler OfferMapping(const ShmStandIn& peer)
+{
+    return [&peer](std::string_view request) -> std::string {
+        if (request == "SHM:OPEN") return std::string("OK:SHM:") + peer.Name();
+        return Answer(request);
+    };
+}
+
+static void TestLateReplySharedMemory()
+{
+    ShmStandIn peer([](std::string_view request) -> std::string {
+        if (request.find(":slow") != std::string_view::npos) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_MS));
+        }
+        return Answer(request);
+    });
+    LoopbackServer server(9503, OfferMapping(peer));
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9503, Codec::Text, true));
+    CHECK(channel.IsSharedMemory());
+    CheckLateReplyDropped(channel);
+}
+
+// A peer that stops reading: the request ring fills and sending times out
+static void TestFullRequestRing()
+{
+    const uint32_t ringSize = 4096;
+    ShmStandIn peer(Answer, ringSize);
+    LoopbackServer server(9504, OfferMapping(peer));
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9504, Codec::Text, true));
+    CHECK(channel.IsSharedMemory());
+    CHECK(channel.SendCommand(Echo(0)) == Reply(0));
+
+    // Each request takes ~1 KB; the fifth no longer fits
+    peer.Pause(true);
+    for (int n = 1; n <= 4; n++) {
+        CHECK(channel.SendCommand(Echo(n, 1000), TIMEOUT_MS) == Channel::TIMEOUT_REPLY);
+    }
+    auto start = Clock::now();
+    CHECK(channel.SendCommand(Echo(5, 1000), TIMEOUT_MS) == Channel::TIMEOUT_REPLY);
+    long elapsed = ElapsedMs(start);
+    CHECK(elapsed >= TIMEOUT_MS - 10 && elapsed < 1000);
+    CHECK(channel.IsOpen());
+
+    // Once the peer reads again, the four queued requests are answered and
+    // their replies dropped; the fifth was never sent, so nothing is owed
+    // for it and the next command gets its own reply
+    peer.Pause(false);
+    CHECK(channel.SendCommand(Echo(6), 2000) == Reply(6));
+    CHECK(channel.SendCommand(Echo(7)) == Reply(7));
+}
+
+int main()
+{
+    RUN_TEST(TestLateReplyFramed);
+    RUN_TEST(TestLateReplyNewline);
+    RUN_TEST(TestLateReplySharedMemory);
+    RUN_TEST(TestFullRequestRing);
+    return TestResult();
+}
@@ -0,0 +1,209 @@
+// DepthBookTest.cpp - Order book row operations, GET_BOOK copies, depth feed
+// Copyright (c) 2025
+//
+// DepthBook against hand-written row operations, then against the
+// DepthGenerator feed: directly, with GET_BOOK copies taken while a writer
+// applies 100k updates per second, and end to end through the push channel
+// of QuoteStream. A copy must never be torn - asks ascending, bids
+// descending, best ask above best bid.
+
+#include "DepthBook.h"
+#include "DepthGenerator.h"
+#include "QuoteStream.h"
+#include "TestHarness.h"
+#include "WireCodec.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Stream = BasicQuoteStream<LoopbackTransport>;
+using Clock = std::chrono::steady_clock;
+
+static const char SYMBOL[] = "MES 03-26";
+static const int LEVELS = 10;
+
+// Decode a generator line into 'book', as the quote stream reader does
+static bool ApplyLine(DepthBook& book, std::string_view line)
+{
+    DepthUpdate update;
+    return DepthUpdateSchema::Parse(line, update) &&
+           book.Apply((BookSide)update.side, (DepthOperation)update.operation, update.position,
+                      (float)update.price, (float)update.volume, update.time);
+}
+
+// Asks ascending with positive prices, then bids descending with negative
+// prices, and the book not crossed
+static bool Ordered(const T2* quotes, int count)
+{
+    int asks = 0;
+    while (asks < count && quotes[asks].fVal > 0) {
+        asks++;
+    }
+    for (int i = 1; i < asks; i++) {
+        if (quotes[i].fVal <= quotes[i - 1].fVal) return false;
+    }
+    for (int i = asks + 1; i < count; i++) {
+        if (-quotes[i].fVal >= -quotes[i - 1].fVal) return false;
+    }
+    return asks == 0 || asks == count || quotes[0].fVal > -quotes[asks].fVal;
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+static void TestRowOperations()
+{
+    DepthBook book;
+    T2 quotes[2 * DepthBook::MAX_LEVELS];
+    CHECK(book.Top(5, quotes, 10) == 0);
+
+    CHECK(book.Apply(BookSide::Ask, DepthOperation::Add, 0, 100.50f, 5, 46000.1));
+    CHECK(book.Apply(BookSide::Ask, DepthOperation::Add, 1, 100.75f, 7, 46000.1));
+    CHECK(book.Apply(BookSide::Ask, DepthOperation::Add, 0, 100.25f, 3, 46000.1));   // New best ask
+    CHECK(book.Apply(BookSide::Bid, DepthOperation::Add, 0, 100.00f, 4, 46000.1));
+    CHECK(book.Apply(BookSide::Bid, DepthOperation::Update, 0, 100.00f, 9, 46000.2));
+
+    CHECK(book.Top(5, quotes, 10) == 4);
+    CHECK(quotes[0].fVal == 100.25f && quotes[0].fVol == 3);
+    CHECK(quotes[1].fVal == 100.50f && quotes[2].fVal == 100.75f);
+    CHECK(quotes[3].fVal == -100.00f && quotes[3].fVol == 9);
+    CHECK(quotes[3].time == 46000.2);
+
+    // Positions outside the ladder are ignored
+    CHECK(!book.Apply(BookSide::Ask, DepthOperation::Add, 4, 101.0f, 1, 0));
+    CHECK(!book.Apply(BookSide::Bid, DepthOperation::Update, 1, 99.75f, 1, 0));
+    CHECK(!book.Apply(BookSide::Bid, DepthOperation::Remove, -1, 0, 0, 0));
+
+    CHECK(book.Apply(BookSide::Ask, DepthOperation::Remove, 1, 0, 0, 46000.3));
+    CHECK(book.Top(5, quotes, 10) == 3);
+    CHECK(quotes[0].fVal == 100.25f && quotes[1].fVal == 100.75f && quotes[2].fVal == -100.00f);
+
+    // 'levels' rows per side, at most 'maxQuotes' entries
+    CHECK(book.Top(1, quotes, 10) == 2);
+    CHECK(quotes[0].fVal == 100.25f && quotes[1].fVal == -100.00f);
+    CHECK(book.Top(5, quotes, 1) == 1);
+
+    book.Clear();
+    CHECK(book.Top(5, quotes, 10) == 0);
+}
+
+// Adding to a full ladder drops its last row
+static void TestFullLadder()
+{
+    DepthBook book;
+    for (int i = 0; i < DepthBook::MAX_LEVELS; i++) {
+        CHECK(book.Apply(BookSide::Bid, DepthOperation::Add, i, 100.0f - i, 1, 0));
+    }
+    CHECK(book.Apply(BookSide::Bid, DepthOperation::Add, 0, 101.0f, 1, 0));
+
+    T2 quotes[DepthBook::MAX_LEVELS + 1];
+    CHECK(book.Top(DepthBook::MAX_LEVELS + 1, quotes, DepthBook::MAX_LEVELS + 1) == DepthBook::MAX_LEVELS);
+    CHECK(quotes[0].fVal == -101.0f);
+    CHECK(quotes[DepthBook::MAX_LEVELS - 1].fVal == -(100.0f - (DepthBook::MAX_LEVELS - 2)));
+}
+
+// Every generated operation applies, and the book keeps LEVELS contiguous
+// rows per side one tick apart
+static void TestGeneratorFeed()
+{
+    DepthGenerator generator(SYMBOL, 5000.0, 0.25, LEVELS);
+    DepthBook book;
+    int rejected = 0;
+    for (int i = 0; i < 200000; i++) {
+        if (!ApplyLine(book, generator.Next(46000.0 + i * 1e-8))) rejected++;
+    }
+    CHECK(rejected == 0);
+
+    T2 quotes[2 * LEVELS];
+    CHECK(book.Top(LEVELS, quotes, 2 * LEVELS) == 2 * LEVELS);
+    CHECK(Ordered(quotes, 2 * LEVELS));
+    CHECK(quotes[0].fVal + quotes[LEVELS].fVal == 0.25f);   // Best ask one tick above best bid
+    for (int i = 1; i < LEVELS; i++) {
+        CHECK(quotes[i].fVal - quotes[i - 1].fVal == 0.25f);
+    }
+}
+
+// GET_BOOK copies while a writer applies 100k updates per second
+static void TestConcurrentCopies()
+{
+    DepthGenerator generator(SYMBOL, 5000.0, 0.25, LEVELS);
+    std::vector<std::string> lines;
+    for (int i = 0; i < 50000; i++) {
+        lines.emplace_back(generator.Next(46000.0 + i * 1e-8));
+    }
+
+    DepthBook book;
+    std::atomic<bool> done(false);
+    std::atomic<int> rejected(0);
+    std::thread writer([&] {
+        auto start = Clock::now();
+        for (size_t i = 0; i < lines.size(); i++) {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(10 * i));
+            if (!ApplyLine(book, lines[i])) rejected++;
+        }
+        done = true;
+    });
+
+    long copies = 0, torn = 0;
+    T2 quotes[2 * LEVELS];
+    while (!done) {
+        int count = book.Top(LEVELS, quotes, 2 * LEVELS);
+        copies++;
+        if (!Ordered(quotes, count)) torn++;
+    }
+    writer.join();
+
+    std::printf("  %ld copies, %ld torn\n", copies, torn);
+    CHECK(rejected == 0);
+    CHECK(copies > 0);
+    CHECK(torn == 0);
+}
+
+// DEPTH lines on the push channel end up in the watched asset's book
+static void TestStreamedBook()
+{
+    LoopbackServer server(9209, [](std::string_view request) {
+        return std::string(request == "STREAM" ? "OK:Streaming" : "ERROR:Unknown command");
+    });
+    Stream stream;
+    CHECK(stream.Start("127.0.0.1", 9209));
+    CHECK(stream.Watch(SYMBOL));
+
+    DepthGenerator generator(SYMBOL, 5000.0, 0.25, LEVELS);
+    DepthBook expected;
+    const int updates = 20000;
+    for (int i = 0; i < updates; i++) {
+        std::string_view line = generator.Next(46000.0 + i * 1e-8);
+        ApplyLine(expected, line);
+        server.Publish(line);
+    }
+
+    T2 quotes[2 * LEVELS], reference[2 * LEVELS];
+    int count = expected.Top(LEVELS, reference, 2 * LEVELS);
+    DATE last = reference[0].time;
+    CHECK(WaitFor([&] {
+        return stream.Book(SYMBOL, LEVELS, quotes, 2 * LEVELS) == count && quotes[0].time == last;
+    }, 5000));
+    for (int i = 0; i < count; i++) {
+        CHECK(quotes[i].fVal == reference[i].fVal && quotes[i].fVol == reference[i].fVol);
+    }
+
+    CHECK(stream.Book("OTHER", LEVELS, quotes, 2 * LEVELS) == 0);   // Not watched
+    stream.Stop();
+    CHECK(stream.Book(SYMBOL, LEVELS, quotes, 2 * LEVELS) == 0);
+}
+
+int main()
+{
+    RUN_TEST(TestRowOperations);
+    RUN_TEST(TestFullLadder);
+    RUN_TEST(TestGeneratorFeed);
+    RUN_TEST(TestConcurrentCopies);
+    RUN_TEST(TestStreamedBook);
+    return TestResult();
+}
@@ -0,0 +1,178 @@
+// FramingTest.cpp - Length-prefixed reply framing against a stand-in AddOn
+// Copyright (c) 2025
+//
+// Replies are cut into random pieces the way TCP may deliver them, down to
+// single bytes, so frame headers arrive split. Also covers empty frames,
+// a corrupt length header and multi-megabyte replies.
+
+#include "BridgeChannel.h"
+#include "TestHarness.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+using Channel = BasicBridgeChannel<LoopbackTransport>;
+
+// Reply content for "ECHO:{length}:{seed}" - includes '\n' bytes, which a
+// framed reader must not take for terminators
+static std::string Payload(size_t length, uint32_t seed)
+{
+    std::string payload(length, '\0');
+    uint32_t x = seed * 2654435761u + 1;
+    for (size_t i = 0; i < length; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        payload[i] = (x % 16 == 0) ? '\n' : (char)('a' + x % 26);
+    }
+    return payload;
+}
+
+// Stand-in AddOn: PING, ECHO and EMPTY; refuses tags, like older AddOns
+static std::string Answer(std::string_view request)
+{
+    if (request == "PING") {
+        return "PONG";
+    }
+    if (request == "EMPTY") {
+        return "";
+    }
+    if (request.compare(0, 5, "ECHO:") == 0) {
+        std::string arguments(request.substr(5));
+        size_t colon = arguments.find(':');
+        size_t length = std::stoul(arguments.substr(0, colon));
+        uint32_t seed = (uint32_t)std::stoul(arguments.substr(colon + 1));
+        return Payload(length, seed);
+    }
+    return "ERROR:Unknown command";
+}
+
+static std::string Echo(size_t length, uint32_t seed)
+{
+    return "ECHO:" + std::to_string(length) + ":" + std::to_string(seed);
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+// Pieces of 1..3 bytes: every 4-byte length header is split across reads
+static void TestSplitLengthPrefix()
+{
+    LoopbackServer server(9101, Answer);
+    server.SetSegmentation(3, 7);
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9101, Codec::Text, false));
+    CHECK(channel.IsFramed());
+
+    for (uint32_t i = 0; i < 300; i++) {
+        size_t length = (i * 37) % 700;
+        std::string_view reply = channel.SendCommand(Echo(length, i));
+        CHECK(reply == Payload(length, i));
+    }
+
+    // Pipelined replies share reads, so headers also straddle two frames
+    std::string commands[16];
+    std::string_view views[16], replies[16];
+    for (uint32_t i = 0; i < 16; i++) {
+        commands[i] = Echo(i * 3, 100 + i);
+        views[i] = commands[i];
+    }
+    CHECK(channel.SendBatch(views, 16, replies) == 16);
+    for (uint32_t i = 0; i < 16; i++) {
+        CHECK(replies[i] == Payload(i * 3, 100 + i));
+    }
+}
+
+// A zero-length frame is a complete (empty) reply, not a missing one
+static void TestZeroLengthFrame()
+{
+    LoopbackServer server(9102, Answer);
+    server.SetSegmentation(2, 3);
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9102, Codec::Text, false));
+    CHECK(channel.IsFramed());
+
+    std::string_view reply = channel.SendCommand("EMPTY", 500);
+    CHECK(reply.empty());
+    CHECK(channel.SendCommand("PING") == "PONG");
+
+    std::string_view commands[] = { "EMPTY", "PING", "EMPTY", "EMPTY", "PING" };
+    std::string_view replies[5];
+    CHECK(channel.SendBatch(commands, 5, replies) == 5);
+    CHECK(replies[0].empty());
+    CHECK(replies[1] == "PONG");
+    CHECK(replies[2].empty() && replies[3].empty());
+    CHECK(replies[4] == "PONG");
+    CHECK(channel.IsOpen());
+}
+
+// A length header beyond RecvBuffer::MAX_FRAME_SIZE fails the connection
+// at once instead of allocating for it or waiting for the payload
+static void TestOversizedFrame()
+{
+    LoopbackServer server(9103, [](std::string_view request) -> std::string {
+        if (request == "PING") {
+            return "PONG\n";              // Raw server: newline framing by hand
+        }
+        if (request == "BIG") {
+            return std::string("\xF0\xFF\xFF\x7F", 4) + "xyz";
+        }
+        std::string reply = "ERROR:Unknown command";
+        uint32_t length = (uint32_t)reply.size();
+        char header[4] = { (char)length, (char)(length >> 8), (char)(length >> 16), (char)(length >> 24) };
+        return std::string(header, 4) + reply;
+    });
+    server.SetRawReplies(true);
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9103, Codec::Text, false));
+    CHECK(channel.IsFramed());
+
+    auto start = std::chrono::steady_clock::now();
+    std::string_view reply = channel.SendCommand("BIG", 2000);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK(reply == "ERROR:Frame too large");
+    CHECK(!channel.IsOpen());
+    CHECK(elapsed < std::chrono::milliseconds(500));
+    CHECK(channel.SendCommand("PING") == "ERROR:Not connected");
+}
+
+// Multi-megabyte replies in random pieces of up to 64 KB arrive intact
+static void TestLargeReplies()
+{
+    LoopbackServer server(9104, Answer);
+    server.SetSegmentation(64 * 1024, 11);
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9104, Codec::Text, false));
+    CHECK(channel.IsFramed());
+
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < 8; i++) {
+        size_t length = (1 + i) * 1024 * 1024 + i * 4093;
+        std::string_view reply = channel.SendCommand(Echo(length, i), 10000);
+        CHECK(reply.size() == length);
+        CHECK(reply == Payload(length, i));
+        total += length;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Small commands after the large ones are still in step
+    CHECK(channel.SendCommand("PING") == "PONG");
+    std::printf("  %.1f MB in %.3f s (including payload generation)\n", total / 1048576.0, seconds);
+}
+
+int main()
+{
+    RUN_TEST(TestSplitLengthPrefix);
+    RUN_TEST(TestZeroLengthFrame);
+    RUN_TEST(TestOversizedFrame);
+    RUN_TEST(TestLargeReplies);
+    return TestResult();
+}
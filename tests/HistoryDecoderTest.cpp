@@ -0,0 +1,139 @@
+// HistoryDecoderTest.cpp - Pooled history decoding matches the serial decoder
+// Copyright (c) 2025
+//
+// HistoryDecoder promises exactly what TextCodec::DecodeHistory returns:
+// the same bars in ticks[0..loaded) and the same barCount, loaded, skipped
+// and endReached. Checked on replies above PARALLEL_THRESHOLD with one to
+// MAX_WORKERS workers, for ranges and buffer sizes that end the decode in
+// any chunk, and with malformed and empty bars mixed in.
+
+#include "HistoryDecoder.h"
+#include "TestHarness.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const double FIRST_BAR = 46000.0;         // OLE date, days
+static const double ONE_MINUTE = 1.0 / 1440.0;
+
+// HISTORY reply of one-minute bars; with 'damaged', every 97th bar is
+// malformed and every 89th empty
+static std::string HistoryReply(int bars, bool damaged)
+{
+    std::string reply = "HISTORY:" + std::to_string(bars);
+    char bar[128];
+    for (int i = 0; i < bars; i++) {
+        if (damaged && i % 89 == 5) {
+            reply += '|';
+            continue;
+        }
+        if (damaged && i % 97 == 3) {
+            reply += "|46000.5,n/a,1,2";
+            continue;
+        }
+        double open = 5000.0 + (i % 400) * 0.25;
+        int length = snprintf(bar, sizeof(bar), "|%.15g,%.15g,%.15g,%.15g,%.15g,%d", FIRST_BAR + i * ONE_MINUTE,
+                              open, open + 1.5, open - 0.75, open + 0.5, 100 + i % 900);
+        reply.append(bar, (size_t)length);
+    }
+    return reply;
+}
+
+static DATE BarTime(int i) { return FIRST_BAR + i * ONE_MINUTE; }
+
+// Decode with the pool and serially into zeroed buffers and compare
+static void CheckSame(HistoryDecoder& decoder, const std::string& reply, DATE tStart, DATE tEnd, int nTicks)
+{
+    std::vector<T6> serial(nTicks), pooled(nTicks);
+    memset(serial.data(), 0, sizeof(T6) * nTicks);
+    memset(pooled.data(), 0, sizeof(T6) * nTicks);
+
+    HistoryResult expected, result;
+    bool serialOk = TextCodec::DecodeHistory(reply, tStart, tEnd, serial.data(), nTicks, expected);
+    bool pooledOk = decoder.Decode(reply, tStart, tEnd, pooled.data(), nTicks, result);
+
+    CHECK(pooledOk == serialOk);
+    CHECK(result.barCount == expected.barCount);
+    CHECK(result.loaded == expected.loaded);
+    CHECK(result.skipped == expected.skipped);
+    CHECK(result.endReached == expected.endReached);
+    // Slots past 'loaded' are scratch to the serial decoder (a bar it read
+    // and then rejected); only the loaded bars are part of the result
+    CHECK(memcmp(pooled.data(), serial.data(), sizeof(T6) * expected.loaded) == 0);
+}
+
+// Ranges and buffer sizes that stop the decode early, late and in between
+static void CheckRanges(HistoryDecoder& decoder, const std::string& reply, int bars)
+{
+    DATE all = BarTime(bars);
+    CheckSame(decoder, reply, 0, all, bars);                                  // Everything
+    CheckSame(decoder, reply, BarTime(bars / 3), all, bars);                  // Start in chunk 1+
+    CheckSame(decoder, reply, 0, BarTime(bars / 5), bars);                    // End in chunk 0
+    CheckSame(decoder, reply, BarTime(bars / 2), BarTime(bars * 3 / 4), bars);
+    CheckSame(decoder, reply, 0, all, bars / 10);                             // Buffer full in chunk 0
+    CheckSame(decoder, reply, 0, all, bars * 2 / 3);                          // Full in a later chunk
+    CheckSame(decoder, reply, BarTime(bars / 4), all, bars / 3);
+    CheckSame(decoder, reply, BarTime(bars + 10), BarTime(bars + 20), bars);  // Nothing in range
+    CheckSame(decoder, reply, 0, all, 1);
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+static void TestWorkerCounts()
+{
+    const int bars = 60000;   // ~3 MB, well above PARALLEL_THRESHOLD
+    std::string reply = HistoryReply(bars, false);
+    CHECK(reply.size() > 2 * HistoryDecoder::PARALLEL_THRESHOLD);
+
+    for (int workers = 1; workers <= (int)HistoryDecoder::MAX_WORKERS; workers++) {
+        HistoryDecoder decoder(workers);
+        CheckRanges(decoder, reply, bars);
+        CHECK(decoder.Workers() == (unsigned)workers);
+    }
+}
+
+static void TestDamagedBars()
+{
+    const int bars = 50000;
+    std::string reply = HistoryReply(bars, true);
+
+    HistoryDecoder decoder(HistoryDecoder::MAX_WORKERS);
+    CheckRanges(decoder, reply, bars);
+}
+
+// Below the threshold and on a single core the pool is not used
+static void TestSerialFallback()
+{
+    HistoryDecoder small(HistoryDecoder::MAX_WORKERS);
+    CheckRanges(small, HistoryReply(2000, true), 2000);
+    CHECK(small.Workers() == 0);
+
+    HistoryDecoder none(0);
+    CheckRanges(none, HistoryReply(50000, false), 50000);
+    CHECK(none.Workers() == 0);
+}
+
+// One decoder serves replies of varying sizes, as across BrokerHistory2 calls
+static void TestReuse()
+{
+    HistoryDecoder decoder(2);
+    for (int bars : { 40000, 25000, 80000, 1000, 30000 }) {
+        CheckSame(decoder, HistoryReply(bars, bars % 2 == 0), 0, BarTime(bars), bars);
+    }
+
+    HistoryResult result;
+    T6 tick;
+    CHECK(!decoder.Decode("ERROR:No data", 0, 1, &tick, 1, result));
+}
+
+int main()
+{
+    RUN_TEST(TestWorkerCounts);
+    RUN_TEST(TestDamagedBars);
+    RUN_TEST(TestSerialFallback);
+    RUN_TEST(TestReuse);
+    return TestResult();
+}
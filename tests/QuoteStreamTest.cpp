@@ -0,0 +1,344 @@
+// QuoteStreamTest.cpp - Push quote channel against a stand-in publisher
+// Copyright (c) 2025
+//
+// The stand-in AddOn acknowledges STREAM and pushes QUOTE lines with
+// LoopbackServer::Publish. Covers the seqlock quote table under a fast
+// publisher, releasing and reusing table slots, the STREAM deadline, the
+// queue of applied quotes, and what happens when the push connection drops.
+
+#include "QuoteStream.h"
+#include "TcpBridge.h"
+#include "TestHarness.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using Stream = BasicQuoteStream<LoopbackTransport>;
+using Bridge = BasicTcpBridge<LoopbackTransport, TextCodec>;
+
+static const char SYMBOL[] = "MES 03-26";
+
+static std::atomic<int> s_priceRequests(0);
+
+// Stand-in AddOn: STREAM, plus what the request channels of a bridge need
+static std::string Answer(std::string_view request)
+{
+    if (request == "PING") return "PONG";
+    if (request == "STREAM") return "OK:Streaming";
+    if (request == "CONNECTED") return "CONNECTED:1";
+    if (request.compare(0, 9, "GETPRICE:") == 0) {
+        s_priceRequests++;
+        return "PRICE:100:99.75:100.25:500";
+    }
+    return "ERROR:Unknown command";
+}
+
+// QUOTE line whose fields all derive from 'n', so a torn read shows
+static std::string QuoteLine(const char* symbol, int n)
+{
+    char line[128];
+    snprintf(line, sizeof(line), "QUOTE:%s:%d:%d:%d:%d:%d", symbol, n, n - 1, n + 1, 2 * n, n);
+    return line;
+}
+
+static bool Consistent(const Quote& quote)
+{
+    return quote.bid == quote.last - 1 && quote.ask == quote.last + 1 &&
+           quote.volume == 2 * quote.last && quote.time == quote.last;
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+static void TestStreamedQuotes()
+{
+    LoopbackServer server(9201, Answer);
+    Stream stream;
+    CHECK(stream.Start("127.0.0.1", 9201));
+    CHECK(stream.IsRunning());
+    CHECK(stream.Watch(SYMBOL));
+
+    Quote quote;
+    CHECK(!stream.Latest(SYMBOL, quote));   // Nothing pushed yet
+
+    server.Publish(QuoteLine("OTHER", 5));  // Not watched - ignored
+    server.Publish(QuoteLine(SYMBOL, 42));
+    CHECK(WaitFor([&] { return stream.Latest(SYMBOL, quote); }));
+    CHECK(quote.last == 42 && Consistent(quote));
+    CHECK(!stream.Latest("OTHER", quote));
+
+    server.Publish("QUOTE:MES 03-26:garbage");  // Malformed - slot keeps its quote
+    server.Publish(QuoteLine(SYMBOL, 43));
+    CHECK(WaitFor([&] { return stream.Latest(SYMBOL, quote) && quote.last == 43; }));
+
+    stream.Stop();
+}
+
+// One thread publishes as fast as it can while another reads the slot
+static void TestSeqlockUnderLoad()
+{
+    LoopbackServer server(9202, Answer);
+    Stream stream;
+    CHECK(stream.Start("127.0.0.1", 9202));
+    CHECK(stream.Watch(SYMBOL));
+
+    const int updates = 200000;
+    std::atomic<bool> done(false);
+    long reads = 0, torn = 0, backwards = 0;
+    std::thread reader([&] {
+        double previous = 0;
+        while (!done.load()) {
+            Quote quote;
+            if (stream.Latest(SYMBOL, quote)) {
+                reads++;
+                if (!Consistent(quote)) torn++;
+                if (quote.last < previous) backwards++;
+                previous = quote.last;
+            }
+        }
+    });
+
+    for (int n = 1; n <= updates; n++) {
+        server.Publish(QuoteLine(SYMBOL, n));
+    }
+    Quote quote;
+    CHECK(WaitFor([&] { return stream.Latest(SYMBOL, quote) && quote.last == updates; }, 10000));
+    done = true;
+    reader.join();
+
+    std::printf("  %ld reads, %ld torn, %ld out of order\n", reads, torn, backwards);
+    CHECK(reads > 0);
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    stream.Stop();
+}
+
+// An unwatched instrument loses its quote and book; watched again, it has
+// neither until new lines arrive
+static void TestUnwatch()
+{
+    LoopbackServer server(9207, Answer);
+    Stream stream;
+    CHECK(stream.Start("127.0.0.1", 9207));
+    CHECK(stream.Watch(SYMBOL));
+
+    Quote quote;
+    T2 rows[4];
+    server.Publish("DEPTH:MES 03-26:1:0:0:99.75:12");
+    server.Publish(QuoteLine(SYMBOL, 30));
+    CHECK(WaitFor([&] { return stream.Latest(SYMBOL, quote); }));
+    CHECK(stream.Book(SYMBOL, 1, rows, 4) == 1);
+
+    stream.Unwatch(SYMBOL);
+    CHECK(!stream.Latest(SYMBOL, quote));
+    CHECK(stream.Book(SYMBOL, 1, rows, 4) == 0);
+    server.Publish(QuoteLine(SYMBOL, 31));   // Not watched - ignored
+    server.Publish(QuoteLine("OTHER", 1));
+    CHECK(stream.Watch("OTHER"));            // Takes the released slot
+    CHECK(WaitFor([&] { return stream.Latest("OTHER", quote); }));
+    CHECK(!stream.Latest(SYMBOL, quote));
+
+    CHECK(stream.Watch(SYMBOL));
+    CHECK(!stream.Latest(SYMBOL, quote));    // No stale quote
+    CHECK(stream.Book(SYMBOL, 1, rows, 4) == 0);
+    server.Publish(QuoteLine(SYMBOL, 32));
+    CHECK(WaitFor([&] { return stream.Latest(SYMBOL, quote); }));
+    CHECK(quote.last == 32);
+
+    stream.Unwatch("NOT WATCHED");           // No effect
+    stream.Unwatch(nullptr);
+    CHECK(stream.Latest(SYMBOL, quote));
+    stream.Stop();
+}
+
+// Far more instruments than table slots pass through, as with an asset
+// limit below the number of assets a script cycles over, while quotes
+// for all of them keep arriving
+static void TestSlotReuse()
+{
+    LoopbackServer server(9208, Answer);
+    Stream stream;
+    CHECK(stream.Start("127.0.0.1", 9208));
+
+    const int instruments = 4 * Stream::MAX_ASSETS;
+    const int watched = 20;
+    auto name = [](int i) { return "SYM" + std::to_string(i); };
+
+    std::atomic<bool> done(false);
+    std::thread publisher([&] {
+        for (int n = 1; !done.load(); n++) {
+            server.Publish(QuoteLine(name(n % instruments).c_str(), n));
+        }
+    });
+
+    int live = 0;
+    for (int i = 0; i < instruments; i++) {
+        if (i >= watched) {
+            stream.Unwatch(name(i - watched).c_str());
+        }
+        CHECK(stream.Watch(name(i).c_str()));
+
+        Quote quote;
+        if (WaitFor([&] { return stream.Latest(name(i).c_str(), quote); }, 2000)) {
+            live++;
+            CHECK(Consistent(quote));
+        }
+    }
+    done = true;
+    publisher.join();
+
+    CHECK(live == instruments);
+    Quote quote;
+    CHECK(!stream.Latest(name(0).c_str(), quote));
+    stream.Stop();
+}
+
+// An AddOn that accepts the connection but never acknowledges STREAM
+static void TestStartDeadline()
+{
+    LoopbackServer server(9203, Answer);
+    server.SetReplyDelay("STREAM", 60000);
+
+    Stream stream;
+    auto start = std::chrono::steady_clock::now();
+    CHECK(!stream.Start("127.0.0.1", 9203, 200));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    CHECK(elapsed >= std::chrono::milliseconds(150));
+    CHECK(elapsed < std::chrono::milliseconds(2000));
+    CHECK(!stream.IsRunning());
+
+    // An AddOn without STREAM support answers at once
+    LoopbackServer old(9204, [](std::string_view) { return std::string("ERROR:Unknown command"); });
+    CHECK(!stream.Start("127.0.0.1", 9204, 5000));
+}
+
+// A dropped push connection takes its quotes with it; a restarted stream
+// serves only quotes pushed after the restart
+static void TestStreamDrop()
+{
+    LoopbackServer server(9205, Answer);
+    Stream stream;
+    CHECK(stream.Start("127.0.0.1", 9205));
+    CHECK(stream.Watch(SYMBOL));
+
+    Quote quote;
+    server.Publish(QuoteLine(SYMBOL, 7));
+    CHECK(WaitFor([&] { return stream.Latest(SYMBOL, quote); }));
+
+    server.DropStreams();
+    CHECK(WaitFor([&] { return !stream.IsRunning(); }));
+    CHECK(!stream.Latest(SYMBOL, quote));
+
+    CHECK(stream.Start("127.0.0.1", 9205));
+    CHECK(!stream.Latest(SYMBOL, quote));   // The old quote is gone
+    server.Publish(QuoteLine(SYMBOL, 8));
+    CHECK(WaitFor([&] { return stream.Latest(SYMBOL, quote); }));
+    CHECK(quote.last == 8);
+
+    stream.Stop();
+    CHECK(!stream.Latest(SYMBOL, quote));
+}
+
+// Every applied quote is queued in order. Updates that find the queue
+// full are left out, and so are those of a dropped connection; both show
+// as one lost-updates entry before the next queued quote.
+static void TestUpdateQueue()
+{
+    const int capacity = (int)Stream::UPDATE_QUEUE_CAPACITY;
+    LoopbackServer server(9210, Answer);
+    Stream stream;
+    CHECK(stream.Start("127.0.0.1", 9210));
+    CHECK(stream.Watch(SYMBOL));
+
+    PushedQuote update;
+    CHECK(!stream.NextUpdate(update));
+    server.Publish(QuoteLine("OTHER", 1));   // Not watched - not queued
+    for (int n = 1; n <= capacity + 100; n++) {
+        server.Publish(QuoteLine(SYMBOL, n));
+    }
+    Quote quote;
+    CHECK(WaitFor([&] { return stream.Latest(SYMBOL, quote) && quote.last == capacity + 100; }, 10000));
+
+    int taken = 0, wrong = 0;
+    while (stream.NextUpdate(update)) {
+        taken++;
+        if (std::string(update.instrument) != SYMBOL || update.quote.last != taken || !Consistent(update.quote)) {
+            wrong++;
+        }
+    }
+    CHECK(taken == capacity);
+    CHECK(wrong == 0);
+
+    server.Publish(QuoteLine(SYMBOL, 1));
+    CHECK(WaitFor([&] { return stream.NextUpdate(update); }));
+    CHECK(update.instrument[0] == '\0');
+    CHECK(stream.NextUpdate(update) && update.quote.last == 1);
+    CHECK(!stream.NextUpdate(update));
+
+    // Restarted after a drop: the gap is marked once
+    server.DropStreams();
+    CHECK(WaitFor([&] { return !stream.IsRunning(); }));
+    CHECK(stream.Start("127.0.0.1", 9210));
+    server.Publish(QuoteLine(SYMBOL, 2));
+    server.Publish(QuoteLine(SYMBOL, 3));
+    CHECK(WaitFor([&] { return stream.NextUpdate(update); }));
+    CHECK(update.instrument[0] == '\0');
+    CHECK(WaitFor([&] { return stream.NextUpdate(update); }) && update.quote.last == 2);
+    CHECK(WaitFor([&] { return stream.NextUpdate(update); }) && update.quote.last == 3);
+
+    stream.Stop();
+}
+
+// TcpBridge: pushed quotes while streaming, GETPRICE after a drop, and
+// the stream again after ResumeStreaming()
+static void TestBridgeFallback()
+{
+    LoopbackServer server(9206, Answer);
+    Bridge bridge;
+    CHECK(bridge.Connect("127.0.0.1", 9206));
+    CHECK(bridge.IsStreaming());
+    CHECK(bridge.WatchQuotes(SYMBOL));
+
+    Quote quote;
+    server.Publish(QuoteLine(SYMBOL, 20));
+    CHECK(WaitFor([&] { Quote q; return bridge.StreamedQuote(SYMBOL, q); }));
+    int requests = s_priceRequests;
+    CHECK(bridge.GetQuote(SYMBOL, quote) && quote.last == 20);
+    CHECK(s_priceRequests == requests);         // No I/O
+
+    server.DropStreams();
+    CHECK(WaitFor([&] { return !bridge.IsStreaming(); }));
+    CHECK(bridge.GetQuote(SYMBOL, quote) && quote.last == 100);
+    CHECK(s_priceRequests == requests + 1);     // Polled
+
+    CHECK(bridge.ResumeStreaming());
+    CHECK(bridge.IsStreaming());
+    CHECK(!bridge.ResumeStreaming());           // Running - nothing to do
+    server.Publish(QuoteLine(SYMBOL, 21));
+    CHECK(WaitFor([&] { Quote q; return bridge.StreamedQuote(SYMBOL, q); }));
+    CHECK(bridge.GetQuote(SYMBOL, quote) && quote.last == 21);
+
+    // Retries are spaced out
+    server.DropStreams();
+    CHECK(WaitFor([&] { return !bridge.IsStreaming(); }));
+    CHECK(!bridge.ResumeStreaming());
+
+    bridge.Disconnect();
+}
+
+int main()
+{
+    RUN_TEST(TestStreamedQuotes);
+    RUN_TEST(TestSeqlockUnderLoad);
+    RUN_TEST(TestUnwatch);
+    RUN_TEST(TestSlotReuse);
+    RUN_TEST(TestStartDeadline);
+    RUN_TEST(TestStreamDrop);
+    RUN_TEST(TestUpdateQueue);
+    RUN_TEST(TestBridgeFallback);
+    return TestResult();
+}
@@ -0,0 +1,168 @@
+// SharedMemoryTest.cpp - Request/reply traffic over the shared-memory link
+// Copyright (c) 2025
+//
+// The TCP side is a LoopbackServer that hands out the mapping of a
+// ShmStandIn on SHM:OPEN; after that, requests and replies must travel
+// through the rings only. Covers replies larger than the reply ring,
+// pipelined batches, the fallback when the AddOn refuses shared memory,
+// and an AddOn that goes away mid-session.
+
+#include "BridgeChannel.h"
+#include "ShmStandIn.h"
+#include "TestHarness.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+using Channel = BasicBridgeChannel<LoopbackTransport>;
+
+static std::atomic<int> s_tcpRequests(0);   // Non-handshake requests seen over TCP
+static std::atomic<int> s_shmRequests(0);
+
+// Reply to "ECHO:{length}": 'length' bytes that depend on the length
+static std::string Payload(size_t length)
+{
+    std::string payload(length, '\0');
+    for (size_t i = 0; i < length; i++) {
+        payload[i] = (char)('a' + (i * 7 + length) % 26);
+    }
+    return payload;
+}
+
+static std::string Answer(std::string_view request)
+{
+    if (request == "PING") return "PONG";
+    if (request.compare(0, 5, "ECHO:") == 0) return Payload(std::stoul(std::string(request.substr(5))));
+    return "ERROR:Unknown command";
+}
+
+static std::string ShmAnswer(std::string_view request)
+{
+    s_shmRequests++;
+    return Answer(request);
+}
+
+// TCP side: offers the stand-in's mapping, or refuses with 'peer' null
+static LoopbackServer::Handler TcpAnswer(const ShmStandIn* peer)
+{
+    return [peer](std::string_view request) -> std::string {
+        if (request == "SHM:OPEN") {
+            return peer ? std::string("OK:SHM:") + peer->Name() : "ERROR:Unknown command";
+        }
+        if (request == "SHM:CLOSE") return "OK";
+        if (request != "PING") s_tcpRequests++;
+        return Answer(request);
+    };
+}
+
+static std::string Echo(size_t length)
+{
+    return "ECHO:" + std::to_string(length);
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+static void TestRoundTrips()
+{
+    ShmStandIn peer(ShmAnswer);
+    CHECK(peer.IsOpen());
+    LoopbackServer server(9401, TcpAnswer(&peer));
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9401, Codec::Text, true));
+    CHECK(channel.IsSharedMemory());
+
+    s_tcpRequests = 0;
+    s_shmRequests = 0;
+    for (size_t i = 0; i < 2000; i++) {
+        size_t length = (i * 131) % 3000;
+        CHECK(channel.SendCommand(Echo(length)) == Payload(length));
+    }
+    CHECK(s_shmRequests == 2000);
+    CHECK(s_tcpRequests == 0);
+}
+
+// Replies several times the reply ring size stream through it
+static void TestLargeReplies()
+{
+    ShmStandIn peer(ShmAnswer, 4096, 64 * 1024);
+    LoopbackServer server(9402, TcpAnswer(&peer));
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9402, Codec::Text, true));
+    CHECK(channel.IsSharedMemory());
+
+    for (size_t length : { (size_t)65536, (size_t)300000, (size_t)4 << 20 }) {
+        std::string_view reply = channel.SendCommand(Echo(length), 10000);
+        CHECK(reply.size() == length);
+        CHECK(reply == Payload(length));
+    }
+    CHECK(channel.SendCommand("PING") == "PONG");
+}
+
+static void TestPipelined()
+{
+    ShmStandIn peer(ShmAnswer);
+    LoopbackServer server(9403, TcpAnswer(&peer));
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9403, Codec::Text, true));
+    CHECK(channel.IsSharedMemory());
+
+    std::string commands[32];
+    std::string_view views[32], replies[32];
+    for (size_t i = 0; i < 32; i++) {
+        commands[i] = Echo(i * 97);
+        views[i] = commands[i];
+    }
+    CHECK(channel.SendBatch(views, 32, replies) == 32);
+    for (size_t i = 0; i < 32; i++) {
+        CHECK(replies[i] == Payload(i * 97));
+    }
+}
+
+// An AddOn without shared memory keeps the session on TCP
+static void TestRefused()
+{
+    LoopbackServer server(9404, TcpAnswer(nullptr));
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9404, Codec::Text, true));
+    CHECK(!channel.IsSharedMemory());
+
+    s_tcpRequests = 0;
+    CHECK(channel.SendCommand(Echo(100)) == Payload(100));
+    CHECK(s_tcpRequests == 1);
+}
+
+// The AddOn side closing the mapping fails the next command at once
+static void TestPeerClosed()
+{
+    auto peer = std::make_unique<ShmStandIn>(ShmAnswer);
+    LoopbackServer server(9405, TcpAnswer(peer.get()));
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9405, Codec::Text, true));
+    CHECK(channel.IsSharedMemory());
+    CHECK(channel.SendCommand("PING") == "PONG");
+
+    peer.reset();
+    auto start = std::chrono::steady_clock::now();
+    std::string_view reply = channel.SendCommand("PING", 5000);
+    CHECK(reply.compare(0, 6, "ERROR:") == 0);
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(1000));
+}
+
+int main()
+{
+    RUN_TEST(TestRoundTrips);
+    RUN_TEST(TestLargeReplies);
+    RUN_TEST(TestPipelined);
+    RUN_TEST(TestRefused);
+    RUN_TEST(TestPeerClosed);
+    return TestResult();
+}
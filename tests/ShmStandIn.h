@@ -0,0 +1,133 @@
+// ShmStandIn.h - Stand-in AddOn side of a shared-memory link
+// Copyright (c) 2025
+//
+// Creates the mapping (SharedMemoryLink::Create) and serves it on its own
+// thread the way the AddOn does: newline-terminated requests from the
+// request ring, each answered with a length-prefixed frame in the reply
+// ring. The plugin side learns the name from the TCP connection, so the
+// stand-in for that (LoopbackServer, TcpStandIn) answers SHM:OPEN with
+// "OK:SHM:" + Name().
+//
+// A slow AddOn is a handler that sleeps; a stalled one stops reading
+// requests (Pause), which lets the request ring fill up.
+
+#pragma once
+
+#ifndef SHMSTANDIN_H
+#define SHMSTANDIN_H
+
+#include "SharedMemoryLink.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <unistd.h>
+
+//=============================================================================
+// ShmStandIn class - Threaded AddOn side of a SharedMemoryLink
+//=============================================================================
+
+class ShmStandIn
+{
+public:
+    using Handler = std::function<std::string(std::string_view request)>;
+
+    explicit ShmStandIn(Handler handler,
+                        uint32_t requestSize = SharedMemoryLink::DEFAULT_REQUEST_SIZE,
+                        uint32_t replySize = SharedMemoryLink::DEFAULT_REPLY_SIZE)
+        : m_handler(std::move(handler))
+        , m_paused(false)
+        , m_stopping(false)
+    {
+        static std::atomic<int> s_instance(0);
+        std::snprintf(m_name, sizeof(m_name), "/nt8standin-%d-%d", (int)getpid(), s_instance++);
+        if (m_link.Create(m_name, requestSize, replySize)) {
+            m_thread = std::thread(&ShmStandIn::Serve, this);
+        }
+    }
+
+    ~ShmStandIn()
+    {
+        m_stopping = true;
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        m_link.Close();
+    }
+
+    ShmStandIn(const ShmStandIn&) = delete;
+    ShmStandIn& operator=(const ShmStandIn&) = delete;
+
+    bool IsOpen() const { return m_link.IsOpen(); }
+    const char* Name() const { return m_name; }
+
+    // Stop or resume reading requests. Returns once the serve thread is
+    // out of its read, so a request sent afterwards stays in the ring.
+    void Pause(bool paused)
+    {
+        std::lock_guard<std::mutex> lock(m_serveMutex);
+        m_paused = paused;
+    }
+
+private:
+    SharedMemoryLink m_link;
+    Handler m_handler;
+    char m_name[SharedMemoryLink::MAX_NAME_LENGTH];
+    std::atomic<bool> m_paused;
+    std::atomic<bool> m_stopping;
+    std::mutex m_serveMutex;          // Held while reading and answering
+    std::thread m_thread;
+
+    // The plugin only reads while it waits for a reply, so keep trying
+    bool Write(const std::string& frame)
+    {
+        int sent = 0;
+        while (sent == 0 && !m_stopping) {
+            sent = m_link.Send(frame.data(), frame.size(), 1000);
+        }
+        return sent > 0;
+    }
+
+    void Serve()
+    {
+        std::string input;
+        char buffer[64 * 1024];
+
+        while (!m_stopping) {
+            std::unique_lock<std::mutex> lock(m_serveMutex);
+            if (m_paused) {
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            int received = m_link.Recv(buffer, sizeof(buffer), false, 20);
+            if (received < 0) {
+                break;   // Plugin closed the link
+            }
+            input.append(buffer, (size_t)received);
+
+            size_t start = 0, newline;
+            while ((newline = input.find('\n', start)) != std::string::npos) {
+                std::string_view request(input.data() + start, newline - start);
+                start = newline + 1;
+
+                std::string reply = m_handler(request);
+                uint32_t length = (uint32_t)reply.size();
+                char header[4] = { (char)length, (char)(length >> 8), (char)(length >> 16), (char)(length >> 24) };
+                reply.insert(0, header, sizeof(header));
+                if (!Write(reply)) {
+                    return;
+                }
+            }
+            input.erase(0, start);
+        }
+    }
+};
+
+#endif // SHMSTANDIN_H
@@ -0,0 +1,156 @@
+// TaggedRequestTest.cpp - Tagged requests against a stand-in AddOn
+// Copyright (c) 2025
+//
+// After TAGS:ON the stand-in answers every request as soon as its own
+// delay has passed, so replies complete out of request order. Each must
+// still reach the command it belongs to: within a batch, and when a late
+// reply to a timed-out batch turns up while the next batch is read. An
+// AddOn that refuses TAGS:ON leaves the channel matching replies by order.
+
+#include "BridgeChannel.h"
+#include "TestHarness.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Channel = BasicBridgeChannel<LoopbackTransport>;
+using Clock = std::chrono::steady_clock;
+
+static const int DELAY_MS = 300;
+
+static std::atomic<int> s_taggedRequests(0);
+
+// "FAST:{n}" and "SLOW:{n}" are answered with "REPLY:{n}"
+static std::string Answer(std::string_view request)
+{
+    if (!request.empty() && request[0] == '#') {
+        s_taggedRequests++;   // The stand-in strips tags before the handler
+    }
+    if (request == "PING") return "PONG";
+    if (request.compare(0, 5, "FAST:") == 0 || request.compare(0, 5, "SLOW:") == 0) {
+        return "REPLY:" + std::string(request.substr(5));
+    }
+    return "ERROR:Unknown command";
+}
+
+static std::string Reply(int n)
+{
+    return "REPLY:" + std::to_string(n);
+}
+
+static long ElapsedMs(Clock::time_point start)
+{
+    return (long)std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+// Send 'commands' as one batch; replies in 'replies'
+static size_t Batch(Channel& channel, const std::vector<std::string>& commands,
+                    std::vector<std::string_view>& replies, int timeoutMs)
+{
+    std::vector<std::string_view> views(commands.begin(), commands.end());
+    replies.assign(commands.size(), std::string_view());
+    return channel.SendBatch(views.data(), views.size(), replies.data(), timeoutMs);
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+// The slow first reply arrives last, behind the quick ones sent after it.
+// Replies come in pieces of 1..5 bytes, so 8-byte headers arrive split.
+static void TestOutOfOrderBatch()
+{
+    LoopbackServer server(9801, Answer);
+    server.SetTags(true);
+    server.SetReplyDelay("SLOW:", DELAY_MS);
+    server.SetSegmentation(5, 3);
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9801, Codec::Text, false));
+    CHECK(channel.IsFramed());
+    CHECK(channel.IsTagged());
+
+    std::vector<std::string_view> replies;
+    auto start = Clock::now();
+    CHECK(Batch(channel, { "SLOW:1", "FAST:2", "SLOW:3", "FAST:4", "FAST:5" }, replies, 2000) == 5);
+    CHECK(ElapsedMs(start) >= DELAY_MS - 10);
+    for (int i = 0; i < 5; i++) {
+        CHECK(replies[i] == Reply(i + 1));
+    }
+
+    // Single commands on the same channel
+    CHECK(channel.SendCommand("FAST:6") == Reply(6));
+    CHECK(channel.SendCommand("SLOW:7", 2000) == Reply(7));
+    CHECK(s_taggedRequests == 0);
+    CHECK(channel.IsOpen());
+}
+
+// A batch times out on its slow command; that reply turns up while the
+// next batch is read and must not be taken for any of its replies
+static void TestLateTaggedReplyDropped()
+{
+    LoopbackServer server(9802, Answer);
+    server.SetTags(true);
+    server.SetReplyDelay("SLOW:", DELAY_MS);
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9802, Codec::Text, false));
+    CHECK(channel.IsTagged());
+
+    std::vector<std::string_view> replies;
+    auto start = Clock::now();
+    CHECK(Batch(channel, { "FAST:1", "SLOW:2", "FAST:3" }, replies, 100) == 2);
+    long elapsed = ElapsedMs(start);
+    CHECK(elapsed >= 90 && elapsed < DELAY_MS);
+    CHECK(replies[0] == Reply(1));
+    CHECK(replies[1] == Channel::TIMEOUT_REPLY);
+    CHECK(replies[2] == Reply(3));
+
+    // REPLY:2 arrives in the middle of this batch, before SLOW:5's reply
+    CHECK(Batch(channel, { "FAST:4", "SLOW:5", "FAST:6" }, replies, 2000) == 3);
+    CHECK(replies[0] == Reply(4));
+    CHECK(replies[1] == Reply(5));
+    CHECK(replies[2] == Reply(6));
+
+    // Already on the wire before the next command
+    CHECK(channel.SendCommand("SLOW:7", 100) == Channel::TIMEOUT_REPLY);
+    std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_MS));
+    CHECK(channel.SendCommand("FAST:8") == Reply(8));
+    CHECK(channel.IsOpen());
+}
+
+// TAGS:ON answered with an error, as by AddOns without tag support: replies
+// are matched by order, and a late one is still dropped by count
+static void TestTagsRefused()
+{
+    LoopbackServer server(9803, Answer);
+    server.SetReplyDelay("SLOW:", DELAY_MS);
+
+    Channel channel;
+    CHECK(channel.Open("127.0.0.1", 9803, Codec::Text, false));
+    CHECK(channel.IsFramed());
+    CHECK(!channel.IsTagged());
+
+    std::vector<std::string_view> replies;
+    CHECK(Batch(channel, { "SLOW:1", "FAST:2", "FAST:3" }, replies, 2000) == 3);
+    for (int i = 0; i < 3; i++) {
+        CHECK(replies[i] == Reply(i + 1));
+    }
+
+    // In order, FAST:5 waits behind SLOW:4 and times out with it
+    CHECK(Batch(channel, { "SLOW:4", "FAST:5" }, replies, 100) == 0);
+    CHECK(replies[0] == Channel::TIMEOUT_REPLY && replies[1] == Channel::TIMEOUT_REPLY);
+    CHECK(channel.SendCommand("FAST:6", 2000) == Reply(6));
+    CHECK(channel.IsOpen());
+}
+
+int main()
+{
+    RUN_TEST(TestOutOfOrderBatch);
+    RUN_TEST(TestLateTaggedReplyDropped);
+    RUN_TEST(TestTagsRefused);
+    return TestResult();
+}
@@ -0,0 +1,66 @@
+// TestHarness.h - Minimal checks for the bridge core tests
+// Copyright (c) 2025
+//
+// Every test is a small executable run by CTest (see tests/CMakeLists.txt).
+// CHECK reports a failed condition and carries on, so one run lists every
+// failure; main() returns TestResult(), which is non-zero after any.
+// The AddOn is replaced by in-process stand-ins (LoopbackServer,
+// SharedMemoryLink::Create), so no NinjaTrader is needed.
+
+#pragma once
+
+#ifndef TESTHARNESS_H
+#define TESTHARNESS_H
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+inline int& TestFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            TestFailures()++;                                                         \
+        }                                                                             \
+    } while (0)
+
+// Run one test function and name it in the output
+#define RUN_TEST(test)                                \
+    do {                                              \
+        std::printf("[ RUN  ] %s\n", #test);          \
+        int before = TestFailures();                  \
+        test();                                       \
+        std::printf("[ %s ] %s\n", TestFailures() == before ? " OK " : "FAIL", #test); \
+    } while (0)
+
+inline int TestResult()
+{
+    if (TestFailures() > 0) {
+        std::printf("%d check(s) failed\n", TestFailures());
+        return 1;
+    }
+    return 0;
+}
+
+// Poll 'condition' until it holds or 'timeoutMs' passes - for state that a
+// background thread updates
+template <typename Condition>
+bool WaitFor(Condition condition, int timeoutMs = 2000)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+#endif // TESTHARNESS_H
@@ -0,0 +1,220 @@
+// TickRecorderTest.cpp - T1 files written by the tick recorder
+// Copyright (c) 2025
+//
+// Records into a scratch folder and reads the files back as Zorro would:
+// packed 12-byte T1 ticks, newest first, ask positive and bid negative,
+// one file per asset and UTC day. Covers a session across midnight with
+// more ticks than INITIAL_FILE_TICKS (the mapping grows), appending to a
+// file finalized earlier the same day, and the repair of a file a crash
+// left unfinalized - oldest first with a zero-filled tail.
+
+#include "TickRecorder.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const char SYMBOL[] = "EUR/USD";          // Stored as EURUSD_{day}.t1
+static const DATE NEW_YEAR = 46023.0;            // 2026-01-01 00:00 UTC
+static const double SECONDS_PER_DAY = 86400.0;
+
+static DATE At(double seconds) { return NEW_YEAR + seconds / SECONDS_PER_DAY; }
+
+// Empty scratch folder for one test
+static std::string Folder(const char* name)
+{
+    fs::path path = fs::temp_directory_path() / "TickRecorderTest" / name;
+    fs::remove_all(path);
+    fs::create_directories(path.parent_path());
+    return path.string();
+}
+
+static std::string FilePath(const std::string& folder, int day)
+{
+    return folder + "/EURUSD_" + std::to_string(day) + ".t1";
+}
+
+static std::vector<T1> ReadTicks(const std::string& path)
+{
+    std::vector<T1> ticks;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return ticks;
+    }
+    T1 tick;
+    while (fread(&tick, sizeof(T1), 1, file) == 1) {
+        ticks.push_back(tick);
+    }
+    fclose(file);
+    return ticks;
+}
+
+static void WriteTicks(const std::string& path, const std::vector<T1>& ticks)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file) {
+        fwrite(ticks.data(), sizeof(T1), ticks.size(), file);
+        fclose(file);
+    }
+}
+
+// Newest first, every tick inside [from, to), and ask/bid pairs: each
+// update wrote its ask (> 0) and its bid (< 0) with the same time
+static bool ValidFile(const std::vector<T1>& ticks, DATE from, DATE to)
+{
+    if (ticks.size() % 2 != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < ticks.size(); i++) {
+        if (ticks[i].time < from || ticks[i].time >= to) return false;
+        if (i > 0 && ticks[i].time > ticks[i - 1].time) return false;
+    }
+    for (size_t i = 0; i < ticks.size(); i += 2) {
+        // Reversed: the bid of an update comes before its ask
+        const T1& bid = ticks[i];
+        const T1& ask = ticks[i + 1];
+        if (bid.time != ask.time || bid.fVal >= 0 || ask.fVal <= 0 || ask.fVal <= -bid.fVal) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Update 'i' of a test series: both sides change every time
+static void RecordUpdate(TickRecorder& recorder, DATE time, int i)
+{
+    double ask = 1.1000 + (i % 1000) * 0.0001 + 0.0001;
+    recorder.Record(SYMBOL, time, ask - 0.0001, ask);
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+// 60000 updates, 20 ms apart, from 100 s before midnight: 10000 ticks on
+// New Year's Eve and 110000 on New Year's Day, past INITIAL_FILE_TICKS
+static void TestDayBoundaryAndGrowth()
+{
+    static_assert(sizeof(T1) == 12, "packed T1");
+    const int updates = 60000;
+    const int beforeMidnight = 5000;
+    CHECK(updates < (int)TickRecorder::QUEUE_CAPACITY);   // Nothing dropped, however slow the writer
+    CHECK(2 * (updates - beforeMidnight) > (int)TickRecorder::INITIAL_FILE_TICKS);
+
+    std::string folder = Folder("boundary");
+    TickRecorder recorder;
+    CHECK(recorder.Start(folder.c_str()));
+    CHECK(recorder.IsRunning());
+    for (int i = 0; i < updates; i++) {
+        RecordUpdate(recorder, At((i - beforeMidnight) * 0.02), i);
+    }
+    recorder.Stop();
+    CHECK(!recorder.IsRunning());
+    CHECK(recorder.Dropped() == 0);
+
+    std::string eve = FilePath(folder, 20251231), day = FilePath(folder, 20260101);
+    CHECK(fs::file_size(eve) == 2 * beforeMidnight * sizeof(T1));
+    CHECK(fs::file_size(day) == 2 * (size_t)(updates - beforeMidnight) * sizeof(T1));
+
+    std::vector<T1> ticks = ReadTicks(eve);
+    CHECK(ValidFile(ticks, NEW_YEAR - 1, NEW_YEAR));
+    CHECK(ticks.back().time == At(-beforeMidnight * 0.02));   // Oldest last
+
+    ticks = ReadTicks(day);
+    CHECK(ValidFile(ticks, NEW_YEAR, NEW_YEAR + 1));
+    CHECK(ticks.front().time == At((updates - 1 - beforeMidnight) * 0.02));
+    CHECK(ticks.back().time == NEW_YEAR);
+
+    // Unchanged sides and sides <= 0 are not recorded
+    CHECK(recorder.Start(folder.c_str()));
+    recorder.Record(SYMBOL, At(3600), 1.2, 1.3);
+    recorder.Record(SYMBOL, At(3601), 1.2, 1.3);
+    recorder.Record(SYMBOL, At(3602), 0, 1.4);
+    recorder.Stop();
+    ticks = ReadTicks(day);
+    CHECK(ticks.size() == 2 * (size_t)(updates - beforeMidnight) + 3);
+    CHECK(ticks[0].time == At(3602) && ticks[0].fVal == 1.4f);
+    CHECK(ticks[1].fVal == -1.2f && ticks[2].fVal == 1.3f);
+}
+
+// A file finalized by an earlier session of the same day is continued:
+// the old ticks keep their place behind the new ones
+static void TestResumeFinalized()
+{
+    std::string folder = Folder("resume");
+    TickRecorder recorder;
+    CHECK(recorder.Start(folder.c_str()));
+    for (int i = 0; i < 100; i++) {
+        RecordUpdate(recorder, At(36000 + i), i);
+    }
+    recorder.Stop();
+
+    std::string path = FilePath(folder, 20260101);
+    std::vector<T1> first = ReadTicks(path);
+    CHECK(first.size() == 200);
+    CHECK(ValidFile(first, NEW_YEAR, NEW_YEAR + 1));
+
+    CHECK(recorder.Start(folder.c_str()));
+    for (int i = 100; i < 250; i++) {
+        RecordUpdate(recorder, At(36000 + i), i);
+    }
+    recorder.Stop();
+
+    std::vector<T1> ticks = ReadTicks(path);
+    CHECK(ticks.size() == 500);
+    CHECK(ValidFile(ticks, NEW_YEAR, NEW_YEAR + 1));
+    CHECK(ticks.front().time == At(36249));
+    CHECK(std::equal(first.begin(), first.end(), ticks.end() - first.size(),
+                     [](const T1& a, const T1& b) { return a.time == b.time && a.fVal == b.fVal; }));
+}
+
+// A crash leaves the file at its mapped size: oldest first, then zeros.
+// Reopened, the zero tail is cut and recording continues in order.
+static void TestCrashRepair()
+{
+    std::string folder = Folder("crash");
+    fs::create_directories(folder);
+    std::string path = FilePath(folder, 20260101);
+
+    std::vector<T1> crashed(4096, T1{ 0, 0 });
+    for (int i = 0; i < 300; i++) {
+        crashed[2 * i] = { At(7200 + i), 1.3f + i * 0.0001f };
+        crashed[2 * i + 1] = { At(7200 + i), -(1.3f + i * 0.0001f - 0.0001f) };
+    }
+    WriteTicks(path, crashed);
+
+    TickRecorder recorder;
+    CHECK(recorder.Start(folder.c_str()));
+    for (int i = 0; i < 50; i++) {
+        RecordUpdate(recorder, At(7500 + i), i);
+    }
+    recorder.Stop();
+
+    std::vector<T1> ticks = ReadTicks(path);
+    CHECK(ticks.size() == 700);
+    CHECK(ValidFile(ticks, NEW_YEAR, NEW_YEAR + 1));
+    CHECK(ticks.front().time == At(7549));
+    CHECK(ticks.back().time == At(7200) && ticks.back().fVal == 1.3f);
+
+    // A quote older than the repaired ticks is stamped at the last one
+    CHECK(recorder.Start(folder.c_str()));
+    recorder.Record(SYMBOL, At(7000), 2.0, 2.1);
+    recorder.Stop();
+    ticks = ReadTicks(path);
+    CHECK(ticks.size() == 702);
+    CHECK(ticks[0].time == At(7549) && ticks[0].fVal == -2.0f);
+}
+
+int main()
+{
+    RUN_TEST(TestDayBoundaryAndGrowth);
+    RUN_TEST(TestResumeFinalized);
+    RUN_TEST(TestCrashRepair);
+    fs::remove_all(fs::temp_directory_path() / "TickRecorderTest");
+    return TestResult();
+}
@@ -0,0 +1,130 @@
+// TrafficIsolationTest.cpp - Order latency while a history download runs
+// Copyright (c) 2025
+//
+// One thread keeps a large GETHISTORY in flight - the stand-in AddOn holds
+// each reply back, like NinjaTrader loading bars, then sends ~500 KB -
+// while the test thread times PLACEORDER round trips. With the order
+// connection they must stay as fast as when idle; on the shared data
+// connection of older bridges each order waited out the history reply.
+
+#include "TcpBridge.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Bridge = BasicTcpBridge<LoopbackTransport, TextCodec>;
+using Clock = std::chrono::steady_clock;
+
+static const int HISTORY_DELAY_MS = 200;
+static const int HISTORY_BARS = 10000;
+
+static const std::string& HistoryReply()
+{
+    static const std::string reply = [] {
+        std::string text = "HISTORY:" + std::to_string(HISTORY_BARS);
+        char bar[96];
+        for (int i = 0; i < HISTORY_BARS; i++) {
+            double open = 5000.0 + (i % 400) * 0.25;
+            snprintf(bar, sizeof(bar), "|%.10f,%.2f,%.2f,%.2f,%.2f,%d", 46000.0 + i / 1440.0,
+                     open, open + 1.5, open - 0.75, open + 0.5, 100 + i % 900);
+            text += bar;
+        }
+        return text;
+    }();
+    return reply;
+}
+
+// Stand-in AddOn: orders and history
+static std::string Answer(std::string_view request)
+{
+    if (request == "PING") return "PONG";
+    if (request.compare(0, 11, "PLACEORDER:") == 0) return "ORDERID:1234";
+    if (request.compare(0, 11, "GETHISTORY:") == 0) return HistoryReply();
+    return "ERROR:Unknown command";
+}
+
+struct Latency {
+    double median;
+    double worst;
+};
+
+// Time 'orders' PLACEORDER round trips, in milliseconds
+static Latency TimeOrders(Bridge& bridge, int orders, bool& ok)
+{
+    std::vector<double> times;
+    for (int i = 0; i < orders; i++) {
+        auto start = Clock::now();
+        std::string_view reply = bridge.SendCommand("PLACEORDER:BUY:MES 03-26:1:MARKET:0:0");
+        times.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        ok &= reply == "ORDERID:1234";
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    std::sort(times.begin(), times.end());
+    return { times[times.size() / 2], times.back() };
+}
+
+// Order latency idle and with history downloads running alongside. Each
+// channel serves one thread; the bridge routes the two verbs to different
+// channels, so the threads never share one.
+static void MeasureUnderLoad(Bridge& bridge, Latency& idle, Latency& loaded, int& downloads)
+{
+    bool ok = true;
+    idle = TimeOrders(bridge, 50, ok);
+
+    std::atomic<bool> done(false);
+    std::atomic<int> completed(0);
+    std::thread history([&] {
+        while (!done) {
+            std::string_view reply = bridge.SendCommand("GETHISTORY:MES 03-26:46000:46007:1:10000");
+            if (reply.size() == HistoryReply().size()) {
+                completed++;
+            }
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));   // First download in flight
+    loaded = TimeOrders(bridge, 100, ok);
+    done = true;
+    history.join();
+    downloads = completed;
+    CHECK(ok);
+}
+
+//=============================================================================
+// Tests
+//=============================================================================
+
+static void TestOrderConnection()
+{
+    LoopbackServer server(9301, Answer);
+    server.SetReplyDelay("GETHISTORY", HISTORY_DELAY_MS);
+    server.SetSegmentation(64 * 1024, 5);
+
+    Bridge bridge;
+    CHECK(bridge.Connect("127.0.0.1", 9301));
+    CHECK(bridge.HasChannel(Bridge::TrafficClass::Orders));
+    CHECK(bridge.HasChannel(Bridge::TrafficClass::History));
+
+    Latency idle, loaded;
+    int downloads = 0;
+    MeasureUnderLoad(bridge, idle, loaded, downloads);
+    std::printf("  idle: median %.3f ms, worst %.3f ms\n", idle.median, idle.worst);
+    std::printf("  during %d downloads: median %.3f ms, worst %.3f ms\n", downloads, loaded.median, loaded.worst);
+
+    CHECK(downloads >= 1);
+    CHECK(loaded.worst < HISTORY_DELAY_MS / 4);     // Never waited for a history reply
+    CHECK(loaded.median < idle.median + 5);
+    bridge.Disconnect();
+}
+
+int main()
+{
+    RUN_TEST(TestOrderConnection);
+    return TestResult();
+}